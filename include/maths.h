@@ -4,13 +4,27 @@
 #include "maths/common.h"
 #include "maths/Angle.h"
 #include "maths/Vec2.h"
+#include "maths/Vec2xN.h"
 #include "maths/Mat3.h"
+#include "maths/Affine2.h"
 #include "maths/Interval.h"
 #include "maths/Transform.h"
+#include "maths/TransformHierarchy.h"
+#include "maths/TaskPool.h"
 #include "maths/shapes/Shape.h"
 #include "maths/shapes/OverlapHelper.h"
+#include "maths/shapes/ParallelNarrowphase.h"
 #include "maths/shapes/GJK.h"
+#include "maths/shapes/TOIHelper.h"
+#include "maths/broadphase/AABBTree.h"
+#include "maths/broadphase/SweepAndPrune.h"
+#include "maths/broadphase/SpatialGrid.h"
+#include "maths/broadphase/StaticBVH.h"
+#include "maths/dynamics/ContactCache.h"
+#include "maths/dynamics/Islands.h"
+#include "maths/dynamics/ContactSolver.h"
 #include "maths/maths_funcs.h"
+#include "maths/trig_funcs.h"
 
 #if USE_SDL2 == 1
 #include "maths/debug_draw.h"
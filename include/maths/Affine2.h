@@ -0,0 +1,61 @@
+#ifndef AFFINE2_H
+#define AFFINE2_H
+
+#include "maths_config.h"
+#include "Vec2xN.h"
+
+namespace grynca {
+    // fw
+    class Angle;
+    class Mat3;
+
+    // 2D affine transform: 2x2 linear part + translation (6 floats instead of Mat3's 9)
+    //  - same convention as Mat3 (col-major, v' = L*v + t)
+    class Affine2 {
+        friend Vec2 operator*(const Affine2& a, const Vec2& v);
+        friend Dir2 operator*(const Affine2& a, const Dir2& v);      // linear part only (no translation)
+        friend Affine2 operator*(const Affine2& a1, const Affine2& a2);     // a2 applied first
+        friend bool operator==(const Affine2& a1, const Affine2& a2);
+        friend bool operator!=(const Affine2& a1, const Affine2& a2);
+        friend std::ostream& operator <<(std::ostream& os, const Affine2& a);
+    public:
+        Affine2();      // creates unit transform
+        Affine2(const Vec2& col0, const Vec2& col1, const Vec2& translation);
+        explicit Affine2(const Mat3& m);    // drops last row (all Mat3 transforms we create are affine)
+
+        // translate*rotate*scale(first)
+        static Affine2 createTransform(const Vec2& translation, const Angle& rotation, const Vec2& scale = {1, 1});
+        static Affine2 createTransform(const Vec2& translation, const Dir2& rot_dir, const Vec2& scale = {1, 1});
+        static Affine2 createTranslation(const Vec2& translation);
+        static Affine2 createRotation(const Angle& rotation);
+        static Affine2 createRotation(const Dir2& rot_dir);
+        static Affine2 createScale(const Vec2& scale);
+        // general inverse (2x2 closed form)
+        static Affine2 invert(const Affine2& a);
+        // inverse of rotation*scale transform (orthogonal columns, e.g. from createTransform()),
+        //  no determinant needed: L^-1 = diag(1/|col0|^2, 1/|col1|^2)*L^T
+        static Affine2 invertRotScale(const Affine2& a);
+
+        const Vec2& getCol(u32 col)const;       // 0, 1: linear part, 2: translation
+        const Vec2& getTranslation()const;
+        f32 calcDeterminant()const;
+        Mat3 calcMat3()const;
+
+        // pts_out can be same as pts (SIMD packets for bigger point sets)
+        void transformPoints(const Vec2* pts, u32 n, Vec2* pts_out)const;
+        // also calculates bound of transformed points in the same pass (n > 0)
+        void transformPoints(const Vec2* pts, u32 n, Vec2* pts_out, Vec2& min_out, Vec2& max_out)const;
+
+        Affine2& operator*=(const Affine2& a);
+    private:
+        // n >= F::Width, last packet may overlap previous one
+        template <typename F, bool CalcBound>
+        void transformPackets_(const Vec2* pts, u32 n, Vec2* pts_out, Vec2& min_out, Vec2& max_out)const;
+
+        Vec2 cols_[3];
+    };
+
+}
+
+#include "Affine2.inl"
+#endif //AFFINE2_H
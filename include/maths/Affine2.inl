@@ -0,0 +1,196 @@
+#include "Affine2.h"
+#include "Angle.h"
+#include "Mat3.h"
+#include <ostream>
+
+namespace grynca {
+
+    inline Affine2::Affine2()
+     : cols_{Vec2(1, 0), Vec2(0, 1), Vec2(0, 0)}
+    {}
+
+    inline Affine2::Affine2(const Vec2& col0, const Vec2& col1, const Vec2& translation)
+     : cols_{col0, col1, translation}
+    {}
+
+    inline Affine2::Affine2(const Mat3& m)
+     : cols_{Vec2(m.val(0, 0), m.val(0, 1)), Vec2(m.val(1, 0), m.val(1, 1)), Vec2(m.val(2, 0), m.val(2, 1))}
+    {}
+
+    inline Affine2 Affine2::createTransform(const Vec2& translation, const Angle& rotation, const Vec2& scale) {
+        // static
+        return createTransform(translation, rotation.getDir(), scale);
+    }
+
+    inline Affine2 Affine2::createTransform(const Vec2& translation, const Dir2& rot_dir, const Vec2& scale) {
+        // static
+        Vec2 sins = rot_dir.getY()*scale;
+        Vec2 coss = rot_dir.getX()*scale;
+        return {Vec2(coss.getX(), sins.getX()), Vec2(-sins.getY(), coss.getY()), translation};
+    }
+
+    inline Affine2 Affine2::createTranslation(const Vec2& translation) {
+        // static
+        return {Vec2(1, 0), Vec2(0, 1), translation};
+    }
+
+    inline Affine2 Affine2::createRotation(const Angle& rotation) {
+        // static
+        return createRotation(rotation.getDir());
+    }
+
+    inline Affine2 Affine2::createRotation(const Dir2& rot_dir) {
+        // static
+        return {rot_dir, rot_dir.perpR(), Vec2(0, 0)};
+    }
+
+    inline Affine2 Affine2::createScale(const Vec2& scale) {
+        // static
+        return {Vec2(scale.getX(), 0), Vec2(0, scale.getY()), Vec2(0, 0)};
+    }
+
+    inline Affine2 Affine2::invert(const Affine2& a) {
+        // static
+        const Vec2& c0 = a.cols_[0];
+        const Vec2& c1 = a.cols_[1];
+        f32 inv_det = 1.0f/a.calcDeterminant();
+        Affine2 rslt(Vec2(c1.getY(), -c0.getY())*inv_det, Vec2(-c1.getX(), c0.getX())*inv_det, Vec2(0, 0));
+        rslt.cols_[2] = -(rslt*Dir2(a.cols_[2]));
+        return rslt;
+    }
+
+    inline Affine2 Affine2::invertRotScale(const Affine2& a) {
+        // static
+        const Vec2& c0 = a.cols_[0];
+        const Vec2& c1 = a.cols_[1];
+        f32 s0 = 1.0f/c0.getSqrLen();
+        f32 s1 = 1.0f/c1.getSqrLen();
+        Affine2 rslt(Vec2(c0.getX()*s0, c1.getX()*s1), Vec2(c0.getY()*s0, c1.getY()*s1), Vec2(0, 0));
+        rslt.cols_[2] = -(rslt*Dir2(a.cols_[2]));
+        return rslt;
+    }
+
+    inline const Vec2& Affine2::getCol(u32 col)const {
+        ASSERT(col < 3);
+        return cols_[col];
+    }
+
+    inline const Vec2& Affine2::getTranslation()const {
+        return cols_[2];
+    }
+
+    inline f32 Affine2::calcDeterminant()const {
+        return cross(cols_[0], cols_[1]);
+    }
+
+    inline Mat3 Affine2::calcMat3()const {
+        return {cols_[0].getX(), cols_[0].getY(), 0,
+                cols_[1].getX(), cols_[1].getY(), 0,
+                cols_[2].getX(), cols_[2].getY(), 1};
+    }
+
+    inline void Affine2::transformPoints(const Vec2* pts, u32 n, Vec2* pts_out)const {
+#if MATHS_SIMD_SSE
+        if (n >= MATHS_SIMD_TRANSFORM_MIN_POINTS && n >= F32x4::Width) {
+            Vec2 unused_min, unused_max;
+            if (n >= F32xN::Width)
+                transformPackets_<F32xN, false>(pts, n, pts_out, unused_min, unused_max);
+            else
+                transformPackets_<F32x4, false>(pts, n, pts_out, unused_min, unused_max);
+            return;
+        }
+#endif
+        for (u32 i=0; i<n; ++i) {
+            pts_out[i] = (*this)*pts[i];
+        }
+    }
+
+    inline void Affine2::transformPoints(const Vec2* pts, u32 n, Vec2* pts_out, Vec2& min_out, Vec2& max_out)const {
+        ASSERT(n > 0);
+#if MATHS_SIMD_SSE
+        if (n >= MATHS_SIMD_TRANSFORM_MIN_POINTS && n >= F32x4::Width) {
+            if (n >= F32xN::Width)
+                transformPackets_<F32xN, true>(pts, n, pts_out, min_out, max_out);
+            else
+                transformPackets_<F32x4, true>(pts, n, pts_out, min_out, max_out);
+            return;
+        }
+#endif
+        pts_out[0] = (*this)*pts[0];
+        min_out = max_out = pts_out[0];
+        for (u32 i=1; i<n; ++i) {
+            pts_out[i] = (*this)*pts[i];
+            min_out.set(std::min(min_out.getX(), pts_out[i].getX()), std::min(min_out.getY(), pts_out[i].getY()));
+            max_out.set(std::max(max_out.getX(), pts_out[i].getX()), std::max(max_out.getY(), pts_out[i].getY()));
+        }
+    }
+
+    template <typename F, bool CalcBound>
+    inline void Affine2::transformPackets_(const Vec2* pts, u32 n, Vec2* pts_out, Vec2& min_out, Vec2& max_out)const {
+        static constexpr u32 W = F::Width;
+        ASSERT(n >= W);
+        F c0x(cols_[0].getX()), c0y(cols_[0].getY());
+        F c1x(cols_[1].getX()), c1y(cols_[1].getY());
+        F tx(cols_[2].getX()), ty(cols_[2].getY());
+        // same operation order as operator*(Affine2, Vec2)
+        auto transform_f = [&](const Vec2xN<F>& p) {
+            return Vec2xN<F>(c0x*p.getX() + c1x*p.getY() + tx, c0y*p.getX() + c1y*p.getY() + ty);
+        };
+
+        // last (overlapping) packet is loaded first so that it is not already transformed when pts_out == pts
+        Vec2xN<F> last = transform_f(Vec2xN<F>::load(pts+n-W));
+        Vec2xN<F> bmin = last, bmax = last;
+        for (u32 i=0; i+W<n; i+=W) {
+            Vec2xN<F> tp = transform_f(Vec2xN<F>::load(pts+i));
+            tp.store(pts_out+i);
+            if (CalcBound) {
+                bmin = min(bmin, tp);
+                bmax = max(bmax, tp);
+            }
+        }
+        last.store(pts_out+n-W);
+
+        if (CalcBound) {
+            min_out = bmin.get(0);
+            max_out = bmax.get(0);
+            for (u32 l=1; l<W; ++l) {
+                Vec2 lmin = bmin.get(l), lmax = bmax.get(l);
+                min_out.set(std::min(min_out.getX(), lmin.getX()), std::min(min_out.getY(), lmin.getY()));
+                max_out.set(std::max(max_out.getX(), lmax.getX()), std::max(max_out.getY(), lmax.getY()));
+            }
+        }
+    }
+
+    inline Affine2& Affine2::operator*=(const Affine2& a) {
+        *this = (*this)*a;
+        return *this;
+    }
+
+    inline Vec2 operator*(const Affine2& a, const Vec2& v) {
+        return {a.cols_[0].getX()*v.getX() + a.cols_[1].getX()*v.getY() + a.cols_[2].getX(),
+                a.cols_[0].getY()*v.getX() + a.cols_[1].getY()*v.getY() + a.cols_[2].getY()};
+    }
+
+    inline Dir2 operator*(const Affine2& a, const Dir2& v) {
+        return {a.cols_[0].getX()*v.getX() + a.cols_[1].getX()*v.getY(),
+                a.cols_[0].getY()*v.getX() + a.cols_[1].getY()*v.getY()};
+    }
+
+    inline Affine2 operator*(const Affine2& a1, const Affine2& a2) {
+        return {a1*Dir2(a2.cols_[0]), a1*Dir2(a2.cols_[1]), a1*a2.cols_[2]};
+    }
+
+    inline bool operator==(const Affine2& a1, const Affine2& a2) {
+        return a1.cols_[0] == a2.cols_[0] && a1.cols_[1] == a2.cols_[1] && a1.cols_[2] == a2.cols_[2];
+    }
+
+    inline bool operator!=(const Affine2& a1, const Affine2& a2) {
+        return !operator==(a1, a2);
+    }
+
+    inline std::ostream& operator <<(std::ostream& os, const Affine2& a) {
+        os << "[" << a.cols_[0].getX() << ", " << a.cols_[1].getX() << ", " << a.cols_[2].getX() << "]" << std::endl;
+        os << "[" << a.cols_[0].getY() << ", " << a.cols_[1].getY() << ", " << a.cols_[2].getY() << "]" << std::endl;
+        return os;
+    }
+}
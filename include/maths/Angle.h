@@ -50,6 +50,8 @@ namespace grynca {
 
         static Dir2 invertRotDir(const Dir2& rot_dir);
         static Dir2 combineRotations(const Dir2& rot_dir1, const Dir2& rot_dir2);
+        // pulls slightly non-unit rot. dir back to unit length (no sqrt), use after combining rotations
+        static Dir2 renormalizeRotDir(const Dir2& rot_dir);
 
         // normalize to -Pi..Pi
         Angle& normalize();
@@ -64,8 +66,6 @@ namespace grynca {
         operator f32()const;
 
     private:
-        f32 cos_from_sin_(f32 sinr, f32 x)const;
-
         f32 rads_;
     };
 
@@ -1,5 +1,6 @@
 #include "Angle.h"
 #include "Vec2.h"
+#include "trig_funcs.h"
 #include <cmath>
 #include <ostream>
 
@@ -41,19 +42,14 @@ namespace grynca {
     }
 
     inline f32 Angle::getSin()const {
-        return sinf(rads_);
+        return maths::calcSin(rads_);
     }
     inline f32 Angle::getCos()const {
-        return cosf(rads_);
+        return maths::calcCos(rads_);
     }
 
     inline void Angle::getSinCos(f32& sin_out, f32& cos_out)const {
-#ifdef _WIN32
-        sin_out = sinf(rads_);
-        cos_out = cos_from_sin_(sin_out, rads_);
-#else
-        sincosf(rads_, &sin_out, &cos_out);
-#endif
+        maths::calcSinCos(rads_, sin_out, cos_out);
     }
 
     inline Dir2 Angle::getDir()const {
@@ -82,6 +78,13 @@ namespace grynca {
         return {c1*c2 - s1*s2, s1*c2 + c1*s2};
     }
 
+    inline Dir2 Angle::renormalizeRotDir(const Dir2& rot_dir) {
+    // static
+        // one Newton step of 1/sqrt(x) at x = 1, error after step is ~ squared error before
+        f32 k = 1.5f - 0.5f*rot_dir.getSqrLen();
+        return {rot_dir.getX()*k, rot_dir.getY()*k};
+    }
+
     inline Angle& Angle::normalize() {
         f32 x1 = rads_ * (1.0f / Pi);
         int whole_Pis = (int)x1;
@@ -134,15 +137,6 @@ namespace grynca {
         return rads_;
     }
 
-    inline f32 Angle::cos_from_sin_(f32 sinr, f32 x)const {
-    //static
-        int q = abs((int)(x/Pi_2))%4;
-        if (q == 1 || q == 2)
-            return -sqrtf(1.0f - sinr*sinr);
-        else
-            return sqrtf(1.0f - sinr*sinr);
-    }
-
     inline std::ostream& operator<<(std::ostream& os, const Angle& a) {
         os << a.rads_;
         return os;
@@ -199,9 +193,4 @@ namespace grynca {
     inline f32 minAngleDiff(const Angle& a1, const Angle& a2) {
         return (a1-a2).normalize();
     }
-}
-
-#ifdef USE_FAST_SIN
-#   undef sinf
-#   undef cosf
-#endif
\ No newline at end of file
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef FIXEDVECTOR_H
+#define FIXEDVECTOR_H
+
+#include "functions/defs.h"
+#include <algorithm>
+
+namespace grynca {
+
+    // vector with inline fixed capacity storage (subset of fast_vector interface)
+    //  - trivially copyable when T is
+    template <typename T, u32 Capacity>
+    class FixedVector {
+    public:
+        FixedVector() : size_(0) {}
+        FixedVector(u32 size) : size_(0) { resize(size); }
+
+        u32 size()const { return size_; }
+        static constexpr u32 capacity() { return Capacity; }
+        bool empty()const { return size_ == 0; }
+
+        void resize(u32 size) {
+            ASSERT(size <= Capacity);
+            for (u32 i=size_; i<size; ++i) {
+                data_[i] = T();
+            }
+            size_ = size;
+        }
+        void clear() { size_ = 0; }
+        void push_back(const T& t) {
+            ASSERT(size_ < Capacity);
+            data_[size_++] = t;
+        }
+        void pop_back() { --size_; }
+
+        T* insert(T* pos) { return insert(pos, 1, T()); }
+        T* insert(T* pos, const T& t) { return insert(pos, 1, t); }
+        T* insert(T* pos, u32 count, const T& t) {
+            ASSERT(size_+count <= Capacity);
+            std::copy_backward(pos, end(), end()+count);
+            std::fill(pos, pos+count, t);
+            size_ += count;
+            return pos;
+        }
+        template <typename It>
+        T* insert(T* pos, It first, It last) {
+            u32 count = u32(last-first);
+            ASSERT(size_+count <= Capacity);
+            std::copy_backward(pos, end(), end()+count);
+            std::copy(first, last, pos);
+            size_ += count;
+            return pos;
+        }
+        T* erase(T* pos) { return erase(pos, pos+1); }
+        T* erase(T* first, T* last) {
+            std::copy(last, end(), first);
+            size_ -= u32(last-first);
+            return first;
+        }
+
+        T* begin() { return data_; }
+        const T* begin()const { return data_; }
+        T* end() { return data_+size_; }
+        const T* end()const { return data_+size_; }
+        T& back() { return data_[size_-1]; }
+        const T& back()const { return data_[size_-1]; }
+        T& operator[](u32 id) { return data_[id]; }
+        const T& operator[](u32 id)const { return data_[id]; }
+    private:
+        T data_[Capacity];
+        u32 size_;
+    };
+
+}
+
+#endif //FIXEDVECTOR_H
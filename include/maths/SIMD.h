@@ -0,0 +1,158 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include "functions/defs.h"
+
+// SSE is used on x86 (not for emscripten), AVX when compiled with it (e.g. -mavx)
+// define MATHS_NO_SIMD to force scalar fallback
+#if !defined(MATHS_NO_SIMD) && !defined(__EMSCRIPTEN__) && (defined(__SSE2__) || defined(_M_X64))
+#   define MATHS_SIMD_SSE 1
+#   include <emmintrin.h>
+#else
+#   define MATHS_SIMD_SSE 0
+#endif
+
+#if MATHS_SIMD_SSE && defined(__AVX__)
+#   define MATHS_SIMD_AVX 1
+#   include <immintrin.h>
+#else
+#   define MATHS_SIMD_AVX 0
+#endif
+
+namespace grynca {
+
+    // Packet of 4 floats (SSE or scalar fallback)
+    //  - comparisons return masks (all bits set in true lanes) for select(), getMask(), &, |
+    class F32x4 {
+    public:
+        static constexpr u32 Width = 4;
+
+        F32x4() {}
+        F32x4(f32 v);       // broadcast
+        F32x4(f32 v0, f32 v1, f32 v2, f32 v3);
+
+        static F32x4 load(const f32* src);      // unaligned
+        // loads 4 interleaved pairs (x0, y0, x1, y1, ...)
+        static void loadInterleaved(const f32* src, F32x4& x_out, F32x4& y_out);
+        static void storeInterleaved(const F32x4& x, const F32x4& y, f32* dst);
+        void store(f32* dst)const;
+        f32 get(u32 lane)const;
+
+        F32x4& operator+=(const F32x4& v);
+        F32x4& operator-=(const F32x4& v);
+        F32x4& operator*=(const F32x4& v);
+        F32x4& operator/=(const F32x4& v);
+        F32x4 operator-()const;
+
+        friend F32x4 operator+(const F32x4& a, const F32x4& b);
+        friend F32x4 operator-(const F32x4& a, const F32x4& b);
+        friend F32x4 operator*(const F32x4& a, const F32x4& b);
+        friend F32x4 operator/(const F32x4& a, const F32x4& b);
+        friend F32x4 operator<(const F32x4& a, const F32x4& b);
+        friend F32x4 operator<=(const F32x4& a, const F32x4& b);
+        friend F32x4 operator>(const F32x4& a, const F32x4& b);
+        friend F32x4 operator>=(const F32x4& a, const F32x4& b);
+        friend F32x4 operator==(const F32x4& a, const F32x4& b);
+        friend F32x4 operator&(const F32x4& a, const F32x4& b);
+        friend F32x4 operator|(const F32x4& a, const F32x4& b);
+
+        // hidden friends (found only by ADL, must not hide scalar ::sqrt etc. in grynca namespace)
+        friend F32x4 min(const F32x4& a, const F32x4& b) { return min_(a, b); }
+        friend F32x4 max(const F32x4& a, const F32x4& b) { return max_(a, b); }
+        friend F32x4 sqrt(const F32x4& a) { return sqrt_(a); }
+        friend F32x4 abs(const F32x4& a) { return abs_(a); }
+        friend F32x4 round(const F32x4& a) { return round_(a); }      // to nearest even, |a| < 2^31
+        // lanes from t where mask is set, from f elsewhere
+        friend F32x4 select(const F32x4& mask, const F32x4& t, const F32x4& f);
+        friend u32 getMask(const F32x4& mask);     // bit per lane
+    private:
+        static F32x4 min_(const F32x4& a, const F32x4& b);
+        static F32x4 max_(const F32x4& a, const F32x4& b);
+        static F32x4 sqrt_(const F32x4& a);
+        static F32x4 abs_(const F32x4& a);
+        static F32x4 round_(const F32x4& a);
+
+#if MATHS_SIMD_SSE
+        F32x4(__m128 v) : v_(v) {}
+
+        __m128 v_;
+#else
+        static f32 maskFromBool_(bool b);
+        static u32 bits_(f32 v);
+        static f32 fromBits_(u32 b);
+        template <typename Func>
+        static F32x4 combine_(const F32x4& a, const F32x4& b, const Func& f);
+
+        f32 v_[4];
+#endif
+    };
+
+    // Packet of 8 floats (AVX or pair of F32x4)
+    class F32x8 {
+    public:
+        static constexpr u32 Width = 8;
+
+        F32x8() {}
+        F32x8(f32 v);       // broadcast
+        F32x8(const F32x4& lo, const F32x4& hi);
+
+        static F32x8 load(const f32* src);      // unaligned
+        // loads 8 interleaved pairs (x0, y0, x1, y1, ...)
+        static void loadInterleaved(const f32* src, F32x8& x_out, F32x8& y_out);
+        static void storeInterleaved(const F32x8& x, const F32x8& y, f32* dst);
+        void store(f32* dst)const;
+        f32 get(u32 lane)const;
+
+        F32x8& operator+=(const F32x8& v);
+        F32x8& operator-=(const F32x8& v);
+        F32x8& operator*=(const F32x8& v);
+        F32x8& operator/=(const F32x8& v);
+        F32x8 operator-()const;
+
+        friend F32x8 operator+(const F32x8& a, const F32x8& b);
+        friend F32x8 operator-(const F32x8& a, const F32x8& b);
+        friend F32x8 operator*(const F32x8& a, const F32x8& b);
+        friend F32x8 operator/(const F32x8& a, const F32x8& b);
+        friend F32x8 operator<(const F32x8& a, const F32x8& b);
+        friend F32x8 operator<=(const F32x8& a, const F32x8& b);
+        friend F32x8 operator>(const F32x8& a, const F32x8& b);
+        friend F32x8 operator>=(const F32x8& a, const F32x8& b);
+        friend F32x8 operator==(const F32x8& a, const F32x8& b);
+        friend F32x8 operator&(const F32x8& a, const F32x8& b);
+        friend F32x8 operator|(const F32x8& a, const F32x8& b);
+
+        // hidden friends (found only by ADL, must not hide scalar ::sqrt etc. in grynca namespace)
+        friend F32x8 min(const F32x8& a, const F32x8& b) { return min_(a, b); }
+        friend F32x8 max(const F32x8& a, const F32x8& b) { return max_(a, b); }
+        friend F32x8 sqrt(const F32x8& a) { return sqrt_(a); }
+        friend F32x8 abs(const F32x8& a) { return abs_(a); }
+        friend F32x8 round(const F32x8& a) { return round_(a); }      // to nearest even, |a| < 2^31
+        friend F32x8 select(const F32x8& mask, const F32x8& t, const F32x8& f);
+        friend u32 getMask(const F32x8& mask);     // bit per lane
+    private:
+        static F32x8 min_(const F32x8& a, const F32x8& b);
+        static F32x8 max_(const F32x8& a, const F32x8& b);
+        static F32x8 sqrt_(const F32x8& a);
+        static F32x8 abs_(const F32x8& a);
+        static F32x8 round_(const F32x8& a);
+
+#if MATHS_SIMD_AVX
+        F32x8(__m256 v) : v_(v) {}
+
+        __m256 v_;
+#else
+        F32x4 lo_, hi_;
+#endif
+    };
+
+
+    // widest packet available
+#if MATHS_SIMD_AVX
+    typedef F32x8 F32xN;
+#else
+    typedef F32x4 F32xN;
+#endif
+}
+
+#include "SIMD.inl"
+#endif //SIMD_H
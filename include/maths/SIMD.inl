@@ -0,0 +1,397 @@
+#include "SIMD.h"
+#include <cmath>
+#include <cstring>
+
+namespace grynca {
+
+#if MATHS_SIMD_SSE
+    inline F32x4::F32x4(f32 v)
+     : v_(_mm_set1_ps(v))
+    {}
+
+    inline F32x4::F32x4(f32 v0, f32 v1, f32 v2, f32 v3)
+     : v_(_mm_setr_ps(v0, v1, v2, v3))
+    {}
+
+    inline F32x4 F32x4::load(const f32* src) {
+        // static
+        return _mm_loadu_ps(src);
+    }
+
+    inline void F32x4::loadInterleaved(const f32* src, F32x4& x_out, F32x4& y_out) {
+        // static
+        __m128 a = _mm_loadu_ps(src);
+        __m128 b = _mm_loadu_ps(src+4);
+        x_out.v_ = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        y_out.v_ = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+
+    inline void F32x4::storeInterleaved(const F32x4& x, const F32x4& y, f32* dst) {
+        // static
+        _mm_storeu_ps(dst, _mm_unpacklo_ps(x.v_, y.v_));
+        _mm_storeu_ps(dst+4, _mm_unpackhi_ps(x.v_, y.v_));
+    }
+
+    inline void F32x4::store(f32* dst)const {
+        _mm_storeu_ps(dst, v_);
+    }
+
+    inline F32x4 F32x4::operator-()const {
+        return _mm_xor_ps(v_, _mm_set1_ps(-0.0f));
+    }
+
+    inline F32x4 operator+(const F32x4& a, const F32x4& b) { return _mm_add_ps(a.v_, b.v_); }
+    inline F32x4 operator-(const F32x4& a, const F32x4& b) { return _mm_sub_ps(a.v_, b.v_); }
+    inline F32x4 operator*(const F32x4& a, const F32x4& b) { return _mm_mul_ps(a.v_, b.v_); }
+    inline F32x4 operator/(const F32x4& a, const F32x4& b) { return _mm_div_ps(a.v_, b.v_); }
+    inline F32x4 operator<(const F32x4& a, const F32x4& b) { return _mm_cmplt_ps(a.v_, b.v_); }
+    inline F32x4 operator<=(const F32x4& a, const F32x4& b) { return _mm_cmple_ps(a.v_, b.v_); }
+    inline F32x4 operator>(const F32x4& a, const F32x4& b) { return _mm_cmpgt_ps(a.v_, b.v_); }
+    inline F32x4 operator>=(const F32x4& a, const F32x4& b) { return _mm_cmpge_ps(a.v_, b.v_); }
+    inline F32x4 operator==(const F32x4& a, const F32x4& b) { return _mm_cmpeq_ps(a.v_, b.v_); }
+    inline F32x4 operator&(const F32x4& a, const F32x4& b) { return _mm_and_ps(a.v_, b.v_); }
+    inline F32x4 operator|(const F32x4& a, const F32x4& b) { return _mm_or_ps(a.v_, b.v_); }
+
+    inline F32x4 F32x4::min_(const F32x4& a, const F32x4& b) {
+        // static
+        return _mm_min_ps(a.v_, b.v_);
+    }
+
+    inline F32x4 F32x4::max_(const F32x4& a, const F32x4& b) {
+        // static
+        return _mm_max_ps(a.v_, b.v_);
+    }
+
+    inline F32x4 F32x4::sqrt_(const F32x4& a) {
+        // static
+        return _mm_sqrt_ps(a.v_);
+    }
+
+    inline F32x4 F32x4::abs_(const F32x4& a) {
+        // static
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v_);
+    }
+
+    inline F32x4 F32x4::round_(const F32x4& a) {
+        // static
+        return _mm_cvtepi32_ps(_mm_cvtps_epi32(a.v_));
+    }
+
+    inline F32x4 select(const F32x4& mask, const F32x4& t, const F32x4& f) {
+        return _mm_or_ps(_mm_and_ps(mask.v_, t.v_), _mm_andnot_ps(mask.v_, f.v_));
+    }
+
+    inline u32 getMask(const F32x4& mask) {
+        return u32(_mm_movemask_ps(mask.v_));
+    }
+#else
+    inline F32x4::F32x4(f32 v)
+     : v_{v, v, v, v}
+    {}
+
+    inline F32x4::F32x4(f32 v0, f32 v1, f32 v2, f32 v3)
+     : v_{v0, v1, v2, v3}
+    {}
+
+    inline F32x4 F32x4::load(const f32* src) {
+        // static
+        return {src[0], src[1], src[2], src[3]};
+    }
+
+    inline void F32x4::loadInterleaved(const f32* src, F32x4& x_out, F32x4& y_out) {
+        // static
+        for (u32 i=0; i<Width; ++i) {
+            x_out.v_[i] = src[i*2];
+            y_out.v_[i] = src[i*2+1];
+        }
+    }
+
+    inline void F32x4::storeInterleaved(const F32x4& x, const F32x4& y, f32* dst) {
+        // static
+        for (u32 i=0; i<Width; ++i) {
+            dst[i*2] = x.v_[i];
+            dst[i*2+1] = y.v_[i];
+        }
+    }
+
+    inline void F32x4::store(f32* dst)const {
+        memcpy(dst, v_, sizeof(v_));
+    }
+
+    inline F32x4 F32x4::operator-()const {
+        return {-v_[0], -v_[1], -v_[2], -v_[3]};
+    }
+
+    inline f32 F32x4::maskFromBool_(bool b) {
+        // static
+        return fromBits_(b?0xFFFFFFFFu:0u);
+    }
+
+    inline u32 F32x4::bits_(f32 v) {
+        // static
+        u32 b;
+        memcpy(&b, &v, sizeof(b));
+        return b;
+    }
+
+    inline f32 F32x4::fromBits_(u32 b) {
+        // static
+        f32 v;
+        memcpy(&v, &b, sizeof(v));
+        return v;
+    }
+
+    template <typename Func>
+    inline F32x4 F32x4::combine_(const F32x4& a, const F32x4& b, const Func& f) {
+        // static
+        return {f(a.v_[0], b.v_[0]), f(a.v_[1], b.v_[1]), f(a.v_[2], b.v_[2]), f(a.v_[3], b.v_[3])};
+    }
+
+    inline F32x4 operator+(const F32x4& a, const F32x4& b) { return F32x4::combine_(a, b, [](f32 x, f32 y) { return x+y; }); }
+    inline F32x4 operator-(const F32x4& a, const F32x4& b) { return F32x4::combine_(a, b, [](f32 x, f32 y) { return x-y; }); }
+    inline F32x4 operator*(const F32x4& a, const F32x4& b) { return F32x4::combine_(a, b, [](f32 x, f32 y) { return x*y; }); }
+    inline F32x4 operator/(const F32x4& a, const F32x4& b) { return F32x4::combine_(a, b, [](f32 x, f32 y) { return x/y; }); }
+    inline F32x4 operator<(const F32x4& a, const F32x4& b) { return F32x4::combine_(a, b, [](f32 x, f32 y) { return F32x4::maskFromBool_(x<y); }); }
+    inline F32x4 operator<=(const F32x4& a, const F32x4& b) { return F32x4::combine_(a, b, [](f32 x, f32 y) { return F32x4::maskFromBool_(x<=y); }); }
+    inline F32x4 operator>(const F32x4& a, const F32x4& b) { return F32x4::combine_(a, b, [](f32 x, f32 y) { return F32x4::maskFromBool_(x>y); }); }
+    inline F32x4 operator>=(const F32x4& a, const F32x4& b) { return F32x4::combine_(a, b, [](f32 x, f32 y) { return F32x4::maskFromBool_(x>=y); }); }
+    inline F32x4 operator==(const F32x4& a, const F32x4& b) { return F32x4::combine_(a, b, [](f32 x, f32 y) { return F32x4::maskFromBool_(x==y); }); }
+    inline F32x4 operator&(const F32x4& a, const F32x4& b) { return F32x4::combine_(a, b, [](f32 x, f32 y) { return F32x4::fromBits_(F32x4::bits_(x)&F32x4::bits_(y)); }); }
+    inline F32x4 operator|(const F32x4& a, const F32x4& b) { return F32x4::combine_(a, b, [](f32 x, f32 y) { return F32x4::fromBits_(F32x4::bits_(x)|F32x4::bits_(y)); }); }
+
+    inline F32x4 F32x4::min_(const F32x4& a, const F32x4& b) {
+        // static
+        return F32x4::combine_(a, b, [](f32 x, f32 y) { return (y<x)?y:x; });
+    }
+
+    inline F32x4 F32x4::max_(const F32x4& a, const F32x4& b) {
+        // static
+        return F32x4::combine_(a, b, [](f32 x, f32 y) { return (x<y)?y:x; });
+    }
+
+    inline F32x4 F32x4::sqrt_(const F32x4& a) {
+        // static
+        return F32x4::combine_(a, a, [](f32 x, f32) { return sqrtf(x); });
+    }
+
+    inline F32x4 F32x4::abs_(const F32x4& a) {
+        // static
+        return F32x4::combine_(a, a, [](f32 x, f32) { return fabsf(x); });
+    }
+
+    inline F32x4 F32x4::round_(const F32x4& a) {
+        // static
+        return F32x4::combine_(a, a, [](f32 x, f32) { return rintf(x); });
+    }
+
+    inline F32x4 select(const F32x4& mask, const F32x4& t, const F32x4& f) {
+        F32x4 rslt;
+        for (u32 i=0; i<F32x4::Width; ++i) {
+            rslt.v_[i] = F32x4::bits_(mask.v_[i])?t.v_[i]:f.v_[i];
+        }
+        return rslt;
+    }
+
+    inline u32 getMask(const F32x4& mask) {
+        u32 rslt = 0;
+        for (u32 i=0; i<F32x4::Width; ++i) {
+            rslt |= (F32x4::bits_(mask.v_[i])>>31)<<i;
+        }
+        return rslt;
+    }
+#endif
+
+    inline f32 F32x4::get(u32 lane)const {
+        ASSERT(lane < Width);
+        f32 vals[Width];
+        store(vals);
+        return vals[lane];
+    }
+
+    inline F32x4& F32x4::operator+=(const F32x4& v) { return *this = *this + v; }
+    inline F32x4& F32x4::operator-=(const F32x4& v) { return *this = *this - v; }
+    inline F32x4& F32x4::operator*=(const F32x4& v) { return *this = *this * v; }
+    inline F32x4& F32x4::operator/=(const F32x4& v) { return *this = *this / v; }
+
+#if MATHS_SIMD_AVX
+    inline F32x8::F32x8(f32 v)
+     : v_(_mm256_set1_ps(v))
+    {}
+
+    inline F32x8::F32x8(const F32x4& lo, const F32x4& hi) {
+        f32 vals[Width];
+        lo.store(vals);
+        hi.store(vals+4);
+        v_ = _mm256_loadu_ps(vals);
+    }
+
+    inline F32x8 F32x8::load(const f32* src) {
+        // static
+        return _mm256_loadu_ps(src);
+    }
+
+    inline void F32x8::loadInterleaved(const f32* src, F32x8& x_out, F32x8& y_out) {
+        // static
+        // a = x0 y0 x1 y1 | x2 y2 x3 y3, b = x4 y4 x5 y5 | x6 y6 x7 y7
+        __m256 a = _mm256_loadu_ps(src);
+        __m256 b = _mm256_loadu_ps(src+8);
+        // lo = a.lo | b.lo, hi = a.hi | b.hi
+        __m256 lo = _mm256_permute2f128_ps(a, b, 0x20);
+        __m256 hi = _mm256_permute2f128_ps(a, b, 0x31);
+        x_out.v_ = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+        y_out.v_ = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+
+    inline void F32x8::storeInterleaved(const F32x8& x, const F32x8& y, f32* dst) {
+        // static
+        __m256 lo = _mm256_unpacklo_ps(x.v_, y.v_);     // x0 y0 x1 y1 | x4 y4 x5 y5
+        __m256 hi = _mm256_unpackhi_ps(x.v_, y.v_);     // x2 y2 x3 y3 | x6 y6 x7 y7
+        _mm256_storeu_ps(dst, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(dst+8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+
+    inline void F32x8::store(f32* dst)const {
+        _mm256_storeu_ps(dst, v_);
+    }
+
+    inline F32x8 F32x8::operator-()const {
+        return _mm256_xor_ps(v_, _mm256_set1_ps(-0.0f));
+    }
+
+    inline F32x8 operator+(const F32x8& a, const F32x8& b) { return _mm256_add_ps(a.v_, b.v_); }
+    inline F32x8 operator-(const F32x8& a, const F32x8& b) { return _mm256_sub_ps(a.v_, b.v_); }
+    inline F32x8 operator*(const F32x8& a, const F32x8& b) { return _mm256_mul_ps(a.v_, b.v_); }
+    inline F32x8 operator/(const F32x8& a, const F32x8& b) { return _mm256_div_ps(a.v_, b.v_); }
+    inline F32x8 operator<(const F32x8& a, const F32x8& b) { return _mm256_cmp_ps(a.v_, b.v_, _CMP_LT_OQ); }
+    inline F32x8 operator<=(const F32x8& a, const F32x8& b) { return _mm256_cmp_ps(a.v_, b.v_, _CMP_LE_OQ); }
+    inline F32x8 operator>(const F32x8& a, const F32x8& b) { return _mm256_cmp_ps(a.v_, b.v_, _CMP_GT_OQ); }
+    inline F32x8 operator>=(const F32x8& a, const F32x8& b) { return _mm256_cmp_ps(a.v_, b.v_, _CMP_GE_OQ); }
+    inline F32x8 operator==(const F32x8& a, const F32x8& b) { return _mm256_cmp_ps(a.v_, b.v_, _CMP_EQ_OQ); }
+    inline F32x8 operator&(const F32x8& a, const F32x8& b) { return _mm256_and_ps(a.v_, b.v_); }
+    inline F32x8 operator|(const F32x8& a, const F32x8& b) { return _mm256_or_ps(a.v_, b.v_); }
+
+    inline F32x8 F32x8::min_(const F32x8& a, const F32x8& b) {
+        // static
+        return _mm256_min_ps(a.v_, b.v_);
+    }
+
+    inline F32x8 F32x8::max_(const F32x8& a, const F32x8& b) {
+        // static
+        return _mm256_max_ps(a.v_, b.v_);
+    }
+
+    inline F32x8 F32x8::sqrt_(const F32x8& a) {
+        // static
+        return _mm256_sqrt_ps(a.v_);
+    }
+
+    inline F32x8 F32x8::abs_(const F32x8& a) {
+        // static
+        return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v_);
+    }
+
+    inline F32x8 F32x8::round_(const F32x8& a) {
+        // static
+        return _mm256_round_ps(a.v_, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    }
+
+    inline F32x8 select(const F32x8& mask, const F32x8& t, const F32x8& f) {
+        return _mm256_blendv_ps(f.v_, t.v_, mask.v_);
+    }
+
+    inline u32 getMask(const F32x8& mask) {
+        return u32(_mm256_movemask_ps(mask.v_));
+    }
+#else
+    inline F32x8::F32x8(f32 v)
+     : lo_(v), hi_(v)
+    {}
+
+    inline F32x8::F32x8(const F32x4& lo, const F32x4& hi)
+     : lo_(lo), hi_(hi)
+    {}
+
+    inline F32x8 F32x8::load(const f32* src) {
+        // static
+        return {F32x4::load(src), F32x4::load(src+4)};
+    }
+
+    inline void F32x8::loadInterleaved(const f32* src, F32x8& x_out, F32x8& y_out) {
+        // static
+        F32x4::loadInterleaved(src, x_out.lo_, y_out.lo_);
+        F32x4::loadInterleaved(src+8, x_out.hi_, y_out.hi_);
+    }
+
+    inline void F32x8::storeInterleaved(const F32x8& x, const F32x8& y, f32* dst) {
+        // static
+        F32x4::storeInterleaved(x.lo_, y.lo_, dst);
+        F32x4::storeInterleaved(x.hi_, y.hi_, dst+8);
+    }
+
+    inline void F32x8::store(f32* dst)const {
+        lo_.store(dst);
+        hi_.store(dst+4);
+    }
+
+    inline F32x8 F32x8::operator-()const {
+        return {-lo_, -hi_};
+    }
+
+    inline F32x8 operator+(const F32x8& a, const F32x8& b) { return {a.lo_+b.lo_, a.hi_+b.hi_}; }
+    inline F32x8 operator-(const F32x8& a, const F32x8& b) { return {a.lo_-b.lo_, a.hi_-b.hi_}; }
+    inline F32x8 operator*(const F32x8& a, const F32x8& b) { return {a.lo_*b.lo_, a.hi_*b.hi_}; }
+    inline F32x8 operator/(const F32x8& a, const F32x8& b) { return {a.lo_/b.lo_, a.hi_/b.hi_}; }
+    inline F32x8 operator<(const F32x8& a, const F32x8& b) { return {a.lo_<b.lo_, a.hi_<b.hi_}; }
+    inline F32x8 operator<=(const F32x8& a, const F32x8& b) { return {a.lo_<=b.lo_, a.hi_<=b.hi_}; }
+    inline F32x8 operator>(const F32x8& a, const F32x8& b) { return {a.lo_>b.lo_, a.hi_>b.hi_}; }
+    inline F32x8 operator>=(const F32x8& a, const F32x8& b) { return {a.lo_>=b.lo_, a.hi_>=b.hi_}; }
+    inline F32x8 operator==(const F32x8& a, const F32x8& b) { return {a.lo_==b.lo_, a.hi_==b.hi_}; }
+    inline F32x8 operator&(const F32x8& a, const F32x8& b) { return {a.lo_&b.lo_, a.hi_&b.hi_}; }
+    inline F32x8 operator|(const F32x8& a, const F32x8& b) { return {a.lo_|b.lo_, a.hi_|b.hi_}; }
+
+    inline F32x8 F32x8::min_(const F32x8& a, const F32x8& b) {
+        // static
+        return {min(a.lo_, b.lo_), min(a.hi_, b.hi_)};
+    }
+
+    inline F32x8 F32x8::max_(const F32x8& a, const F32x8& b) {
+        // static
+        return {max(a.lo_, b.lo_), max(a.hi_, b.hi_)};
+    }
+
+    inline F32x8 F32x8::sqrt_(const F32x8& a) {
+        // static
+        return {sqrt(a.lo_), sqrt(a.hi_)};
+    }
+
+    inline F32x8 F32x8::abs_(const F32x8& a) {
+        // static
+        return {abs(a.lo_), abs(a.hi_)};
+    }
+
+    inline F32x8 F32x8::round_(const F32x8& a) {
+        // static
+        return {round(a.lo_), round(a.hi_)};
+    }
+
+    inline F32x8 select(const F32x8& mask, const F32x8& t, const F32x8& f) {
+        return {select(mask.lo_, t.lo_, f.lo_), select(mask.hi_, t.hi_, f.hi_)};
+    }
+
+    inline u32 getMask(const F32x8& mask) {
+        return getMask(mask.lo_) | (getMask(mask.hi_)<<4);
+    }
+#endif
+
+    inline f32 F32x8::get(u32 lane)const {
+        ASSERT(lane < Width);
+        f32 vals[Width];
+        store(vals);
+        return vals[lane];
+    }
+
+    inline F32x8& F32x8::operator+=(const F32x8& v) { return *this = *this + v; }
+    inline F32x8& F32x8::operator-=(const F32x8& v) { return *this = *this - v; }
+    inline F32x8& F32x8::operator*=(const F32x8& v) { return *this = *this * v; }
+    inline F32x8& F32x8::operator/=(const F32x8& v) { return *this = *this / v; }
+}
@@ -0,0 +1,68 @@
+#ifndef TASKPOOL_H
+#define TASKPOOL_H
+
+#include "functions/defs.h"
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+namespace grynca {
+
+    // fixed pool of worker threads for data parallel loops
+    //  - tasks are split to contiguous ranges per thread, thread that runs out of tasks steals
+    //    half of remaining range from other thread (ranges are lock-free)
+    //  - calling thread works too, parallelFor() returns when all tasks are done
+    class TaskPool {
+    public:
+        // threads count including calling thread, 0 for hardware concurrency
+        TaskPool(u32 threads_cnt = 0);
+        ~TaskPool();
+
+        TaskPool(const TaskPool&) = delete;
+        TaskPool& operator=(const TaskPool&) = delete;
+
+        u32 getThreadsCount()const;
+
+        // calls f(u32 task_id, u32 thread_id) for tasks [0, tasks_cnt), thread_id is < getThreadsCount()
+        // (must not be called from tasks)
+        template <typename Func>
+        void parallelFor(u32 tasks_cnt, const Func& f);
+    private:
+        typedef void (*JobF_)(const void* ctx, u32 task_id, u32 thread_id);
+
+        // begin in low, end in high 32 bits (both changed by single CAS)
+        struct Range_ {
+            std::atomic<u64> range;
+            u8 padding[64 - sizeof(std::atomic<u64>)];     // each on own cache line
+        };
+
+        template <typename Func>
+        static void callJob_(const void* ctx, u32 task_id, u32 thread_id);
+        static u64 pack_(u32 begin, u32 end);
+
+        void run_(u32 tasks_cnt, JobF_ job_f, const void* job_ctx);
+        void workerLoop_(u32 thread_id);
+        void runTasks_(u32 thread_id);
+        bool popTask_(u32 thread_id, u32& task_id_out);
+        // moves half of other thread's remaining range to thread_id, false when all ranges are empty
+        bool steal_(u32 thread_id);
+
+        std::vector<std::thread> workers_;
+        std::vector<Range_> ranges_;
+
+        std::mutex mutex_;
+        std::condition_variable start_cv_;
+        u32 generation_;
+        bool stop_;
+        std::atomic<u32> finished_workers_;
+        JobF_ job_f_;
+        const void* job_ctx_;
+    };
+
+}
+
+#include "TaskPool.inl"
+#endif //TASKPOOL_H
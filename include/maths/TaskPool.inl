@@ -0,0 +1,140 @@
+#include "TaskPool.h"
+
+namespace grynca {
+
+    inline TaskPool::TaskPool(u32 threads_cnt)
+     : ranges_(threads_cnt?threads_cnt:std::max(std::thread::hardware_concurrency(), 1u)),
+       generation_(0), stop_(false), finished_workers_(0), job_f_(NULL), job_ctx_(NULL)
+    {
+        for (u32 i=0; i<ranges_.size(); ++i) {
+            ranges_[i].range = pack_(0, 0);
+        }
+        // thread 0 is the calling thread
+        for (u32 i=1; i<ranges_.size(); ++i) {
+            workers_.emplace_back(&TaskPool::workerLoop_, this, i);
+        }
+    }
+
+    inline TaskPool::~TaskPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_cv_.notify_all();
+        for (u32 i=0; i<workers_.size(); ++i) {
+            workers_[i].join();
+        }
+    }
+
+    inline u32 TaskPool::getThreadsCount()const {
+        return ranges_.size();
+    }
+
+    template <typename Func>
+    inline void TaskPool::parallelFor(u32 tasks_cnt, const Func& f) {
+        if (!tasks_cnt)
+            return;
+        if (workers_.empty() || tasks_cnt == 1) {
+            for (u32 i=0; i<tasks_cnt; ++i) {
+                f(i, 0);
+            }
+            return;
+        }
+        run_(tasks_cnt, &callJob_<Func>, &f);
+    }
+
+    template <typename Func>
+    inline void TaskPool::callJob_(const void* ctx, u32 task_id, u32 thread_id) {
+        // static
+        (*(const Func*)ctx)(task_id, thread_id);
+    }
+
+    inline u64 TaskPool::pack_(u32 begin, u32 end) {
+        // static
+        return u64(begin) | (u64(end) << 32);
+    }
+
+    inline void TaskPool::run_(u32 tasks_cnt, JobF_ job_f, const void* job_ctx) {
+        u32 threads_cnt = getThreadsCount();
+        for (u32 i=0; i<threads_cnt; ++i) {
+            u32 begin = u32(u64(tasks_cnt)*i/threads_cnt);
+            u32 end = u32(u64(tasks_cnt)*(i+1)/threads_cnt);
+            ranges_[i].range.store(pack_(begin, end), std::memory_order_relaxed);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_f_ = job_f;
+            job_ctx_ = job_ctx;
+            finished_workers_.store(0, std::memory_order_relaxed);
+            ++generation_;
+        }
+        start_cv_.notify_all();
+
+        runTasks_(0);
+        // workers must leave the job before ranges are reused
+        while (finished_workers_.load(std::memory_order_acquire) != workers_.size()) {
+            std::this_thread::yield();
+        }
+    }
+
+    inline void TaskPool::workerLoop_(u32 thread_id) {
+        u32 seen_generation = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_cv_.wait(lock, [&]() { return stop_ || generation_ != seen_generation; });
+                if (stop_)
+                    return;
+                seen_generation = generation_;
+            }
+            runTasks_(thread_id);
+            finished_workers_.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    inline void TaskPool::runTasks_(u32 thread_id) {
+        for (;;) {
+            u32 task_id;
+            if (popTask_(thread_id, task_id)) {
+                job_f_(job_ctx_, task_id, thread_id);
+            }
+            else if (!steal_(thread_id)) {
+                return;
+            }
+        }
+    }
+
+    inline bool TaskPool::popTask_(u32 thread_id, u32& task_id_out) {
+        std::atomic<u64>& r = ranges_[thread_id].range;
+        u64 old = r.load(std::memory_order_relaxed);
+        for (;;) {
+            u32 begin = u32(old), end = u32(old >> 32);
+            if (begin >= end)
+                return false;
+            if (r.compare_exchange_weak(old, pack_(begin+1, end), std::memory_order_relaxed)) {
+                task_id_out = begin;
+                return true;
+            }
+        }
+    }
+
+    inline bool TaskPool::steal_(u32 thread_id) {
+        u32 threads_cnt = getThreadsCount();
+        for (u32 i=1; i<threads_cnt; ++i) {
+            std::atomic<u64>& victim = ranges_[(thread_id+i)%threads_cnt].range;
+            u64 old = victim.load(std::memory_order_relaxed);
+            for (;;) {
+                u32 begin = u32(old), end = u32(old >> 32);
+                if (begin >= end)
+                    break;
+                u32 mid = end - (end - begin + 1)/2;
+                if (victim.compare_exchange_weak(old, pack_(begin, mid), std::memory_order_relaxed)) {
+                    // own range is empty, so nobody else changes it
+                    ranges_[thread_id].range.store(pack_(mid, end), std::memory_order_relaxed);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+}
@@ -3,6 +3,7 @@
 
 #include "Vec2.h"
 #include "Mat3.h"
+#include "Affine2.h"
 #include "Angle.h"
 #include "glm/mat2x2.hpp"
 
@@ -11,6 +12,7 @@ namespace grynca {
     class Transform {
         friend Transform operator*(const Transform& t1, const Transform& t2);
         friend Transform operator/(const Transform& t1, const Transform& t2);
+        // scales getRotation() (-Pi..Pi), whole turns are not stored so e.g. 3Pi/2 (= -Pi/2) * 0.5 gives -Pi/4
         friend Transform operator*(const Transform& t, f32 num);
         friend Transform operator-(const Transform& t1, const Transform& t2);   //calculates delta between transforms
         friend bool operator==(const Transform& t1, const Transform& t2);
@@ -19,20 +21,24 @@ namespace grynca {
     public:
         Transform();
         Transform(const Vec2& position, const Angle& rotation, const Vec2& scale = {1, 1});
+        Transform(const Vec2& position, const Dir2& rot_dir, const Vec2& scale = {1, 1});     // rot_dir must be unit
         Transform(const Mat3& m);   // extract from matrix
+        Transform(const Affine2& a);
 
         static Transform createTranslation(const Vec2& position);
         static Transform createRotation(const Angle& rotation);
+        static Transform createRotation(const Dir2& rot_dir);
         static Transform createScale(const Vec2& scale);
 
         Transform& set(const Transform& tr);
         Transform& setPosition(const Vec2& p);
         Transform& setScale(const Vec2& s);
         Transform& setRotation(const Angle& r);
+        Transform& setRotation(const Dir2& rot_dir);
 
         const Vec2& getPosition()const;
         const Vec2& getScale()const;
-        const Angle& getRotation()const;
+        Angle getRotation()const;     // calculated from rot. dir (-Pi..Pi, rotations past Pi are wrapped)
 
         Vec2& accPosition();
         Vec2& accScale();
@@ -41,10 +47,12 @@ namespace grynca {
         Dir2 getBottomDir()const;       // get local +Y
 
         Mat3 calcMatrix()const;
+        Affine2 calcAffine()const;      // prefer for transforming points (cheaper than Mat3)
 
         Transform& move(const Vec2& m);
         Transform& moveRelative(const Vec2& m);
         Transform& rotate(const Angle& r);
+        Transform& rotate(const Dir2& rot_dir);     // no trig. functions
         Transform& scale(const Vec2& s);
 
         const Dir2& getRotDir()const;
@@ -56,13 +64,13 @@ namespace grynca {
         Transform& operator/=(const Transform& t);
         Transform operator-()const;
     private:
-        static Angle extractRotation_(f32 a, f32 b, Dir2& rot_dir_out);
+        static Dir2 extractRotDir_(f32 a, f32 b);
         static Vec2 extractScale_(const glm::mat2& rs_mat, const Dir2& rot_dir);
 
         Vec2 position_;
         Vec2 scale_;
-        Angle rotation_;
-        Dir2 rot_dir_;      // (cos, sin)
+        // rotation as unit complex number (cos, sin), composed by multiplication (Angle::combineRotations)
+        Dir2 rot_dir_;
     };
 
 }
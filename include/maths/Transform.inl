@@ -1,24 +1,34 @@
 #include "Transform.h"
 #include "common.h"
+#include "trig_funcs.h"
 #include "glm/mat2x2.hpp"
 
 namespace grynca {
 
     inline Transform::Transform()
-    : position_(0, 0), scale_(1, 1), rotation_(0.0f), rot_dir_(1.0f, 0.0f)
+    : position_(0, 0), scale_(1, 1), rot_dir_(1.0f, 0.0f)
     {}
 
     inline Transform::Transform(const Vec2& position, const Angle& rotation, const Vec2& scale)
-     : position_(position), scale_(scale), rotation_(rotation), rot_dir_(rotation.getDir())
+     : position_(position), scale_(scale), rot_dir_(rotation.getDir())
+    {
+    }
+
+    inline Transform::Transform(const Vec2& position, const Dir2& rot_dir, const Vec2& scale)
+     : position_(position), scale_(scale), rot_dir_(rot_dir)
     {
     }
 
     inline Transform::Transform(const Mat3& m)
-     : position_(m.val(2, 0), m.val(2, 1))
+     : Transform(Affine2(m))
+    {}
+
+    inline Transform::Transform(const Affine2& a)
+     : position_(a.getTranslation())
     {
-        glm::mat2 rs_mat(m.val(0, 0), m.val(1, 0),
-                         m.val(0, 1), m.val(1, 1));
-        rotation_ = extractRotation_(rs_mat[0][0], rs_mat[1][0], rot_dir_);
+        glm::mat2 rs_mat(a.getCol(0).getX(), a.getCol(1).getX(),
+                         a.getCol(0).getY(), a.getCol(1).getY());
+        rot_dir_ = extractRotDir_(rs_mat[0][0], rs_mat[1][0]);
         scale_ = extractScale_(rs_mat, rot_dir_);
     }
 
@@ -32,6 +42,11 @@ namespace grynca {
         return Transform({0, 0}, rotation, {1,1});
     }
 
+    inline Transform Transform::createRotation(const Dir2& rot_dir) {
+        // static
+        return Transform({0, 0}, rot_dir, {1,1});
+    }
+
     inline Transform Transform::createScale(const Vec2& scale) {
         // static
         return Transform({0, 0}, 0, scale);
@@ -53,8 +68,12 @@ namespace grynca {
     }
 
     inline Transform& Transform::setRotation(const Angle& r) {
-        rotation_ = r;
-        rot_dir_ = rotation_.getDir();
+        rot_dir_ = r.getDir();
+        return *this;
+    }
+
+    inline Transform& Transform::setRotation(const Dir2& rot_dir) {
+        rot_dir_ = rot_dir;
         return *this;
     }
 
@@ -66,8 +85,8 @@ namespace grynca {
         return scale_;
     }
 
-    inline const Angle& Transform::getRotation()const {
-        return rotation_;
+    inline Angle Transform::getRotation()const {
+        return rot_dir_.getAngle();
     }
 
     inline Vec2& Transform::accPosition() {
@@ -90,6 +109,10 @@ namespace grynca {
         return Mat3::createTransform(position_, rot_dir_, scale_);
     }
 
+    inline Affine2 Transform::calcAffine()const {
+        return Affine2::createTransform(position_, rot_dir_, scale_);
+    }
+
     inline Transform& Transform::move(const Vec2& m) {
         position_+=m;
         return *this;
@@ -101,8 +124,11 @@ namespace grynca {
     }
 
     inline Transform& Transform::rotate(const Angle& r) {
-        rotation_ += r;
-        rot_dir_ = rotation_.getDir();
+        return rotate(r.getDir());
+    }
+
+    inline Transform& Transform::rotate(const Dir2& rot_dir) {
+        rot_dir_ = Angle::renormalizeRotDir(Angle::combineRotations(rot_dir_, rot_dir));
         return *this;
     }
 
@@ -123,7 +149,7 @@ namespace grynca {
     }
 
     inline bool Transform::isUnit()const {
-        return position_.isZero() && rotation_.isZero() && scale_.getX() == 1 && scale_.getY() == 1;
+        return position_.isZero() && rot_dir_.getX() == 1 && rot_dir_.getY() == 0 && scale_.getX() == 1 && scale_.getY() == 1;
     }
 
     inline Transform& Transform::operator*=(const Transform& t) {
@@ -137,10 +163,9 @@ namespace grynca {
 
     inline Transform Transform::operator-()const {
         Transform rslt;
-        rslt.rotation_ = -rotation_;
         rslt.rot_dir_ = Angle::invertRotDir(rot_dir_);
-        rslt.position_ = -position_.rotate(rslt.rot_dir_);
         rslt.scale_.set(1.0f/scale_.getX(), 1.0f/scale_.getY());
+        rslt.position_ = -position_.rotate(rslt.rot_dir_)*rslt.scale_;
         return rslt;
     }
 
@@ -154,9 +179,7 @@ namespace grynca {
         rslt.position_.accX() = glm::dot(t2_pos, m1[0]) + t1.position_.getX();
         rslt.position_.accY() = glm::dot(t2_pos, m1[1]) + t1.position_.getY();
 
-        rslt.rotation_ = t2.rotation_ + t1.rotation_;
-        rslt.rotation_.normalize();
-        rslt.rot_dir_ = Angle::combineRotations(t1.rot_dir_, t2.rot_dir_);
+        rslt.rot_dir_ = Angle::renormalizeRotDir(Angle::combineRotations(t1.rot_dir_, t2.rot_dir_));
         rslt.scale_ = Transform::extractScale_(m2*m1, rslt.rot_dir_);
         return rslt;
     }
@@ -166,7 +189,7 @@ namespace grynca {
     }
 
     inline Transform operator*(const Transform& t, f32 num) {
-        return Transform(t.position_*num, t.rotation_*num, t.scale_*num);
+        return Transform(t.position_*num, t.getRotation()*num, t.scale_*num);
     }
 
     inline Transform operator-(const Transform& t1, const Transform& t2) {
@@ -184,14 +207,16 @@ namespace grynca {
     }
 
     inline std::ostream& operator<<(std::ostream& os, const Transform& t) {
-        os << "P: " << t.position_ << ", R: " << t.rotation_ << ", S:" << t.scale_;
+        os << "P: " << t.position_ << ", R: " << t.getRotation() << ", S:" << t.scale_;
         return os;
     }
 
-    inline Angle Transform::extractRotation_(f32 a, f32 b, Dir2& rot_dir_out) {
-        Angle rslt(atan2f(b, a));
-        rot_dir_out = rslt.getDir();
-        return rslt;
+    inline Dir2 Transform::extractRotDir_(f32 a, f32 b) {
+        // static
+        f32 len = sqrtf(a*a + b*b);
+        if (len == 0.0f)
+            return {1.0f, 0.0f};
+        return {a/len, b/len};
     }
 
     inline Vec2 Transform::extractScale_(const glm::mat2& rs_mat, const Dir2& rot_dir) {
@@ -0,0 +1,115 @@
+#ifndef TRANSFORMHIERARCHY_H
+#define TRANSFORMHIERARCHY_H
+
+#include "Transform.h"
+#include "SIMD.h"
+
+namespace grynca {
+
+    // scene graph of transforms (e.g. colliders attached to bodies)
+    //  - node's world transform = parent's world transform * its local transform
+    //  - transforms are stored as SoA arrays sorted by node depth (parents before children),
+    //    update() recomputes changed nodes level by level with SIMD packets (parents gathered per lane)
+    //  - only dirty nodes (changed local transform or parent) are recomputed
+    //  - structural changes (add/remove/setParent) resort arrays in next update()
+    class TransformHierarchy {
+    public:
+        TransformHierarchy();
+
+        // returns node id, parent must exist
+        u32 addNode(const Transform& local, u32 parent = InvalidId());
+        // node must not have children
+        void removeNode(u32 node);
+        // InvalidId() makes node root, new parent must not be node's descendant
+        void setParent(u32 node, u32 parent);
+        void setLocal(u32 node, const Transform& local);
+        void clear();
+
+        u32 getNodesCount()const;
+        u32 getParent(u32 node)const;
+        Transform getLocal(u32 node)const;
+        // valid after update()
+        Transform getWorld(u32 node)const;
+
+        // recalculates world transforms of dirty nodes & their descendants
+        void update();
+
+        // (-world(ref_nodes[i]))*world(target_nodes[i]) for each pair (target in ref. node frame, as in OverlapHelper)
+        void calcRelativeTransforms(const u32* ref_nodes, const u32* target_nodes, u32 pairs_cnt, Transform* out)const;
+    private:
+        // SoA transforms
+        struct Transforms_ {
+            void push(const Transform& tr);
+            void set(u32 slot, const Transform& tr);
+            Transform get(u32 slot)const;
+            void copy(u32 slot_from, u32 slot_to);
+            void popBack();
+            void clear();
+            // this[i] = src[order[i]]
+            void gather(const Transforms_& src, const u32* order, u32 cnt);
+
+            fast_vector<f32> pos_x, pos_y;
+            fast_vector<f32> rot_c, rot_s;      // unit rot. dir
+            fast_vector<f32> scale_x, scale_y;
+        };
+
+        // loads/stores lanes of f32 or packet
+        template <typename F>
+        struct Lanes_;
+
+        // F lanes of transforms (F is f32, F32x4 or F32x8)
+        template <typename F>
+        struct TransformsN_ {
+            void load(const Transforms_& src, u32 slot);
+            void gather(const Transforms_& src, const u32* slots);
+            void store(Transforms_& dst, u32 slot)const;
+            void store(Transform* dst)const;
+
+            F pos_x, pos_y;
+            F rot_c, rot_s;
+            F scale_x, scale_y;
+        };
+
+        // same math as Transform's operator*() and operator-()
+        template <typename F>
+        static void combine_(const TransformsN_<F>& t1, const TransformsN_<F>& t2, TransformsN_<F>& out);
+        template <typename F>
+        static void invert_(const TransformsN_<F>& t, TransformsN_<F>& out);
+
+        void rebuild_();
+        u32 calcDepth_(u32 slot);
+        bool hasChildren_(u32 node)const;
+        bool isDescendant_(u32 node, u32 ancestor)const;
+        // world = parent world * local for dirty slots in [begin, end) (all with parents)
+        template <typename F>
+        void combinePackets_(u32 begin, u32 end);
+        template <typename F>
+        void combineSlots_(u32 begin, u32 end);
+        template <typename F>
+        void calcRelativePackets_(const u32* ref_nodes, const u32* target_nodes, u32 pairs_cnt, Transform* out)const;
+
+        // by node id
+        fast_vector<u32> slots_;        // InvalidId() for free id
+        fast_vector<u32> free_ids_;
+        // by slot
+        fast_vector<u32> ids_;
+        fast_vector<u32> parents_;      // parent node ids
+        fast_vector<u32> parent_slots_;     // valid after rebuild_()
+        fast_vector<u32> depths_;
+        fast_vector<u8> dirty_;
+        Transforms_ local_;
+        Transforms_ world_;
+        // slot ranges of depth levels (+ end)
+        fast_vector<u32> level_starts_;
+        bool structure_dirty_;
+
+        // rebuild_() scratch
+        fast_vector<u32> order_;
+        fast_vector<u32> tmp_u32_;
+        Transforms_ tmp_tr_;
+    };
+
+}
+
+#include "TransformHierarchy.inl"
+#endif //TRANSFORMHIERARCHY_H
@@ -0,0 +1,486 @@
+#include "TransformHierarchy.h"
+
+namespace grynca {
+
+    // lanes access for f32 & packets
+    template <typename F>
+    struct TransformHierarchy::Lanes_ {
+        static constexpr u32 Width = F::Width;
+
+        static F load(const f32* src) {
+            return F::load(src);
+        }
+
+        static F gather(const f32* src, const u32* ids) {
+            f32 vals[Width];
+            for (u32 l=0; l<Width; ++l) {
+                vals[l] = src[ids[l]];
+            }
+            return F::load(vals);
+        }
+
+        static void store(const F& v, f32* dst) {
+            v.store(dst);
+        }
+
+        static f32 get(const F& v, u32 lane) {
+            return v.get(lane);
+        }
+    };
+
+    template <>
+    struct TransformHierarchy::Lanes_<f32> {
+        static constexpr u32 Width = 1;
+
+        static f32 load(const f32* src) { return *src; }
+        static f32 gather(const f32* src, const u32* ids) { return src[ids[0]]; }
+        static void store(f32 v, f32* dst) { *dst = v; }
+        static f32 get(f32 v, u32) { return v; }
+    };
+
+    inline TransformHierarchy::TransformHierarchy()
+     : structure_dirty_(false)
+    {}
+
+    inline u32 TransformHierarchy::addNode(const Transform& local, u32 parent) {
+        ASSERT(parent == u32(InvalidId()) || (parent < slots_.size() && slots_[parent] != u32(InvalidId())));
+        u32 node;
+        if (!free_ids_.empty()) {
+            node = free_ids_.back();
+            free_ids_.pop_back();
+        }
+        else {
+            node = slots_.size();
+            slots_.push_back();
+        }
+
+        slots_[node] = ids_.size();
+        ids_.push_back(node);
+        parents_.push_back(parent);
+        dirty_.push_back(1);
+        local_.push(local);
+        world_.push(local);
+        structure_dirty_ = true;
+        return node;
+    }
+
+    inline void TransformHierarchy::removeNode(u32 node) {
+        ASSERT(node < slots_.size() && slots_[node] != u32(InvalidId()));
+        ASSERT_M(!hasChildren_(node), "node must not have children");
+
+        // swap with last slot (order is fixed in next update())
+        u32 slot = slots_[node];
+        u32 last = ids_.size()-1;
+        if (slot != last) {
+            ids_[slot] = ids_[last];
+            parents_[slot] = parents_[last];
+            dirty_[slot] = dirty_[last];
+            local_.copy(last, slot);
+            world_.copy(last, slot);
+            slots_[ids_[slot]] = slot;
+        }
+        ids_.pop_back();
+        parents_.pop_back();
+        dirty_.pop_back();
+        local_.popBack();
+        world_.popBack();
+
+        slots_[node] = InvalidId();
+        free_ids_.push_back(node);
+        structure_dirty_ = true;
+    }
+
+    inline void TransformHierarchy::setParent(u32 node, u32 parent) {
+        ASSERT(node < slots_.size() && slots_[node] != u32(InvalidId()));
+        ASSERT(parent == u32(InvalidId()) || (parent < slots_.size() && slots_[parent] != u32(InvalidId())));
+        ASSERT_M(parent == u32(InvalidId()) || !isDescendant_(parent, node), "cycle in hierarchy");
+        u32 slot = slots_[node];
+        parents_[slot] = parent;
+        dirty_[slot] = 1;
+        structure_dirty_ = true;
+    }
+
+    inline void TransformHierarchy::setLocal(u32 node, const Transform& local) {
+        ASSERT(node < slots_.size() && slots_[node] != u32(InvalidId()));
+        u32 slot = slots_[node];
+        local_.set(slot, local);
+        dirty_[slot] = 1;
+    }
+
+    inline void TransformHierarchy::clear() {
+        slots_.clear();
+        free_ids_.clear();
+        ids_.clear();
+        parents_.clear();
+        parent_slots_.clear();
+        depths_.clear();
+        dirty_.clear();
+        local_.clear();
+        world_.clear();
+        level_starts_.clear();
+        structure_dirty_ = false;
+    }
+
+    inline u32 TransformHierarchy::getNodesCount()const {
+        return ids_.size();
+    }
+
+    inline u32 TransformHierarchy::getParent(u32 node)const {
+        return parents_[slots_[node]];
+    }
+
+    inline Transform TransformHierarchy::getLocal(u32 node)const {
+        return local_.get(slots_[node]);
+    }
+
+    inline Transform TransformHierarchy::getWorld(u32 node)const {
+        return world_.get(slots_[node]);
+    }
+
+    inline void TransformHierarchy::update() {
+        if (structure_dirty_)
+            rebuild_();
+
+        if (ids_.empty())
+            return;
+        u32 levels_cnt = level_starts_.size()-1;
+
+        // roots
+        for (u32 s=0; s<level_starts_[1]; ++s) {
+            if (dirty_[s])
+                world_.set(s, local_.get(s));
+        }
+
+        for (u32 d=1; d<levels_cnt; ++d) {
+            u32 begin = level_starts_[d];
+            u32 end = level_starts_[d+1];
+            for (u32 s=begin; s<end; ++s) {
+                dirty_[s] |= dirty_[parent_slots_[s]];
+            }
+#if MATHS_SIMD_SSE
+            if (end-begin >= F32xN::Width) {
+                combinePackets_<F32xN>(begin, end);
+                continue;
+            }
+            if (end-begin >= F32x4::Width) {
+                combinePackets_<F32x4>(begin, end);
+                continue;
+            }
+#endif
+            combineSlots_<f32>(begin, end);
+        }
+
+        for (u32 s=0; s<dirty_.size(); ++s) {
+            dirty_[s] = 0;
+        }
+    }
+
+    inline void TransformHierarchy::calcRelativeTransforms(const u32* ref_nodes, const u32* target_nodes, u32 pairs_cnt, Transform* out)const {
+        ASSERT(!structure_dirty_);
+        if (!pairs_cnt)
+            return;
+#if MATHS_SIMD_SSE
+        if (pairs_cnt >= F32xN::Width) {
+            calcRelativePackets_<F32xN>(ref_nodes, target_nodes, pairs_cnt, out);
+            return;
+        }
+        if (pairs_cnt >= F32x4::Width) {
+            calcRelativePackets_<F32x4>(ref_nodes, target_nodes, pairs_cnt, out);
+            return;
+        }
+#endif
+        calcRelativePackets_<f32>(ref_nodes, target_nodes, pairs_cnt, out);
+    }
+
+    inline void TransformHierarchy::Transforms_::push(const Transform& tr) {
+        pos_x.push_back(tr.getPosition().getX());
+        pos_y.push_back(tr.getPosition().getY());
+        rot_c.push_back(tr.getRotDir().getX());
+        rot_s.push_back(tr.getRotDir().getY());
+        scale_x.push_back(tr.getScale().getX());
+        scale_y.push_back(tr.getScale().getY());
+    }
+
+    inline void TransformHierarchy::Transforms_::set(u32 slot, const Transform& tr) {
+        pos_x[slot] = tr.getPosition().getX();
+        pos_y[slot] = tr.getPosition().getY();
+        rot_c[slot] = tr.getRotDir().getX();
+        rot_s[slot] = tr.getRotDir().getY();
+        scale_x[slot] = tr.getScale().getX();
+        scale_y[slot] = tr.getScale().getY();
+    }
+
+    inline Transform TransformHierarchy::Transforms_::get(u32 slot)const {
+        return Transform(Vec2(pos_x[slot], pos_y[slot]), Dir2(rot_c[slot], rot_s[slot]), Vec2(scale_x[slot], scale_y[slot]));
+    }
+
+    inline void TransformHierarchy::Transforms_::copy(u32 slot_from, u32 slot_to) {
+        pos_x[slot_to] = pos_x[slot_from];
+        pos_y[slot_to] = pos_y[slot_from];
+        rot_c[slot_to] = rot_c[slot_from];
+        rot_s[slot_to] = rot_s[slot_from];
+        scale_x[slot_to] = scale_x[slot_from];
+        scale_y[slot_to] = scale_y[slot_from];
+    }
+
+    inline void TransformHierarchy::Transforms_::popBack() {
+        pos_x.pop_back();
+        pos_y.pop_back();
+        rot_c.pop_back();
+        rot_s.pop_back();
+        scale_x.pop_back();
+        scale_y.pop_back();
+    }
+
+    inline void TransformHierarchy::Transforms_::clear() {
+        pos_x.clear();
+        pos_y.clear();
+        rot_c.clear();
+        rot_s.clear();
+        scale_x.clear();
+        scale_y.clear();
+    }
+
+    inline void TransformHierarchy::Transforms_::gather(const Transforms_& src, const u32* order, u32 cnt) {
+        fast_vector<f32>* dsts[6] = {&pos_x, &pos_y, &rot_c, &rot_s, &scale_x, &scale_y};
+        const fast_vector<f32>* srcs[6] = {&src.pos_x, &src.pos_y, &src.rot_c, &src.rot_s, &src.scale_x, &src.scale_y};
+        for (u32 a=0; a<6; ++a) {
+            dsts[a]->resize(cnt);
+            f32* dst = dsts[a]->begin();
+            const f32* s = srcs[a]->begin();
+            for (u32 i=0; i<cnt; ++i) {
+                dst[i] = s[order[i]];
+            }
+        }
+    }
+
+    template <typename F>
+    inline void TransformHierarchy::TransformsN_<F>::load(const Transforms_& src, u32 slot) {
+        pos_x = Lanes_<F>::load(src.pos_x.begin()+slot);
+        pos_y = Lanes_<F>::load(src.pos_y.begin()+slot);
+        rot_c = Lanes_<F>::load(src.rot_c.begin()+slot);
+        rot_s = Lanes_<F>::load(src.rot_s.begin()+slot);
+        scale_x = Lanes_<F>::load(src.scale_x.begin()+slot);
+        scale_y = Lanes_<F>::load(src.scale_y.begin()+slot);
+    }
+
+    template <typename F>
+    inline void TransformHierarchy::TransformsN_<F>::gather(const Transforms_& src, const u32* slots) {
+        pos_x = Lanes_<F>::gather(src.pos_x.begin(), slots);
+        pos_y = Lanes_<F>::gather(src.pos_y.begin(), slots);
+        rot_c = Lanes_<F>::gather(src.rot_c.begin(), slots);
+        rot_s = Lanes_<F>::gather(src.rot_s.begin(), slots);
+        scale_x = Lanes_<F>::gather(src.scale_x.begin(), slots);
+        scale_y = Lanes_<F>::gather(src.scale_y.begin(), slots);
+    }
+
+    template <typename F>
+    inline void TransformHierarchy::TransformsN_<F>::store(Transforms_& dst, u32 slot)const {
+        Lanes_<F>::store(pos_x, dst.pos_x.begin()+slot);
+        Lanes_<F>::store(pos_y, dst.pos_y.begin()+slot);
+        Lanes_<F>::store(rot_c, dst.rot_c.begin()+slot);
+        Lanes_<F>::store(rot_s, dst.rot_s.begin()+slot);
+        Lanes_<F>::store(scale_x, dst.scale_x.begin()+slot);
+        Lanes_<F>::store(scale_y, dst.scale_y.begin()+slot);
+    }
+
+    template <typename F>
+    inline void TransformHierarchy::TransformsN_<F>::store(Transform* dst)const {
+        for (u32 l=0; l<Lanes_<F>::Width; ++l) {
+            dst[l] = Transform(Vec2(Lanes_<F>::get(pos_x, l), Lanes_<F>::get(pos_y, l)),
+                               Dir2(Lanes_<F>::get(rot_c, l), Lanes_<F>::get(rot_s, l)),
+                               Vec2(Lanes_<F>::get(scale_x, l), Lanes_<F>::get(scale_y, l)));
+        }
+    }
+
+    template <typename F>
+    inline void TransformHierarchy::combine_(const TransformsN_<F>& t1, const TransformsN_<F>& t2, TransformsN_<F>& out) {
+        // static
+        // rotation*scale matrices (as Transform::calcRSMat())
+        F a1 = t1.rot_c*t1.scale_x, b1 = -t1.rot_s*t1.scale_y, e1 = t1.rot_s*t1.scale_x, f1 = t1.rot_c*t1.scale_y;
+        F a2 = t2.rot_c*t2.scale_x, b2 = -t2.rot_s*t2.scale_y, e2 = t2.rot_s*t2.scale_x, f2 = t2.rot_c*t2.scale_y;
+
+        out.pos_x = t2.pos_x*a1 + t2.pos_y*b1 + t1.pos_x;
+        out.pos_y = t2.pos_x*e1 + t2.pos_y*f1 + t1.pos_y;
+
+        // Angle::combineRotations() + Angle::renormalizeRotDir()
+        F c = t1.rot_c*t2.rot_c - t1.rot_s*t2.rot_s;
+        F s = t1.rot_s*t2.rot_c + t1.rot_c*t2.rot_s;
+        F k = F(1.5f) - F(0.5f)*(c*c + s*s);
+        c = c*k;
+        s = s*k;
+        out.rot_c = c;
+        out.rot_s = s;
+
+        // Transform::extractScale_()
+        F p00 = a2*a1 + e2*b1;
+        F p10 = a2*e1 + e2*f1;
+        F p01 = b2*a1 + f2*b1;
+        F p11 = b2*e1 + f2*f1;
+        out.scale_x = p00*c + p10*s;
+        out.scale_y = p11*c - p01*s;
+    }
+
+    template <typename F>
+    inline void TransformHierarchy::invert_(const TransformsN_<F>& t, TransformsN_<F>& out) {
+        // static
+        out.rot_c = t.rot_c;
+        out.rot_s = -t.rot_s;
+        out.scale_x = F(1.0f)/t.scale_x;
+        out.scale_y = F(1.0f)/t.scale_y;
+        out.pos_x = -(t.pos_x*out.rot_c - t.pos_y*out.rot_s)*out.scale_x;
+        out.pos_y = -(t.pos_x*out.rot_s + t.pos_y*out.rot_c)*out.scale_y;
+    }
+
+    inline void TransformHierarchy::rebuild_() {
+        u32 n = ids_.size();
+        depths_.resize(n);
+        for (u32 s=0; s<n; ++s) {
+            depths_[s] = InvalidId();
+        }
+        u32 max_depth = 0;
+        for (u32 s=0; s<n; ++s) {
+            max_depth = std::max(max_depth, calcDepth_(s));
+        }
+
+        // counting sort by depth (stable, so already sorted arrays keep their order)
+        level_starts_.clear();
+        level_starts_.resize(n?max_depth+2:1, 0);
+        for (u32 s=0; s<n; ++s) {
+            ++level_starts_[depths_[s]+1];
+        }
+        for (u32 d=1; d<level_starts_.size(); ++d) {
+            level_starts_[d] += level_starts_[d-1];
+        }
+        tmp_u32_.resize(level_starts_.size());
+        for (u32 d=0; d<level_starts_.size(); ++d) {
+            tmp_u32_[d] = level_starts_[d];
+        }
+        order_.resize(n);
+        for (u32 s=0; s<n; ++s) {
+            order_[tmp_u32_[depths_[s]]++] = s;
+        }
+
+        // reorder slots
+        tmp_u32_.resize(n);
+        for (u32 i=0; i<n; ++i) {
+            tmp_u32_[i] = ids_[order_[i]];
+        }
+        for (u32 i=0; i<n; ++i) {
+            ids_[i] = tmp_u32_[i];
+            slots_[ids_[i]] = i;
+        }
+        for (u32 i=0; i<n; ++i) {
+            tmp_u32_[i] = parents_[order_[i]];
+        }
+        for (u32 i=0; i<n; ++i) {
+            parents_[i] = tmp_u32_[i];
+        }
+        tmp_tr_.gather(local_, order_.begin(), n);
+        local_ = tmp_tr_;
+        world_ = tmp_tr_;       // recalculated below
+
+        parent_slots_.resize(n);
+        for (u32 i=0; i<n; ++i) {
+            parent_slots_[i] = (parents_[i] == u32(InvalidId()))?u32(InvalidId()):slots_[parents_[i]];
+            dirty_[i] = 1;
+        }
+        structure_dirty_ = false;
+    }
+
+    inline u32 TransformHierarchy::calcDepth_(u32 slot) {
+        // walks up to root or node with known depth, then assigns depths on the way back
+        u32 steps = 0;
+        u32 s = slot;
+        while (depths_[s] == u32(InvalidId()) && parents_[s] != u32(InvalidId())) {
+            s = slots_[parents_[s]];
+            ++steps;
+        }
+        if (depths_[s] == u32(InvalidId()))
+            depths_[s] = 0;
+        u32 depth = depths_[s] + steps;
+        s = slot;
+        for (u32 d=depth; depths_[s] == u32(InvalidId()); --d) {
+            depths_[s] = d;
+            s = slots_[parents_[s]];
+        }
+        return depth;
+    }
+
+    inline bool TransformHierarchy::hasChildren_(u32 node)const {
+        for (u32 s=0; s<parents_.size(); ++s) {
+            if (parents_[s] == node)
+                return true;
+        }
+        return false;
+    }
+
+    inline bool TransformHierarchy::isDescendant_(u32 node, u32 ancestor)const {
+        for (u32 n=node; n != u32(InvalidId()); n = parents_[slots_[n]]) {
+            if (n == ancestor)
+                return true;
+        }
+        return false;
+    }
+
+    template <typename F>
+    inline void TransformHierarchy::combinePackets_(u32 begin, u32 end) {
+        static constexpr u32 W = Lanes_<F>::Width;
+        ASSERT(end-begin >= W);
+        // packets without dirty slot are skipped, last packet may overlap previous one
+        // (recalculating clean slot gives the same result)
+        for (u32 i=begin; ; i+=W) {
+            if (i+W > end)
+                i = end-W;
+            u8 any_dirty = 0;
+            for (u32 l=0; l<W; ++l) {
+                any_dirty |= dirty_[i+l];
+            }
+            if (any_dirty) {
+                TransformsN_<F> parent, local, world;
+                parent.gather(world_, parent_slots_.begin()+i);
+                local.load(local_, i);
+                combine_(parent, local, world);
+                world.store(world_, i);
+            }
+            if (i+W == end)
+                break;
+        }
+    }
+
+    template <typename F>
+    inline void TransformHierarchy::combineSlots_(u32 begin, u32 end) {
+        for (u32 s=begin; s<end; ++s) {
+            if (!dirty_[s])
+                continue;
+            TransformsN_<F> parent, local, world;
+            parent.gather(world_, parent_slots_.begin()+s);
+            local.load(local_, s);
+            combine_(parent, local, world);
+            world.store(world_, s);
+        }
+    }
+
+    template <typename F>
+    inline void TransformHierarchy::calcRelativePackets_(const u32* ref_nodes, const u32* target_nodes, u32 pairs_cnt, Transform* out)const {
+        static constexpr u32 W = Lanes_<F>::Width;
+        ASSERT(pairs_cnt >= W);
+        for (u32 i=0; ; i+=W) {
+            if (i+W > pairs_cnt)
+                i = pairs_cnt-W;
+            u32 ref_slots[W], target_slots[W];
+            for (u32 l=0; l<W; ++l) {
+                ref_slots[l] = slots_[ref_nodes[i+l]];
+                target_slots[l] = slots_[target_nodes[i+l]];
+            }
+            TransformsN_<F> ref, target, inv_ref, rslt;
+            ref.gather(world_, ref_slots);
+            target.gather(world_, target_slots);
+            invert_(ref, inv_ref);
+            combine_(inv_ref, target, rslt);
+            rslt.store(out+i);
+            if (i+W == pairs_cnt)
+                break;
+        }
+    }
+}
@@ -43,7 +43,7 @@ namespace grynca {
     public:
         Vec2();
         Vec2(f32 x, f32 y);
-        Vec2(const Vec2& v);
+        Vec2(const Vec2& v) = default;
 
         // When in (+Ydown, +Xright coords. frame) positive rotation is clockwise
         Vec2 rotate(const Angle& a)const;
@@ -3,6 +3,7 @@
 #include "Angle.h"
 #include "Interval.h"
 #include "Mat3.h"
+#include "trig_funcs.h"
 
 namespace grynca {
 
@@ -14,10 +15,6 @@ namespace grynca {
      : v_(x, y)
     {}
 
-    inline Vec2::Vec2(const Vec2& v)
-     : v_(v.v_)
-    {}
-
     inline Vec2::Vec2(const glm::vec2& v)
      : v_(v)
     {}
@@ -60,7 +57,7 @@ namespace grynca {
     }
 
     inline Angle Vec2::getAngle()const {
-        return Angle(atan2f(v_.y, v_.x));
+        return Angle(maths::calcAtan2(v_.y, v_.x));
     }
 
     inline f32 Vec2::getSqrLen()const {
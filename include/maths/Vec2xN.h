@@ -0,0 +1,68 @@
+#ifndef VEC2XN_H
+#define VEC2XN_H
+
+#include "SIMD.h"
+#include "Vec2.h"
+
+namespace grynca {
+
+    // packet of Width 2D vectors stored as SoA (x lanes, y lanes)
+    //  - same semantics as corresponding Vec2 methods, computed for all lanes at once
+    //  - F is F32x4 or F32x8
+    template <typename F>
+    class Vec2xN {
+    public:
+        static constexpr u32 Width = F::Width;
+
+        Vec2xN() {}
+        Vec2xN(const F& x, const F& y);
+        Vec2xN(const Vec2& v);      // broadcast
+
+        // Width vectors from AoS array
+        static Vec2xN load(const Vec2* vecs);
+        static Vec2xN loadSoA(const f32* xs, const f32* ys);
+        void store(Vec2* vecs_out)const;
+        void storeSoA(f32* xs_out, f32* ys_out)const;
+
+        const F& getX()const;
+        const F& getY()const;
+        F& accX();
+        F& accY();
+        Vec2 get(u32 lane)const;
+
+        Vec2xN perpL()const;
+        Vec2xN perpR()const;
+        Vec2xN rotate(const Dir2& rot_dir)const;
+        Vec2xN rotate(const Vec2xN& rot_dirs)const;        // each lane by its own direction
+        Vec2xN rotateInverse(const Dir2& rot_dir)const;
+        F getSqrLen()const;
+        F getLen()const;
+
+        Vec2xN& operator+=(const Vec2xN& v);
+        Vec2xN& operator-=(const Vec2xN& v);
+        Vec2xN& operator*=(const F& s);
+        Vec2xN operator-()const;
+    private:
+        F x_, y_;
+    };
+
+    template <typename F> Vec2xN<F> operator+(const Vec2xN<F>& v1, const Vec2xN<F>& v2);
+    template <typename F> Vec2xN<F> operator-(const Vec2xN<F>& v1, const Vec2xN<F>& v2);
+    template <typename F> Vec2xN<F> operator*(const Vec2xN<F>& v1, const Vec2xN<F>& v2);     // elementwise
+    template <typename F> Vec2xN<F> operator*(const Vec2xN<F>& v, const F& s);
+    template <typename F> Vec2xN<F> operator*(const F& s, const Vec2xN<F>& v);
+    template <typename F> Vec2xN<F> operator/(const Vec2xN<F>& v, const F& s);
+    template <typename F> F dot(const Vec2xN<F>& v1, const Vec2xN<F>& v2);
+    template <typename F> F cross(const Vec2xN<F>& v1, const Vec2xN<F>& v2);
+    // zero vectors stay zero
+    template <typename F> Vec2xN<F> normalize(const Vec2xN<F>& v);
+    template <typename F> Vec2xN<F> select(const F& mask, const Vec2xN<F>& t, const Vec2xN<F>& f);
+    template <typename F> Vec2xN<F> min(const Vec2xN<F>& v1, const Vec2xN<F>& v2);       // per component
+    template <typename F> Vec2xN<F> max(const Vec2xN<F>& v1, const Vec2xN<F>& v2);
+
+    typedef Vec2xN<F32x4> Vec2x4;
+    typedef Vec2xN<F32x8> Vec2x8;
+}
+
+#include "Vec2xN.inl"
+#endif //VEC2XN_H
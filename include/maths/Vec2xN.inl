@@ -0,0 +1,192 @@
+#include "Vec2xN.h"
+
+namespace grynca {
+
+    template <typename F>
+    inline Vec2xN<F>::Vec2xN(const F& x, const F& y)
+     : x_(x), y_(y)
+    {}
+
+    template <typename F>
+    inline Vec2xN<F>::Vec2xN(const Vec2& v)
+     : x_(v.getX()), y_(v.getY())
+    {}
+
+    template <typename F>
+    inline Vec2xN<F> Vec2xN<F>::load(const Vec2* vecs) {
+        // static
+        static_assert(sizeof(Vec2) == 2*sizeof(f32), "Vec2 must be tightly packed");
+        Vec2xN rslt;
+        F::loadInterleaved(reinterpret_cast<const f32*>(vecs), rslt.x_, rslt.y_);
+        return rslt;
+    }
+
+    template <typename F>
+    inline Vec2xN<F> Vec2xN<F>::loadSoA(const f32* xs, const f32* ys) {
+        // static
+        return {F::load(xs), F::load(ys)};
+    }
+
+    template <typename F>
+    inline void Vec2xN<F>::store(Vec2* vecs_out)const {
+        F::storeInterleaved(x_, y_, reinterpret_cast<f32*>(vecs_out));
+    }
+
+    template <typename F>
+    inline void Vec2xN<F>::storeSoA(f32* xs_out, f32* ys_out)const {
+        x_.store(xs_out);
+        y_.store(ys_out);
+    }
+
+    template <typename F>
+    inline const F& Vec2xN<F>::getX()const {
+        return x_;
+    }
+
+    template <typename F>
+    inline const F& Vec2xN<F>::getY()const {
+        return y_;
+    }
+
+    template <typename F>
+    inline F& Vec2xN<F>::accX() {
+        return x_;
+    }
+
+    template <typename F>
+    inline F& Vec2xN<F>::accY() {
+        return y_;
+    }
+
+    template <typename F>
+    inline Vec2 Vec2xN<F>::get(u32 lane)const {
+        return {x_.get(lane), y_.get(lane)};
+    }
+
+    template <typename F>
+    inline Vec2xN<F> Vec2xN<F>::perpL()const {
+        return {y_, -x_};
+    }
+
+    template <typename F>
+    inline Vec2xN<F> Vec2xN<F>::perpR()const {
+        return {-y_, x_};
+    }
+
+    template <typename F>
+    inline Vec2xN<F> Vec2xN<F>::rotate(const Dir2& rot_dir)const {
+        F dx(rot_dir.getX()), dy(rot_dir.getY());
+        return {x_*dx - y_*dy, x_*dy + y_*dx};
+    }
+
+    template <typename F>
+    inline Vec2xN<F> Vec2xN<F>::rotate(const Vec2xN& rot_dirs)const {
+        return {x_*rot_dirs.x_ - y_*rot_dirs.y_, x_*rot_dirs.y_ + y_*rot_dirs.x_};
+    }
+
+    template <typename F>
+    inline Vec2xN<F> Vec2xN<F>::rotateInverse(const Dir2& rot_dir)const {
+        F dx(rot_dir.getX()), dy(rot_dir.getY());
+        return {x_*dx + y_*dy, y_*dx - x_*dy};
+    }
+
+    template <typename F>
+    inline F Vec2xN<F>::getSqrLen()const {
+        return x_*x_ + y_*y_;
+    }
+
+    template <typename F>
+    inline F Vec2xN<F>::getLen()const {
+        return sqrt(getSqrLen());
+    }
+
+    template <typename F>
+    inline Vec2xN<F>& Vec2xN<F>::operator+=(const Vec2xN& v) {
+        x_ += v.x_;
+        y_ += v.y_;
+        return *this;
+    }
+
+    template <typename F>
+    inline Vec2xN<F>& Vec2xN<F>::operator-=(const Vec2xN& v) {
+        x_ -= v.x_;
+        y_ -= v.y_;
+        return *this;
+    }
+
+    template <typename F>
+    inline Vec2xN<F>& Vec2xN<F>::operator*=(const F& s) {
+        x_ *= s;
+        y_ *= s;
+        return *this;
+    }
+
+    template <typename F>
+    inline Vec2xN<F> Vec2xN<F>::operator-()const {
+        return {-x_, -y_};
+    }
+
+    template <typename F>
+    inline Vec2xN<F> operator+(const Vec2xN<F>& v1, const Vec2xN<F>& v2) {
+        return {v1.getX()+v2.getX(), v1.getY()+v2.getY()};
+    }
+
+    template <typename F>
+    inline Vec2xN<F> operator-(const Vec2xN<F>& v1, const Vec2xN<F>& v2) {
+        return {v1.getX()-v2.getX(), v1.getY()-v2.getY()};
+    }
+
+    template <typename F>
+    inline Vec2xN<F> operator*(const Vec2xN<F>& v1, const Vec2xN<F>& v2) {
+        return {v1.getX()*v2.getX(), v1.getY()*v2.getY()};
+    }
+
+    template <typename F>
+    inline Vec2xN<F> operator*(const Vec2xN<F>& v, const F& s) {
+        return {v.getX()*s, v.getY()*s};
+    }
+
+    template <typename F>
+    inline Vec2xN<F> operator*(const F& s, const Vec2xN<F>& v) {
+        return {v.getX()*s, v.getY()*s};
+    }
+
+    template <typename F>
+    inline Vec2xN<F> operator/(const Vec2xN<F>& v, const F& s) {
+        F inv = F(1.0f)/s;
+        return {v.getX()*inv, v.getY()*inv};
+    }
+
+    template <typename F>
+    inline F dot(const Vec2xN<F>& v1, const Vec2xN<F>& v2) {
+        return v1.getX()*v2.getX() + v1.getY()*v2.getY();
+    }
+
+    template <typename F>
+    inline F cross(const Vec2xN<F>& v1, const Vec2xN<F>& v2) {
+        return v1.getX()*v2.getY() - v1.getY()*v2.getX();
+    }
+
+    template <typename F>
+    inline Vec2xN<F> normalize(const Vec2xN<F>& v) {
+        F sqr_len = v.getSqrLen();
+        F zero(0.0f);
+        F inv_len = select(sqr_len > zero, F(1.0f)/sqrt(sqr_len), zero);
+        return v*inv_len;
+    }
+
+    template <typename F>
+    inline Vec2xN<F> select(const F& mask, const Vec2xN<F>& t, const Vec2xN<F>& f) {
+        return {select(mask, t.getX(), f.getX()), select(mask, t.getY(), f.getY())};
+    }
+
+    template <typename F>
+    inline Vec2xN<F> min(const Vec2xN<F>& v1, const Vec2xN<F>& v2) {
+        return {min(v1.getX(), v2.getX()), min(v1.getY(), v2.getY())};
+    }
+
+    template <typename F>
+    inline Vec2xN<F> max(const Vec2xN<F>& v1, const Vec2xN<F>& v2) {
+        return {max(v1.getX(), v2.getX()), max(v1.getY(), v2.getY())};
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef AABBTREE_H
+#define AABBTREE_H
+
+#include "../shapes/ARect.h"
+
+namespace grynca {
+
+    // Dynamic bounding volume tree for broadphase
+    //  - leaves hold fattened bounds of proxies so that small movements dont need reinsertion
+    //  - inner nodes are kept balanced with tree rotations
+    //  - proxy id is id of its leaf node (stays valid until proxy is removed)
+    class AABBTree {
+    public:
+        // fatness: margin added to each side of proxy bound (as in Pgon::calcFatAABB())
+        // displacement_mult: fat bound is also extended in direction of movement by displacement*mult
+        AABBTree(const Vec2& fatness = {2, 2}, f32 displacement_mult = 2.0f);
+
+        u32 addProxy(const ARect& bound, u32 user_data);        // returns proxy id
+        void removeProxy(u32 proxy_id);
+        // returns true if proxy was reinserted (its bound escaped from fat bound)
+        bool moveProxy(u32 proxy_id, const ARect& bound, const Vec2& displacement = {0, 0});
+        void clear();
+
+        u32 getProxiesCount()const;
+        u32 getUserData(u32 proxy_id)const;
+        const ARect& getFatBound(u32 proxy_id)const;
+        u32 getHeight()const;
+
+        // f(u32 proxy_id) -> return false for early exit
+        template <typename Func>
+        void queryOverlaps(const ARect& bound, const Func& cb)const;
+
+        // f(u32 user_data_a, u32 user_data_b)
+        // each pair of overlapping fat bounds is reported once
+        template <typename Func>
+        void queryPairs(const Func& cb)const;
+        // reports only pairs where at least one proxy was added/reinserted since last call
+        template <typename Func>
+        void queryNewPairs(const Func& cb);
+    private:
+        static constexpr u32 NullNode_ = u32(-1);
+        static constexpr u32 MaxStackSize_ = 256;
+
+        struct Node {
+            bool isLeaf()const { return child1 == NullNode_; }
+
+            ARect bound;
+            u32 parent;         // next free node for free nodes
+            u32 child1, child2;
+            i32 height;         // leaf = 0, free = -1
+            u32 user_data;
+            bool moved;
+        };
+
+        u32 allocNode_();
+        void freeNode_(u32 node_id);
+        void insertLeaf_(u32 leaf);
+        void removeLeaf_(u32 leaf);
+        void refitUpwards_(u32 node_id);
+        u32 balance_(u32 node_id);
+        void replaceChild_(u32 parent, u32 old_child, u32 new_child);
+        void setMoved_(u32 proxy_id);
+        ARect calcFatBound_(const ARect& bound, const Vec2& displacement)const;
+
+        fast_vector<Node> nodes_;
+        fast_vector<u32> moved_;
+        u32 root_;
+        u32 free_list_;
+        u32 proxies_cnt_;
+        Vec2 fatness_;
+        f32 displacement_mult_;
+    };
+
+}
+
+#include "AABBTree.inl"
+#endif //AABBTREE_H
@@ -0,0 +1,392 @@
+#include "AABBTree.h"
+#include "../shapes/ARect.h"
+
+namespace grynca {
+
+    inline AABBTree::AABBTree(const Vec2& fatness, f32 displacement_mult)
+     : root_(NullNode_), free_list_(NullNode_), proxies_cnt_(0),
+       fatness_(fatness), displacement_mult_(displacement_mult)
+    {}
+
+    inline u32 AABBTree::addProxy(const ARect& bound, u32 user_data) {
+        u32 proxy_id = allocNode_();
+        Node& n = nodes_[proxy_id];
+        n.bound = calcFatBound_(bound, Vec2(0, 0));
+        n.user_data = user_data;
+        n.height = 0;
+        insertLeaf_(proxy_id);
+        setMoved_(proxy_id);
+        ++proxies_cnt_;
+        return proxy_id;
+    }
+
+    inline void AABBTree::removeProxy(u32 proxy_id) {
+        ASSERT(proxy_id < nodes_.size() && nodes_[proxy_id].isLeaf());
+
+        if (nodes_[proxy_id].moved) {
+            u32* it = std::find(moved_.begin(), moved_.end(), proxy_id);
+            *it = moved_.back();
+            moved_.pop_back();
+        }
+        removeLeaf_(proxy_id);
+        freeNode_(proxy_id);
+        --proxies_cnt_;
+    }
+
+    inline bool AABBTree::moveProxy(u32 proxy_id, const ARect& bound, const Vec2& displacement) {
+        ASSERT(proxy_id < nodes_.size() && nodes_[proxy_id].isLeaf());
+
+        ARect fat_bound = calcFatBound_(bound, displacement);
+        const ARect& tree_bound = nodes_[proxy_id].bound;
+        if (tree_bound.contains(bound)) {
+            // also check if tree bound is not too large (e.g. after fast movement)
+            ARect huge_bound = fat_bound;
+            huge_bound.accBounds()[0] -= fatness_*4;
+            huge_bound.accBounds()[1] += fatness_*4;
+            if (huge_bound.contains(tree_bound)) {
+                return false;
+            }
+        }
+
+        removeLeaf_(proxy_id);
+        nodes_[proxy_id].bound = fat_bound;
+        insertLeaf_(proxy_id);
+        setMoved_(proxy_id);
+        return true;
+    }
+
+    inline void AABBTree::clear() {
+        nodes_.clear();
+        moved_.clear();
+        root_ = NullNode_;
+        free_list_ = NullNode_;
+        proxies_cnt_ = 0;
+    }
+
+    inline u32 AABBTree::getProxiesCount()const {
+        return proxies_cnt_;
+    }
+
+    inline u32 AABBTree::getUserData(u32 proxy_id)const {
+        return nodes_[proxy_id].user_data;
+    }
+
+    inline const ARect& AABBTree::getFatBound(u32 proxy_id)const {
+        return nodes_[proxy_id].bound;
+    }
+
+    inline u32 AABBTree::getHeight()const {
+        if (root_ == NullNode_)
+            return 0;
+        return u32(nodes_[root_].height);
+    }
+
+    template <typename Func>
+    inline void AABBTree::queryOverlaps(const ARect& bound, const Func& cb)const {
+        if (root_ == NullNode_)
+            return;
+
+        u32 stack[MaxStackSize_];
+        u32 stack_size = 0;
+        stack[stack_size++] = root_;
+
+        while (stack_size) {
+            const Node& n = nodes_[stack[--stack_size]];
+            if (!n.bound.intersects(bound))
+                continue;
+
+            if (n.isLeaf()) {
+                if (!cb(u32(&n - nodes_.begin())))
+                    return;
+            }
+            else {
+                ASSERT(stack_size+2 <= MaxStackSize_);
+                stack[stack_size++] = n.child1;
+                stack[stack_size++] = n.child2;
+            }
+        }
+    }
+
+    template <typename Func>
+    inline void AABBTree::queryPairs(const Func& cb)const {
+        for (u32 i=0; i<nodes_.size(); ++i) {
+            const Node& n = nodes_[i];
+            if (n.height != 0)
+                continue;       // inner or free node
+
+            queryOverlaps(n.bound, [this, i, &cb](u32 proxy_id) {
+                if (proxy_id > i) {
+                    cb(nodes_[i].user_data, nodes_[proxy_id].user_data);
+                }
+                return true;
+            });
+        }
+    }
+
+    template <typename Func>
+    inline void AABBTree::queryNewPairs(const Func& cb) {
+        for (u32 i=0; i<moved_.size(); ++i) {
+            u32 moved_id = moved_[i];
+            queryOverlaps(nodes_[moved_id].bound, [this, moved_id, &cb](u32 proxy_id) {
+                // when both moved, report pair only once
+                if (proxy_id == moved_id || (nodes_[proxy_id].moved && proxy_id < moved_id))
+                    return true;
+                cb(nodes_[moved_id].user_data, nodes_[proxy_id].user_data);
+                return true;
+            });
+        }
+
+        for (u32 i=0; i<moved_.size(); ++i) {
+            nodes_[moved_[i]].moved = false;
+        }
+        moved_.clear();
+    }
+
+    inline u32 AABBTree::allocNode_() {
+        u32 node_id;
+        if (free_list_ == NullNode_) {
+            node_id = u32(nodes_.size());
+            nodes_.push_back();
+        }
+        else {
+            node_id = free_list_;
+            free_list_ = nodes_[node_id].parent;
+        }
+
+        Node& n = nodes_[node_id];
+        n.parent = n.child1 = n.child2 = NullNode_;
+        n.height = 0;
+        n.user_data = InvalidId();
+        n.moved = false;
+        return node_id;
+    }
+
+    inline void AABBTree::freeNode_(u32 node_id) {
+        Node& n = nodes_[node_id];
+        n.parent = free_list_;
+        n.height = -1;
+        free_list_ = node_id;
+    }
+
+    inline void AABBTree::insertLeaf_(u32 leaf) {
+        if (root_ == NullNode_) {
+            root_ = leaf;
+            nodes_[leaf].parent = NullNode_;
+            return;
+        }
+
+        // find best sibling (perimeter cost heuristic)
+        ARect leaf_bound = nodes_[leaf].bound;
+        u32 id = root_;
+        while (!nodes_[id].isLeaf()) {
+            const Node& n = nodes_[id];
+            f32 perimeter = n.bound.calcPerimeter();
+            f32 combined_perimeter = ARect::combine(n.bound, leaf_bound).calcPerimeter();
+
+            // cost of creating new parent for this node and the new leaf
+            f32 cost = 2*combined_perimeter;
+            // min cost of pushing leaf further down the tree
+            f32 inheritance_cost = 2*(combined_perimeter - perimeter);
+
+            f32 child_costs[2];
+            u32 children[2] = {n.child1, n.child2};
+            for (u32 i=0; i<2; ++i) {
+                const Node& c = nodes_[children[i]];
+                f32 c_perimeter = ARect::combine(c.bound, leaf_bound).calcPerimeter();
+                if (!c.isLeaf()) {
+                    c_perimeter -= c.bound.calcPerimeter();
+                }
+                child_costs[i] = c_perimeter + inheritance_cost;
+            }
+
+            if (cost < child_costs[0] && cost < child_costs[1])
+                break;
+
+            id = (child_costs[0] < child_costs[1])?children[0]:children[1];
+        }
+
+        u32 sibling = id;
+        u32 old_parent = nodes_[sibling].parent;
+        u32 new_parent = allocNode_();     // (can realloc nodes)
+        Node& np = nodes_[new_parent];
+        np.parent = old_parent;
+        np.bound = ARect::combine(leaf_bound, nodes_[sibling].bound);
+        np.height = nodes_[sibling].height + 1;
+        np.child1 = sibling;
+        np.child2 = leaf;
+
+        if (old_parent != NullNode_) {
+            replaceChild_(old_parent, sibling, new_parent);
+        }
+        else {
+            root_ = new_parent;
+        }
+        nodes_[sibling].parent = new_parent;
+        nodes_[leaf].parent = new_parent;
+
+        refitUpwards_(new_parent);
+    }
+
+    inline void AABBTree::removeLeaf_(u32 leaf) {
+        if (leaf == root_) {
+            root_ = NullNode_;
+            return;
+        }
+
+        u32 parent = nodes_[leaf].parent;
+        u32 grand_parent = nodes_[parent].parent;
+        u32 sibling = (nodes_[parent].child1 == leaf)?nodes_[parent].child2:nodes_[parent].child1;
+
+        freeNode_(parent);
+        nodes_[sibling].parent = grand_parent;
+        if (grand_parent != NullNode_) {
+            replaceChild_(grand_parent, parent, sibling);
+            refitUpwards_(grand_parent);
+        }
+        else {
+            root_ = sibling;
+        }
+    }
+
+    inline void AABBTree::refitUpwards_(u32 node_id) {
+        while (node_id != NullNode_) {
+            node_id = balance_(node_id);
+
+            Node& n = nodes_[node_id];
+            const Node& c1 = nodes_[n.child1];
+            const Node& c2 = nodes_[n.child2];
+            n.height = 1 + std::max(c1.height, c2.height);
+            n.bound = ARect::combine(c1.bound, c2.bound);
+
+            node_id = n.parent;
+        }
+    }
+
+    inline u32 AABBTree::balance_(u32 a_id) {
+        // rotates A's heavier child up when A is not balanced, returns new subtree root
+        Node& A = nodes_[a_id];
+        if (A.isLeaf() || A.height < 2)
+            return a_id;
+
+        u32 b_id = A.child1;
+        u32 c_id = A.child2;
+        Node& B = nodes_[b_id];
+        Node& C = nodes_[c_id];
+        i32 balance = C.height - B.height;
+
+        if (balance > 1) {
+            // rotate C up
+            u32 f_id = C.child1;
+            u32 g_id = C.child2;
+            Node& F = nodes_[f_id];
+            Node& G = nodes_[g_id];
+
+            C.child1 = a_id;
+            C.parent = A.parent;
+            A.parent = c_id;
+            if (C.parent != NullNode_) {
+                replaceChild_(C.parent, a_id, c_id);
+            }
+            else {
+                root_ = c_id;
+            }
+
+            if (F.height > G.height) {
+                C.child2 = f_id;
+                A.child2 = g_id;
+                G.parent = a_id;
+                A.bound = ARect::combine(B.bound, G.bound);
+                C.bound = ARect::combine(A.bound, F.bound);
+                A.height = 1 + std::max(B.height, G.height);
+                C.height = 1 + std::max(A.height, F.height);
+            }
+            else {
+                C.child2 = g_id;
+                A.child2 = f_id;
+                F.parent = a_id;
+                A.bound = ARect::combine(B.bound, F.bound);
+                C.bound = ARect::combine(A.bound, G.bound);
+                A.height = 1 + std::max(B.height, F.height);
+                C.height = 1 + std::max(A.height, G.height);
+            }
+            return c_id;
+        }
+
+        if (balance < -1) {
+            // rotate B up
+            u32 d_id = B.child1;
+            u32 e_id = B.child2;
+            Node& D = nodes_[d_id];
+            Node& E = nodes_[e_id];
+
+            B.child1 = a_id;
+            B.parent = A.parent;
+            A.parent = b_id;
+            if (B.parent != NullNode_) {
+                replaceChild_(B.parent, a_id, b_id);
+            }
+            else {
+                root_ = b_id;
+            }
+
+            if (D.height > E.height) {
+                B.child2 = d_id;
+                A.child1 = e_id;
+                E.parent = a_id;
+                A.bound = ARect::combine(C.bound, E.bound);
+                B.bound = ARect::combine(A.bound, D.bound);
+                A.height = 1 + std::max(C.height, E.height);
+                B.height = 1 + std::max(A.height, D.height);
+            }
+            else {
+                B.child2 = e_id;
+                A.child1 = d_id;
+                D.parent = a_id;
+                A.bound = ARect::combine(C.bound, D.bound);
+                B.bound = ARect::combine(A.bound, E.bound);
+                A.height = 1 + std::max(C.height, D.height);
+                B.height = 1 + std::max(A.height, E.height);
+            }
+            return b_id;
+        }
+
+        return a_id;
+    }
+
+    inline void AABBTree::replaceChild_(u32 parent, u32 old_child, u32 new_child) {
+        Node& p = nodes_[parent];
+        if (p.child1 == old_child) {
+            p.child1 = new_child;
+        }
+        else {
+            ASSERT(p.child2 == old_child);
+            p.child2 = new_child;
+        }
+    }
+
+    inline void AABBTree::setMoved_(u32 proxy_id) {
+        Node& n = nodes_[proxy_id];
+        if (!n.moved) {
+            n.moved = true;
+            moved_.push_back(proxy_id);
+        }
+    }
+
+    inline ARect AABBTree::calcFatBound_(const ARect& bound, const Vec2& displacement)const {
+        ARect rslt = bound;
+        rslt.accBounds()[0] -= fatness_;
+        rslt.accBounds()[1] += fatness_;
+
+        // predict movement
+        Vec2 d = displacement*displacement_mult_;
+        if (d.getX() < 0.0f)
+            rslt.accBounds()[0].accX() += d.getX();
+        else
+            rslt.accBounds()[1].accX() += d.getX();
+        if (d.getY() < 0.0f)
+            rslt.accBounds()[0].accY() += d.getY();
+        else
+            rslt.accBounds()[1].accY() += d.getY();
+        return rslt;
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include "../shapes/ARect.h"
+
+namespace grynca {
+
+    // Hashed uniform grid for broadphase of many similar-sized shapes
+    //  - cells are hashed to fixed number of buckets, so world is not limited
+    //  - proxies should not be much larger than cell (they are registered to each overlapped cell)
+    //  - moving proxy within the same cells only updates its bound
+    class SpatialGrid {
+    public:
+        // buckets_cnt is rounded up to power of 2
+        SpatialGrid(f32 cell_size, u32 buckets_cnt = 4096);
+
+        u32 addProxy(const ARect& bound, u32 user_data);        // returns proxy id
+        void removeProxy(u32 proxy_id);
+        void moveProxy(u32 proxy_id, const ARect& bound);
+        void clear();
+
+        u32 getProxiesCount()const;
+        u32 getUserData(u32 proxy_id)const;
+        const ARect& getBound(u32 proxy_id)const;
+        f32 getCellSize()const;
+
+        // f(u32 user_data_a, u32 user_data_b)
+        // each pair of overlapping bounds is reported once
+        template <typename Func>
+        void queryPairs(const Func& cb)const;
+
+        // f(u32 proxy_id) -> return false for early exit
+        template <typename Func>
+        void queryOverlaps(const ARect& bound, const Func& cb)const;
+        template <typename Func>
+        void queryOverlaps(const Circle& circle, const Func& cb)const;
+        // walks cells along ray (DDA), proxies are reported roughly front to back
+        template <typename Func>
+        void queryRay(const Ray& ray, const Func& cb)const;
+    private:
+        struct Entry {
+            i32 cell[2];
+            u32 proxy_id;
+        };
+
+        struct Proxy {
+            ARect bound;
+            u32 user_data;
+            i32 cells_min[2];
+            i32 cells_max[2];
+            u32 query_stamp;        // for dedup of proxies spanning more cells
+        };
+
+        void calcCells_(const ARect& bound, i32 cells_min_out[2], i32 cells_max_out[2])const;
+        i32 calcCellCoord_(f32 v)const;
+        u32 calcBucket_(i32 cx, i32 cy)const;
+        void insertToCells_(u32 proxy_id);
+        void removeFromCells_(u32 proxy_id);
+        u32 nextQueryStamp_()const;
+
+        // calls cb(proxy_id) for unvisited proxies in cell, returns false on early exit
+        template <typename Func>
+        bool visitCell_(i32 cx, i32 cy, u32 stamp, const Func& cb)const;
+
+        static bool overlapsBound_(const Circle& circle, const ARect& bound);
+        static bool overlapsBound_(const Vec2& ray_start, const Vec2& ray_vec, const ARect& bound);
+
+        f32 cell_size_;
+        f32 inv_cell_size_;
+        u32 buckets_mask_;
+        fast_vector<fast_vector<Entry> > buckets_;
+        mutable fast_vector<Proxy> proxies_;
+        fast_vector<u32> free_proxies_;
+        mutable u32 query_stamp_;
+    };
+
+}
+
+#include "SpatialGrid.inl"
+#endif //SPATIALGRID_H
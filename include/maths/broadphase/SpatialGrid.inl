@@ -0,0 +1,310 @@
+#include "SpatialGrid.h"
+#include "../shapes/ARect.h"
+#include "../shapes/Circle.h"
+#include "../shapes/Ray.h"
+
+namespace grynca {
+
+    inline SpatialGrid::SpatialGrid(f32 cell_size, u32 buckets_cnt)
+     : cell_size_(cell_size), inv_cell_size_(1.0f/cell_size), query_stamp_(0)
+    {
+        ASSERT(cell_size > 0.0f);
+        u32 cnt = 1;
+        while (cnt < buckets_cnt)
+            cnt <<= 1;
+        buckets_mask_ = cnt-1;
+        buckets_.resize(cnt);
+    }
+
+    inline u32 SpatialGrid::addProxy(const ARect& bound, u32 user_data) {
+        u32 proxy_id;
+        if (!free_proxies_.empty()) {
+            proxy_id = free_proxies_.back();
+            free_proxies_.pop_back();
+        }
+        else {
+            proxy_id = proxies_.size();
+            proxies_.push_back();
+        }
+
+        Proxy& p = proxies_[proxy_id];
+        p.bound = bound;
+        p.user_data = user_data;
+        p.query_stamp = query_stamp_;
+        calcCells_(bound, p.cells_min, p.cells_max);
+        insertToCells_(proxy_id);
+        return proxy_id;
+    }
+
+    inline void SpatialGrid::removeProxy(u32 proxy_id) {
+        ASSERT(proxy_id < proxies_.size());
+        removeFromCells_(proxy_id);
+        free_proxies_.push_back(proxy_id);
+    }
+
+    inline void SpatialGrid::moveProxy(u32 proxy_id, const ARect& bound) {
+        ASSERT(proxy_id < proxies_.size());
+        Proxy& p = proxies_[proxy_id];
+        p.bound = bound;
+
+        i32 cmin[2], cmax[2];
+        calcCells_(bound, cmin, cmax);
+        if (cmin[0] == p.cells_min[0] && cmin[1] == p.cells_min[1]
+            && cmax[0] == p.cells_max[0] && cmax[1] == p.cells_max[1])
+        {
+            return;
+        }
+        removeFromCells_(proxy_id);
+        p.cells_min[0] = cmin[0];
+        p.cells_min[1] = cmin[1];
+        p.cells_max[0] = cmax[0];
+        p.cells_max[1] = cmax[1];
+        insertToCells_(proxy_id);
+    }
+
+    inline void SpatialGrid::clear() {
+        for (u32 i=0; i<buckets_.size(); ++i) {
+            buckets_[i].clear();
+        }
+        proxies_.clear();
+        free_proxies_.clear();
+    }
+
+    inline u32 SpatialGrid::getProxiesCount()const {
+        return proxies_.size() - free_proxies_.size();
+    }
+
+    inline u32 SpatialGrid::getUserData(u32 proxy_id)const {
+        return proxies_[proxy_id].user_data;
+    }
+
+    inline const ARect& SpatialGrid::getBound(u32 proxy_id)const {
+        return proxies_[proxy_id].bound;
+    }
+
+    inline f32 SpatialGrid::getCellSize()const {
+        return cell_size_;
+    }
+
+    template <typename Func>
+    inline void SpatialGrid::queryPairs(const Func& cb)const {
+        for (u32 b=0; b<buckets_.size(); ++b) {
+            const fast_vector<Entry>& bucket = buckets_[b];
+            for (u32 i=0; i<bucket.size(); ++i) {
+                const Entry& e1 = bucket[i];
+                const ARect& b1 = proxies_[e1.proxy_id].bound;
+                for (u32 j=i+1; j<bucket.size(); ++j) {
+                    const Entry& e2 = bucket[j];
+                    // other cell hashed to same bucket
+                    if (e1.cell[0] != e2.cell[0] || e1.cell[1] != e2.cell[1])
+                        continue;
+                    const ARect& b2 = proxies_[e2.proxy_id].bound;
+                    if (!b1.intersects(b2))
+                        continue;
+                    // report only from cell containing left-top corner of intersection
+                    f32 isect_l = std::max(b1.getLeftTop().getX(), b2.getLeftTop().getX());
+                    f32 isect_t = std::max(b1.getLeftTop().getY(), b2.getLeftTop().getY());
+                    if (calcCellCoord_(isect_l) != e1.cell[0] || calcCellCoord_(isect_t) != e1.cell[1])
+                        continue;
+                    cb(proxies_[e1.proxy_id].user_data, proxies_[e2.proxy_id].user_data);
+                }
+            }
+        }
+    }
+
+    template <typename Func>
+    inline void SpatialGrid::queryOverlaps(const ARect& bound, const Func& cb)const {
+        i32 cmin[2], cmax[2];
+        calcCells_(bound, cmin, cmax);
+        u32 stamp = nextQueryStamp_();
+        for (i32 cy=cmin[1]; cy<=cmax[1]; ++cy) {
+            for (i32 cx=cmin[0]; cx<=cmax[0]; ++cx) {
+                bool cont = visitCell_(cx, cy, stamp, [this, &bound, &cb](u32 proxy_id) {
+                    if (!proxies_[proxy_id].bound.intersects(bound))
+                        return true;
+                    return bool(cb(proxy_id));
+                });
+                if (!cont)
+                    return;
+            }
+        }
+    }
+
+    template <typename Func>
+    inline void SpatialGrid::queryOverlaps(const Circle& circle, const Func& cb)const {
+        i32 cmin[2], cmax[2];
+        calcCells_(circle.calcARectBound(), cmin, cmax);
+        u32 stamp = nextQueryStamp_();
+        for (i32 cy=cmin[1]; cy<=cmax[1]; ++cy) {
+            for (i32 cx=cmin[0]; cx<=cmax[0]; ++cx) {
+                bool cont = visitCell_(cx, cy, stamp, [this, &circle, &cb](u32 proxy_id) {
+                    if (!overlapsBound_(circle, proxies_[proxy_id].bound))
+                        return true;
+                    return bool(cb(proxy_id));
+                });
+                if (!cont)
+                    return;
+            }
+        }
+    }
+
+    template <typename Func>
+    inline void SpatialGrid::queryRay(const Ray& ray, const Func& cb)const {
+        Vec2 start = ray.getStart();
+        Vec2 ray_vec = ray.getToEndVec();
+        u32 stamp = nextQueryStamp_();
+        auto test_cb = [this, &start, &ray_vec, &cb](u32 proxy_id) {
+            if (!overlapsBound_(start, ray_vec, proxies_[proxy_id].bound))
+                return true;
+            return bool(cb(proxy_id));
+        };
+
+        // DDA walk (Amanatides & Woo)
+        i32 cell[2] = {calcCellCoord_(start.getX()), calcCellCoord_(start.getY())};
+        Vec2 end = start + ray_vec;
+        i32 end_cell[2] = {calcCellCoord_(end.getX()), calcCellCoord_(end.getY())};
+        i32 step[2];
+        f32 t_max[2], t_delta[2];
+        for (u32 a=0; a<2; ++a) {
+            f32 d = ray_vec.val(a);
+            if (d > 0.0f) {
+                step[a] = 1;
+                t_max[a] = ((cell[a]+1)*cell_size_ - start.val(a))/d;
+                t_delta[a] = cell_size_/d;
+            }
+            else if (d < 0.0f) {
+                step[a] = -1;
+                t_max[a] = (cell[a]*cell_size_ - start.val(a))/d;
+                t_delta[a] = -cell_size_/d;
+            }
+            else {
+                step[a] = 0;
+                t_max[a] = std::numeric_limits<f32>::max();
+                t_delta[a] = std::numeric_limits<f32>::max();
+            }
+        }
+
+        while (true) {
+            if (!visitCell_(cell[0], cell[1], stamp, test_cb))
+                return;
+            if (cell[0] == end_cell[0] && cell[1] == end_cell[1])
+                return;
+            u32 a = (t_max[0] < t_max[1])?0:1;
+            if (t_max[a] > 1.0f)
+                return;
+            cell[a] += step[a];
+            t_max[a] += t_delta[a];
+        }
+    }
+
+    inline void SpatialGrid::calcCells_(const ARect& bound, i32 cells_min_out[2], i32 cells_max_out[2])const {
+        // left, top, right, bottom
+        const f32* bd = bound.getDataPtr();
+        cells_min_out[0] = calcCellCoord_(bd[0]);
+        cells_min_out[1] = calcCellCoord_(bd[1]);
+        cells_max_out[0] = calcCellCoord_(bd[2]);
+        cells_max_out[1] = calcCellCoord_(bd[3]);
+    }
+
+    inline i32 SpatialGrid::calcCellCoord_(f32 v)const {
+        return i32(floorf(v*inv_cell_size_));
+    }
+
+    inline u32 SpatialGrid::calcBucket_(i32 cx, i32 cy)const {
+        return ((u32(cx)*73856093u) ^ (u32(cy)*19349663u)) & buckets_mask_;
+    }
+
+    inline void SpatialGrid::insertToCells_(u32 proxy_id) {
+        const Proxy& p = proxies_[proxy_id];
+        for (i32 cy=p.cells_min[1]; cy<=p.cells_max[1]; ++cy) {
+            for (i32 cx=p.cells_min[0]; cx<=p.cells_max[0]; ++cx) {
+                fast_vector<Entry>& bucket = buckets_[calcBucket_(cx, cy)];
+                bucket.push_back();
+                Entry& e = bucket.back();
+                e.cell[0] = cx;
+                e.cell[1] = cy;
+                e.proxy_id = proxy_id;
+            }
+        }
+    }
+
+    inline void SpatialGrid::removeFromCells_(u32 proxy_id) {
+        const Proxy& p = proxies_[proxy_id];
+        for (i32 cy=p.cells_min[1]; cy<=p.cells_max[1]; ++cy) {
+            for (i32 cx=p.cells_min[0]; cx<=p.cells_max[0]; ++cx) {
+                fast_vector<Entry>& bucket = buckets_[calcBucket_(cx, cy)];
+                for (u32 i=0; i<bucket.size(); ++i) {
+                    const Entry& e = bucket[i];
+                    if (e.proxy_id == proxy_id && e.cell[0] == cx && e.cell[1] == cy) {
+                        bucket[i] = bucket.back();
+                        bucket.pop_back();
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    inline u32 SpatialGrid::nextQueryStamp_()const {
+        ++query_stamp_;
+        if (query_stamp_ == 0) {
+            // wrapped around, reset stamps
+            for (u32 i=0; i<proxies_.size(); ++i) {
+                proxies_[i].query_stamp = 0;
+            }
+            query_stamp_ = 1;
+        }
+        return query_stamp_;
+    }
+
+    template <typename Func>
+    inline bool SpatialGrid::visitCell_(i32 cx, i32 cy, u32 stamp, const Func& cb)const {
+        const fast_vector<Entry>& bucket = buckets_[calcBucket_(cx, cy)];
+        for (u32 i=0; i<bucket.size(); ++i) {
+            const Entry& e = bucket[i];
+            if (e.cell[0] != cx || e.cell[1] != cy)
+                continue;
+            Proxy& p = proxies_[e.proxy_id];
+            if (p.query_stamp == stamp)
+                continue;
+            p.query_stamp = stamp;
+            if (!cb(e.proxy_id))
+                return false;
+        }
+        return true;
+    }
+
+    inline bool SpatialGrid::overlapsBound_(const Circle& circle, const ARect& bound) {
+        // static
+        const Vec2& c = circle.getCenter();
+        f32 dx = c.getX() - std::min(std::max(c.getX(), bound.getLeftTop().getX()), bound.getRightBot().getX());
+        f32 dy = c.getY() - std::min(std::max(c.getY(), bound.getLeftTop().getY()), bound.getRightBot().getY());
+        f32 r = circle.getRadius();
+        return dx*dx + dy*dy <= r*r;
+    }
+
+    inline bool SpatialGrid::overlapsBound_(const Vec2& ray_start, const Vec2& ray_vec, const ARect& bound) {
+        // static
+        // slab test, t in <0, 1>
+        f32 t_min = 0.0f, t_max = 1.0f;
+        const Vec2* bds = bound.getBounds();
+        for (u32 a=0; a<2; ++a) {
+            f32 d = ray_vec.val(a);
+            if (fabsf(d) < maths::EPS) {
+                if (ray_start.val(a) < bds[0].val(a) || ray_start.val(a) > bds[1].val(a))
+                    return false;
+                continue;
+            }
+            f32 inv_d = 1.0f/d;
+            f32 t1 = (bds[0].val(a) - ray_start.val(a))*inv_d;
+            f32 t2 = (bds[1].val(a) - ray_start.val(a))*inv_d;
+            if (t1 > t2)
+                std::swap(t1, t2);
+            t_min = std::max(t_min, t1);
+            t_max = std::min(t_max, t2);
+            if (t_min > t_max)
+                return false;
+        }
+        return true;
+    }
+}
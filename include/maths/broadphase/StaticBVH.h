@@ -0,0 +1,74 @@
+#ifndef STATICBVH_H
+#define STATICBVH_H
+
+#include "../shapes/ARect.h"
+
+namespace grynca {
+
+    // Bounding volume hierarchy for static geometry (built once, e.g. at level load)
+    //  - built top-down with binned surface area heuristic (perimeter in 2D)
+    //  - nodes are 32B and stored in flat array, children of inner node are adjacent
+    //  - queries report primitive ids (indices to bounds array given to build())
+    class StaticBVH {
+    public:
+        StaticBVH();
+
+        void build(const ARect* bounds, u32 count, u32 max_leaf_size = 4);
+        void clear();
+
+        bool isEmpty()const;
+        u32 getNodesCount()const;
+        u32 getPrimitivesCount()const;
+        u32 calcDepth()const;
+
+        // f(u32 prim_id) -> return false for early exit
+        template <typename Func>
+        void queryOverlaps(const ARect& bound, const Func& cb)const;
+        // nodes are visited near child first, f(u32 prim_id) -> return false for early exit
+        template <typename Func>
+        void queryRay(const Ray& ray, const Func& cb)const;
+        // exact test against primitive shapes (in same space as shape)
+        // get_prim_f(u32 prim_id) -> const Shape&, f(u32 prim_id) -> return false for early exit
+        template <typename GetPrimFunc, typename Func>
+        void queryShape(const Shape& shape, const GetPrimFunc& get_prim_f, const Func& cb)const;
+    private:
+        static constexpr u32 BinsCount_ = 16;
+        static constexpr u32 MaxDepth_ = 64;
+
+        struct Node {
+            bool isLeaf()const { return prims_count != 0; }
+
+            // left, top, right, bottom
+            f32 bound[4];
+            u32 first;              // first child for inner node, first primitive for leaf
+            u32 prims_count;        // 0 for inner node
+            u32 split_axis;
+            u32 pad_;
+        };
+
+        struct BuildPrim {
+            ARect bound;
+            Vec2 center;
+            u32 prim_id;
+        };
+
+        void buildNode_(u32 node_id, BuildPrim* prims, u32 first, u32 count, u32 depth);
+        // returns false when it is cheaper to keep prims in leaf
+        bool findSplit_(const BuildPrim* prims, u32 count, const ARect& node_bound, u32& axis_out, f32& split_out)const;
+        void calcDepth_(u32 node_id, u32 depth, u32& max_depth_io)const;
+
+        static bool overlapsBound_(const f32* bound, const f32* b2);
+        // slab test for ray segment (t in <0, 1>)
+        static bool rayOverlapsBound_(const f32* bound, const Vec2& start, const Vec2& inv_dir);
+        static f32 calcSafeInv_(f32 v);
+
+        fast_vector<Node> nodes_;
+        fast_vector<u32> prim_ids_;
+        fast_vector<ARect> prim_bounds_;        // in leaf order
+        u32 max_leaf_size_;
+    };
+
+}
+
+#include "StaticBVH.inl"
+#endif //STATICBVH_H
@@ -0,0 +1,273 @@
+#include "StaticBVH.h"
+#include "../shapes/ARect.h"
+#include "../shapes/Ray.h"
+#include "../shapes/Shape.h"
+
+namespace grynca {
+
+    inline StaticBVH::StaticBVH()
+     : max_leaf_size_(4)
+    {}
+
+    inline void StaticBVH::build(const ARect* bounds, u32 count, u32 max_leaf_size) {
+        PROFILE_BLOCK("StaticBVH::build");
+        static_assert(sizeof(Node) == 32, "StaticBVH node is expected to have 32B");
+        ASSERT(max_leaf_size > 0);
+
+        clear();
+        if (count == 0)
+            return;
+        max_leaf_size_ = max_leaf_size;
+
+        fast_vector<BuildPrim> prims(count);
+        for (u32 i=0; i<count; ++i) {
+            prims[i].bound = bounds[i];
+            prims[i].center = bounds[i].getCenter();
+            prims[i].prim_id = i;
+        }
+
+        // binary tree has at most 2n-1 nodes
+        nodes_.reserve(count*2);
+        nodes_.push_back();
+        buildNode_(0, prims.begin(), 0, count, 0);
+
+        prim_ids_.resize(count);
+        prim_bounds_.resize(count);
+        for (u32 i=0; i<count; ++i) {
+            prim_ids_[i] = prims[i].prim_id;
+            prim_bounds_[i] = prims[i].bound;
+        }
+    }
+
+    inline void StaticBVH::clear() {
+        nodes_.clear();
+        prim_ids_.clear();
+        prim_bounds_.clear();
+    }
+
+    inline bool StaticBVH::isEmpty()const {
+        return nodes_.empty();
+    }
+
+    inline u32 StaticBVH::getNodesCount()const {
+        return nodes_.size();
+    }
+
+    inline u32 StaticBVH::getPrimitivesCount()const {
+        return prim_ids_.size();
+    }
+
+    inline u32 StaticBVH::calcDepth()const {
+        if (isEmpty())
+            return 0;
+        u32 max_depth = 0;
+        calcDepth_(0, 1, max_depth);
+        return max_depth;
+    }
+
+    template <typename Func>
+    inline void StaticBVH::queryOverlaps(const ARect& bound, const Func& cb)const {
+        if (isEmpty())
+            return;
+
+        const f32* bd = bound.getDataPtr();
+        u32 stack[MaxDepth_+2];
+        u32 stack_size = 0;
+        stack[stack_size++] = 0;
+        while (stack_size) {
+            const Node& n = nodes_[stack[--stack_size]];
+            if (!overlapsBound_(n.bound, bd))
+                continue;
+            if (n.isLeaf()) {
+                for (u32 i=n.first; i<n.first+n.prims_count; ++i) {
+                    if (overlapsBound_(prim_bounds_[i].getDataPtr(), bd)) {
+                        if (!cb(prim_ids_[i]))
+                            return;
+                    }
+                }
+            }
+            else {
+                stack[stack_size++] = n.first+1;
+                stack[stack_size++] = n.first;
+            }
+        }
+    }
+
+    template <typename Func>
+    inline void StaticBVH::queryRay(const Ray& ray, const Func& cb)const {
+        if (isEmpty())
+            return;
+
+        Vec2 start = ray.getStart();
+        Vec2 ray_vec = ray.getToEndVec();
+        // huge instead of inf for zero direction (avoids 0*inf in slab test)
+        Vec2 inv_dir(calcSafeInv_(ray_vec.getX()), calcSafeInv_(ray_vec.getY()));
+        bool dir_neg[2] = {ray_vec.getX() < 0.0f, ray_vec.getY() < 0.0f};
+
+        u32 stack[MaxDepth_+2];
+        u32 stack_size = 0;
+        stack[stack_size++] = 0;
+        while (stack_size) {
+            const Node& n = nodes_[stack[--stack_size]];
+            if (!rayOverlapsBound_(n.bound, start, inv_dir))
+                continue;
+            if (n.isLeaf()) {
+                for (u32 i=n.first; i<n.first+n.prims_count; ++i) {
+                    if (rayOverlapsBound_(prim_bounds_[i].getDataPtr(), start, inv_dir)) {
+                        if (!cb(prim_ids_[i]))
+                            return;
+                    }
+                }
+            }
+            else {
+                // near child is popped first
+                u32 near = n.first + dir_neg[n.split_axis];
+                u32 far = n.first + 1 - dir_neg[n.split_axis];
+                stack[stack_size++] = far;
+                stack[stack_size++] = near;
+            }
+        }
+    }
+
+    template <typename GetPrimFunc, typename Func>
+    inline void StaticBVH::queryShape(const Shape& shape, const GetPrimFunc& get_prim_f, const Func& cb)const {
+        queryOverlaps(shape.calcARectBound(), [&shape, &get_prim_f, &cb](u32 prim_id) {
+            if (!shape.overlaps(get_prim_f(prim_id)))
+                return true;
+            return bool(cb(prim_id));
+        });
+    }
+
+    inline void StaticBVH::buildNode_(u32 node_id, BuildPrim* prims, u32 first, u32 count, u32 depth) {
+        ARect node_bound = prims[first].bound;
+        for (u32 i=first+1; i<first+count; ++i) {
+            node_bound.expand(prims[i].bound);
+        }
+        memcpy(nodes_[node_id].bound, node_bound.getDataPtr(), sizeof(f32)*4);
+        nodes_[node_id].split_axis = 0;
+
+        u32 axis;
+        f32 split;
+        bool do_split = (count > max_leaf_size_) && (depth < MaxDepth_)
+                        && findSplit_(prims+first, count, node_bound, axis, split);
+        if (!do_split) {
+            nodes_[node_id].first = first;
+            nodes_[node_id].prims_count = count;
+            return;
+        }
+
+        BuildPrim* mid_it = std::partition(prims+first, prims+first+count, [axis, split](const BuildPrim& p) {
+            return p.center.val(axis) < split;
+        });
+        u32 left_count = u32(mid_it - (prims+first));
+        if (left_count == 0 || left_count == count) {
+            // all centers in one bin, split in the middle
+            std::nth_element(prims+first, prims+first+count/2, prims+first+count, [axis](const BuildPrim& p1, const BuildPrim& p2) {
+                return p1.center.val(axis) < p2.center.val(axis);
+            });
+            left_count = count/2;
+        }
+
+        u32 children = nodes_.size();
+        nodes_.push_back();
+        nodes_.push_back();
+        nodes_[node_id].first = children;
+        nodes_[node_id].prims_count = 0;
+        nodes_[node_id].split_axis = axis;
+        buildNode_(children, prims, first, left_count, depth+1);
+        buildNode_(children+1, prims, first+left_count, count-left_count, depth+1);
+    }
+
+    inline bool StaticBVH::findSplit_(const BuildPrim* prims, u32 count, const ARect& node_bound, u32& axis_out, f32& split_out)const {
+        ARect centers_bound(&prims[0].center, 1);
+        for (u32 i=1; i<count; ++i) {
+            centers_bound.expand(ARect(&prims[i].center, 1));
+        }
+
+        // costs are not divided by node perimeter (traversal cost 1, primitive test cost 1)
+        f32 node_perimeter = node_bound.calcPerimeter();
+        f32 best_cost = node_perimeter*count;
+        bool found = false;
+        for (u32 a=0; a<2; ++a) {
+            f32 c_min = centers_bound.getLeftTop().val(a);
+            f32 c_extent = centers_bound.getRightBot().val(a) - c_min;
+            if (c_extent <= 0.0f)
+                continue;
+
+            ARect bins_bound[BinsCount_];
+            u32 bins_count[BinsCount_] = {};
+            f32 bin_mult = BinsCount_/c_extent;
+            for (u32 i=0; i<count; ++i) {
+                u32 b = std::min(u32((prims[i].center.val(a) - c_min)*bin_mult), BinsCount_-1);
+                if (bins_count[b] == 0)
+                    bins_bound[b] = prims[i].bound;
+                else
+                    bins_bound[b].expand(prims[i].bound);
+                ++bins_count[b];
+            }
+
+            // sweep from right for costs of right parts
+            f32 right_costs[BinsCount_];
+            ARect acc_bound;
+            u32 acc_count = 0;
+            for (u32 b=BinsCount_-1; b>0; --b) {
+                if (bins_count[b]) {
+                    acc_bound = acc_count?ARect::combine(acc_bound, bins_bound[b]):bins_bound[b];
+                    acc_count += bins_count[b];
+                }
+                right_costs[b] = acc_count?acc_bound.calcPerimeter()*acc_count:0.0f;
+            }
+
+            acc_count = 0;
+            for (u32 b=0; b<BinsCount_-1; ++b) {
+                if (bins_count[b]) {
+                    acc_bound = acc_count?ARect::combine(acc_bound, bins_bound[b]):bins_bound[b];
+                    acc_count += bins_count[b];
+                }
+                if (acc_count == 0 || acc_count == count)
+                    continue;
+                f32 cost = node_perimeter + acc_bound.calcPerimeter()*acc_count + right_costs[b+1];
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    axis_out = a;
+                    split_out = c_min + (b+1)/bin_mult;
+                    found = true;
+                }
+            }
+        }
+        return found;
+    }
+
+    inline void StaticBVH::calcDepth_(u32 node_id, u32 depth, u32& max_depth_io)const {
+        const Node& n = nodes_[node_id];
+        max_depth_io = std::max(max_depth_io, depth);
+        if (!n.isLeaf()) {
+            calcDepth_(n.first, depth+1, max_depth_io);
+            calcDepth_(n.first+1, depth+1, max_depth_io);
+        }
+    }
+
+    inline bool StaticBVH::overlapsBound_(const f32* b1, const f32* b2) {
+        // static
+        return b1[0] <= b2[2] && b2[0] <= b1[2]
+               && b1[1] <= b2[3] && b2[1] <= b1[3];
+    }
+
+    inline bool StaticBVH::rayOverlapsBound_(const f32* bound, const Vec2& start, const Vec2& inv_dir) {
+        // static
+        f32 tx1 = (bound[0] - start.getX())*inv_dir.getX();
+        f32 tx2 = (bound[2] - start.getX())*inv_dir.getX();
+        f32 ty1 = (bound[1] - start.getY())*inv_dir.getY();
+        f32 ty2 = (bound[3] - start.getY())*inv_dir.getY();
+        f32 t_enter = std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)), 0.0f);
+        f32 t_exit = std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)), 1.0f);
+        return t_enter <= t_exit;
+    }
+
+    inline f32 StaticBVH::calcSafeInv_(f32 v) {
+        // static
+        if (fabsf(v) < 1e-20f)
+            return (v<0.0f)?-1e30f:1e30f;
+        return 1.0f/v;
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef SWEEPANDPRUNE_H
+#define SWEEPANDPRUNE_H
+
+#include "../shapes/ARect.h"
+#include <unordered_set>
+
+namespace grynca {
+
+    // Incremental sweep and prune broadphase
+    //  - keeps sorted endpoint arrays on X and Y between updates
+    //  - arrays are resorted with insertion sort, so with coherent movement update is ~O(n + swaps)
+    //  - overlapping pairs are tracked persistently, update() reports begin/end of overlaps
+    //  - when many proxies were added since last update, arrays are rebuilt with full sort + sweep instead
+    class SweepAndPrune {
+    public:
+        SweepAndPrune();
+
+        // proxy is sorted in (and its begin events are reported) during next update()
+        u32 addProxy(const ARect& bound, u32 user_data);        // returns proxy id
+        // removes proxy immediately together with its pairs (no end events)
+        void removeProxy(u32 proxy_id);
+        void moveProxy(u32 proxy_id, const ARect& bound);
+        void clear();
+
+        // resorts endpoints and reports overlap changes since last update
+        // begin_cb(u32 user_data_a, u32 user_data_b), end_cb(u32 user_data_a, u32 user_data_b)
+        template <typename BeginFunc, typename EndFunc>
+        void update(const BeginFunc& begin_cb, const EndFunc& end_cb);
+
+        // f(u32 user_data_a, u32 user_data_b), pairs overlapping at last update
+        template <typename Func>
+        void getPairs(const Func& cb)const;
+
+        u32 getProxiesCount()const;
+        u32 getPairsCount()const;
+        u32 getUserData(u32 proxy_id)const;
+        const ARect& getBound(u32 proxy_id)const;
+        u32 getLastSwapsCount()const;           // endpoint swaps during last update
+    private:
+        struct Endpoint {
+            u32 getProxyId()const { return data >> 1; }
+            bool isMax()const { return (data & 1) != 0; }
+            // on equal values min goes first (touching bounds overlap as in ARect::intersects())
+            bool isBefore(const Endpoint& e)const { return value < e.value || (value == e.value && !isMax() && e.isMax()); }
+
+            f32 value;
+            u32 data;       // proxy_id << 1 | is_max
+        };
+
+        struct Proxy {
+            ARect bound;
+            u32 user_data;
+            u32 endpoints[2][2];        // [axis][is_max] -> endpoint index
+        };
+
+        static u64 makePairKey_(u32 proxy_a, u32 proxy_b);
+        void setEndpointsValues_(u32 proxy_id);
+        void setEndpointIndex_(u32 axis, const Endpoint& ep, u32 index);
+        void bubbleToEnd_(u32 axis, u32 index);     // silently removes pairs it leaves
+
+        template <typename BeginFunc, typename EndFunc>
+        void sortAxis_(u32 axis, const BeginFunc& begin_cb, const EndFunc& end_cb);
+        template <typename BeginFunc, typename EndFunc>
+        void rebuild_(const BeginFunc& begin_cb, const EndFunc& end_cb);
+
+        fast_vector<Proxy> proxies_;
+        fast_vector<u32> free_proxies_;
+        fast_vector<Endpoint> endpoints_[2];
+        std::unordered_set<u64> pairs_;
+        u32 added_cnt_;         // proxies added since last update
+        u32 last_swaps_;
+    };
+
+}
+
+#include "SweepAndPrune.inl"
+#endif //SWEEPANDPRUNE_H
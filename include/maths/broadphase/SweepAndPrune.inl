@@ -0,0 +1,221 @@
+#include "SweepAndPrune.h"
+#include "../shapes/ARect.h"
+
+namespace grynca {
+
+    inline SweepAndPrune::SweepAndPrune()
+     : added_cnt_(0), last_swaps_(0)
+    {}
+
+    inline u32 SweepAndPrune::addProxy(const ARect& bound, u32 user_data) {
+        u32 proxy_id;
+        if (!free_proxies_.empty()) {
+            proxy_id = free_proxies_.back();
+            free_proxies_.pop_back();
+        }
+        else {
+            proxy_id = proxies_.size();
+            proxies_.push_back();
+        }
+
+        Proxy& p = proxies_[proxy_id];
+        p.bound = bound;
+        p.user_data = user_data;
+        // appended at the end, insertion sort will move endpoints to their places
+        for (u32 a=0; a<2; ++a) {
+            for (u32 m=0; m<2; ++m) {
+                p.endpoints[a][m] = endpoints_[a].size();
+                endpoints_[a].push_back();
+                endpoints_[a].back().data = (proxy_id<<1) | m;
+            }
+        }
+        setEndpointsValues_(proxy_id);
+        ++added_cnt_;
+        return proxy_id;
+    }
+
+    inline void SweepAndPrune::removeProxy(u32 proxy_id) {
+        ASSERT(proxy_id < proxies_.size());
+
+        for (u32 a=0; a<2; ++a) {
+            bubbleToEnd_(a, proxies_[proxy_id].endpoints[a][0]);
+            bubbleToEnd_(a, proxies_[proxy_id].endpoints[a][1]);
+            endpoints_[a].pop_back();
+            endpoints_[a].pop_back();
+        }
+        free_proxies_.push_back(proxy_id);
+    }
+
+    inline void SweepAndPrune::moveProxy(u32 proxy_id, const ARect& bound) {
+        ASSERT(proxy_id < proxies_.size());
+        proxies_[proxy_id].bound = bound;
+        setEndpointsValues_(proxy_id);
+    }
+
+    inline void SweepAndPrune::clear() {
+        proxies_.clear();
+        free_proxies_.clear();
+        endpoints_[0].clear();
+        endpoints_[1].clear();
+        pairs_.clear();
+        added_cnt_ = 0;
+        last_swaps_ = 0;
+    }
+
+    template <typename BeginFunc, typename EndFunc>
+    inline void SweepAndPrune::update(const BeginFunc& begin_cb, const EndFunc& end_cb) {
+        last_swaps_ = 0;
+        // appended endpoints would need O(n) swaps each
+        if (added_cnt_*8 > getProxiesCount()) {
+            rebuild_(begin_cb, end_cb);
+        }
+        else {
+            sortAxis_(0, begin_cb, end_cb);
+            sortAxis_(1, begin_cb, end_cb);
+        }
+        added_cnt_ = 0;
+    }
+
+    template <typename Func>
+    inline void SweepAndPrune::getPairs(const Func& cb)const {
+        for (auto it = pairs_.begin(); it != pairs_.end(); ++it) {
+            cb(proxies_[u32(*it >> 32)].user_data, proxies_[u32(*it)].user_data);
+        }
+    }
+
+    inline u32 SweepAndPrune::getProxiesCount()const {
+        return proxies_.size() - free_proxies_.size();
+    }
+
+    inline u32 SweepAndPrune::getPairsCount()const {
+        return u32(pairs_.size());
+    }
+
+    inline u32 SweepAndPrune::getUserData(u32 proxy_id)const {
+        return proxies_[proxy_id].user_data;
+    }
+
+    inline const ARect& SweepAndPrune::getBound(u32 proxy_id)const {
+        return proxies_[proxy_id].bound;
+    }
+
+    inline u32 SweepAndPrune::getLastSwapsCount()const {
+        return last_swaps_;
+    }
+
+    inline u64 SweepAndPrune::makePairKey_(u32 proxy_a, u32 proxy_b) {
+        // static
+        if (proxy_a > proxy_b)
+            std::swap(proxy_a, proxy_b);
+        return (u64(proxy_a) << 32) | proxy_b;
+    }
+
+    inline void SweepAndPrune::setEndpointsValues_(u32 proxy_id) {
+        Proxy& p = proxies_[proxy_id];
+        // left, top, right, bottom
+        const f32* bd = p.bound.getDataPtr();
+        for (u32 a=0; a<2; ++a) {
+            endpoints_[a][p.endpoints[a][0]].value = bd[a];
+            endpoints_[a][p.endpoints[a][1]].value = bd[2+a];
+        }
+    }
+
+    inline void SweepAndPrune::setEndpointIndex_(u32 axis, const Endpoint& ep, u32 index) {
+        proxies_[ep.getProxyId()].endpoints[axis][ep.isMax()] = index;
+    }
+
+    inline void SweepAndPrune::bubbleToEnd_(u32 axis, u32 index) {
+        fast_vector<Endpoint>& eps = endpoints_[axis];
+        Endpoint ep = eps[index];
+        for (u32 i=index+1; i<eps.size(); ++i) {
+            const Endpoint& next = eps[i];
+            // min moving right over max of other proxy -> they stop overlapping
+            if (!ep.isMax() && next.isMax() && next.getProxyId() != ep.getProxyId()) {
+                pairs_.erase(makePairKey_(ep.getProxyId(), next.getProxyId()));
+            }
+            eps[i-1] = next;
+            setEndpointIndex_(axis, next, i-1);
+        }
+        eps.back() = ep;
+        setEndpointIndex_(axis, ep, eps.size()-1);
+    }
+
+    template <typename BeginFunc, typename EndFunc>
+    inline void SweepAndPrune::sortAxis_(u32 axis, const BeginFunc& begin_cb, const EndFunc& end_cb) {
+        // insertion sort, each inverted pair of endpoints is swapped exactly once so
+        // pair can only begin if it overlaps after update and only end if it doesnt
+        fast_vector<Endpoint>& eps = endpoints_[axis];
+        for (u32 i=1; i<eps.size(); ++i) {
+            Endpoint ep = eps[i];
+            u32 j = i;
+            while (j > 0 && ep.isBefore(eps[j-1])) {
+                const Endpoint& prev = eps[j-1];
+                u32 pa = ep.getProxyId();
+                u32 pb = prev.getProxyId();
+                if (!ep.isMax() && prev.isMax()) {
+                    // min moving left over max -> may start overlapping
+                    if (proxies_[pa].bound.intersects(proxies_[pb].bound)) {
+                        if (pairs_.insert(makePairKey_(pa, pb)).second)
+                            begin_cb(proxies_[pa].user_data, proxies_[pb].user_data);
+                    }
+                }
+                else if (ep.isMax() && !prev.isMax()) {
+                    // max moving left over min -> stops overlapping
+                    if (pairs_.erase(makePairKey_(pa, pb)))
+                        end_cb(proxies_[pa].user_data, proxies_[pb].user_data);
+                }
+                eps[j] = prev;
+                setEndpointIndex_(axis, prev, j);
+                --j;
+            }
+            if (j != i) {
+                eps[j] = ep;
+                setEndpointIndex_(axis, ep, j);
+                last_swaps_ += i-j;
+            }
+        }
+    }
+
+    template <typename BeginFunc, typename EndFunc>
+    inline void SweepAndPrune::rebuild_(const BeginFunc& begin_cb, const EndFunc& end_cb) {
+        for (u32 a=0; a<2; ++a) {
+            fast_vector<Endpoint>& eps = endpoints_[a];
+            std::sort(eps.begin(), eps.end(), [](const Endpoint& e1, const Endpoint& e2) {
+                return e1.isBefore(e2);
+            });
+            for (u32 i=0; i<eps.size(); ++i) {
+                setEndpointIndex_(a, eps[i], i);
+            }
+        }
+
+        // sweep over X, test active proxies on both axes
+        std::unordered_set<u64> new_pairs;
+        fast_vector<u32> active;
+        fast_vector<Endpoint>& eps = endpoints_[0];
+        for (u32 i=0; i<eps.size(); ++i) {
+            u32 pa = eps[i].getProxyId();
+            if (eps[i].isMax()) {
+                u32* it = std::find(active.begin(), active.end(), pa);
+                *it = active.back();
+                active.pop_back();
+                continue;
+            }
+            for (u32 j=0; j<active.size(); ++j) {
+                u32 pb = active[j];
+                if (proxies_[pa].bound.intersects(proxies_[pb].bound)) {
+                    u64 key = makePairKey_(pa, pb);
+                    new_pairs.insert(key);
+                    if (!pairs_.count(key))
+                        begin_cb(proxies_[pa].user_data, proxies_[pb].user_data);
+                }
+            }
+            active.push_back(pa);
+        }
+
+        for (auto it = pairs_.begin(); it != pairs_.end(); ++it) {
+            if (!new_pairs.count(*it))
+                end_cb(proxies_[u32(*it >> 32)].user_data, proxies_[u32(*it)].user_data);
+        }
+        pairs_.swap(new_pairs);
+    }
+}
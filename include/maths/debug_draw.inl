@@ -18,7 +18,7 @@ namespace grynca {
             }break;
             case Shape::getTypeIdOf<Ray>(): {
                 const Ray& ray = s.get<Ray>();
-                Mat3 trm = tr.calcMatrix();
+                Affine2 trm = tr.calcAffine();
                 drawArrow(r, trm*ray.getStart(), trm*ray.getEnd());
             }break;
             case Shape::getTypeIdOf<Pgon>(): {
@@ -147,7 +147,7 @@ namespace grynca {
     }
 
     inline void DebugDraw::drawPgon_(SDL_Renderer* r, const Pgon& p, const Transform& tr, u32 flags) {
-        Pgon pgon = p.transformOut(tr.calcMatrix());
+        Pgon pgon = p.transformOut(tr.calcAffine());
         pgon.calculateNormalsIfNeeded();
 
         u32 j = 0;
@@ -0,0 +1,65 @@
+#ifndef CONTACTCACHE_H
+#define CONTACTCACHE_H
+
+#include "../shapes/ContactManifold.h"
+
+namespace grynca {
+
+    // impulses of contact point kept between frames (for solver warm-starting)
+    struct CachedContact {
+        u32 feature_id;
+        f32 normal_impulse;
+        f32 tangent_impulse;
+    };
+
+    struct CachedManifold {
+        u64 key;
+        u32 last_frame;         // frame of last update
+        u32 size;
+        CachedContact contacts[ContactManifold::MAX_SIZE];
+    };
+
+    // persistent manifolds of shape pairs (open addressing with linear probing)
+    //  - update() matches new contacts against old ones by feature_id, matched contacts take over old impulses
+    //    (contacts without feature ids, e.g. of circles, are matched by index when manifold size is the same)
+    //  - pairs not updated for more than max_age frames are removed in endFrame()
+    //  - table grows only when it gets half full, so there are no allocations per frame in steady state
+    class ContactCache {
+    public:
+        // capacity is rounded up to power of 2
+        ContactCache(u32 initial_capacity = 1024);
+
+        // order of ids in pair matters (normal and feature ids depend on it)
+        // returned reference is valid until next update() or endFrame()
+        CachedManifold& update(u32 id_a, u32 id_b, const ContactManifold& cm);
+        CachedManifold* find(u32 id_a, u32 id_b);
+        void endFrame(u32 max_age = 0);
+        void clear();
+
+        u32 getSize()const;
+        u32 getCapacity()const;
+        u32 getFrame()const;
+        // contact points matched with previous frame by update() since last endFrame()
+        u32 getMatchedCount()const;
+    private:
+        static constexpr u64 EmptyKey_ = u64(-1);
+
+        static u64 makeKey_(u32 id_a, u32 id_b);
+        u32 calcHome_(u64 key)const;
+        // slot with key or empty slot where key belongs
+        u32 findSlot_(u64 key)const;
+        // backward shift deletion (keeps probe sequences without tombstones)
+        void removeSlot_(u32 slot);
+        void grow_();
+
+        fast_vector<CachedManifold> slots_;
+        u32 mask_;
+        u32 size_;
+        u32 frame_;
+        u32 matched_cnt_;
+    };
+
+}
+
+#include "ContactCache.inl"
+#endif //CONTACTCACHE_H
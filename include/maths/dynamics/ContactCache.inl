@@ -0,0 +1,158 @@
+#include "ContactCache.h"
+
+namespace grynca {
+
+    inline ContactCache::ContactCache(u32 initial_capacity)
+     : size_(0), frame_(0), matched_cnt_(0)
+    {
+        u32 cnt = 2;
+        while (cnt < initial_capacity)
+            cnt <<= 1;
+        mask_ = cnt-1;
+        slots_.resize(cnt);
+        for (u32 i=0; i<cnt; ++i) {
+            slots_[i].key = EmptyKey_;
+        }
+    }
+
+    inline CachedManifold& ContactCache::update(u32 id_a, u32 id_b, const ContactManifold& cm) {
+        u64 key = makeKey_(id_a, id_b);
+        ASSERT(key != EmptyKey_);
+        u32 slot = findSlot_(key);
+        if (slots_[slot].key == EmptyKey_) {
+            if (2*(size_+1) > slots_.size()) {
+                grow_();
+                slot = findSlot_(key);
+            }
+            CachedManifold& m = slots_[slot];
+            m.key = key;
+            m.size = 0;
+            ++size_;
+        }
+
+        CachedManifold& m = slots_[slot];
+        CachedContact contacts[ContactManifold::MAX_SIZE];
+        for (u32 i=0; i<cm.size; ++i) {
+            CachedContact& c = contacts[i];
+            c.feature_id = cm.points[i].feature_id;
+            c.normal_impulse = 0.0f;
+            c.tangent_impulse = 0.0f;
+            for (u32 j=0; j<m.size; ++j) {
+                const CachedContact& old = m.contacts[j];
+                if (old.feature_id != c.feature_id)
+                    continue;
+                if (c.feature_id == u32(InvalidId()) && (m.size != cm.size || i != j))
+                    continue;
+                c.normal_impulse = old.normal_impulse;
+                c.tangent_impulse = old.tangent_impulse;
+                ++matched_cnt_;
+                break;
+            }
+        }
+        m.size = cm.size;
+        memcpy(m.contacts, contacts, sizeof(CachedContact)*cm.size);
+        m.last_frame = frame_;
+        return m;
+    }
+
+    inline CachedManifold* ContactCache::find(u32 id_a, u32 id_b) {
+        u32 slot = findSlot_(makeKey_(id_a, id_b));
+        if (slots_[slot].key == EmptyKey_)
+            return NULL;
+        return &slots_[slot];
+    }
+
+    inline void ContactCache::endFrame(u32 max_age) {
+        for (u32 i=0; i<slots_.size();) {
+            CachedManifold& m = slots_[i];
+            if (m.key != EmptyKey_ && frame_ - m.last_frame > max_age) {
+                // other slot may be shifted here -> check it again
+                removeSlot_(i);
+                continue;
+            }
+            ++i;
+        }
+        ++frame_;
+        matched_cnt_ = 0;
+    }
+
+    inline void ContactCache::clear() {
+        for (u32 i=0; i<slots_.size(); ++i) {
+            slots_[i].key = EmptyKey_;
+        }
+        size_ = 0;
+        matched_cnt_ = 0;
+    }
+
+    inline u32 ContactCache::getSize()const {
+        return size_;
+    }
+
+    inline u32 ContactCache::getCapacity()const {
+        return slots_.size();
+    }
+
+    inline u32 ContactCache::getFrame()const {
+        return frame_;
+    }
+
+    inline u32 ContactCache::getMatchedCount()const {
+        return matched_cnt_;
+    }
+
+    inline u64 ContactCache::makeKey_(u32 id_a, u32 id_b) {
+        // static
+        return (u64(id_a)<<32) | id_b;
+    }
+
+    inline u32 ContactCache::calcHome_(u64 key)const {
+        // murmur3 finalizer
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ULL;
+        key ^= key >> 33;
+        return u32(key) & mask_;
+    }
+
+    inline u32 ContactCache::findSlot_(u64 key)const {
+        u32 slot = calcHome_(key);
+        while (slots_[slot].key != key && slots_[slot].key != EmptyKey_) {
+            slot = (slot+1) & mask_;
+        }
+        return slot;
+    }
+
+    inline void ContactCache::removeSlot_(u32 slot) {
+        u32 hole = slot;
+        u32 i = slot;
+        for (;;) {
+            i = (i+1) & mask_;
+            if (slots_[i].key == EmptyKey_)
+                break;
+            // entry can move to hole when its home is not (cyclically) in (hole, i]
+            u32 home = calcHome_(slots_[i].key);
+            if (((i - home) & mask_) >= ((i - hole) & mask_)) {
+                slots_[hole] = slots_[i];
+                hole = i;
+            }
+        }
+        slots_[hole].key = EmptyKey_;
+        --size_;
+    }
+
+    inline void ContactCache::grow_() {
+        fast_vector<CachedManifold> old_slots(slots_);
+        u32 cnt = 2*slots_.size();
+        mask_ = cnt-1;
+        slots_.resize(cnt);
+        for (u32 i=0; i<cnt; ++i) {
+            slots_[i].key = EmptyKey_;
+        }
+        for (u32 i=0; i<old_slots.size(); ++i) {
+            if (old_slots[i].key == EmptyKey_)
+                continue;
+            slots_[findSlot_(old_slots[i].key)] = old_slots[i];
+        }
+    }
+}
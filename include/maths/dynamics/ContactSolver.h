@@ -0,0 +1,125 @@
+#ifndef CONTACTSOLVER_H
+#define CONTACTSOLVER_H
+
+#include "../Transform.h"
+#include "../shapes/ContactManifold.h"
+#include "ContactCache.h"
+#include "Islands.h"
+
+namespace grynca {
+
+    // sequential impulses contact solver (as in Box2D)
+    //  - rigid bodies and contact constraints are stored as SoA arrays
+    //  - body origin (transform position) is its center of mass
+    //  - contacts are taken from global manifolds (OverlapHelper::calcContactG(), normal from B to A)
+    //    and warm-started from impulses of previous step (matched by feature ids in ContactCache)
+    //  - friction, restitution (above velocity threshold) and position correction (pseudo impulses after integration)
+    //  - contacts are grouped to islands which are solved independently, island resting long enough falls asleep
+    //    (sleeping bodies are not moved, contact with awake body wakes the whole island),
+    //    pairs where no body is awake (isAwake() is false for static bodies) can be skipped by narrowphase
+    class ContactSolver {
+    public:
+        struct Settings {
+            Settings();
+
+            Vec2 gravity;
+            u32 velocity_iterations;
+            u32 position_iterations;
+            bool warm_starting;
+            f32 baumgarte;              // fraction of penetration corrected per position iteration
+            f32 linear_slop;            // allowed penetration (keeps contacts persistent)
+            f32 max_correction;         // max position correction per iteration
+            f32 restitution_threshold;  // slower approaching contacts are inelastic
+            bool sleeping;
+            f32 sleep_linear_velocity;  // bodies slower than this are resting
+            f32 sleep_angular_velocity;
+            f32 time_to_sleep;          // island sleeps when all its bodies rest at least this long
+        };
+
+        // mass 0 for static body, inertia is around body origin (mass*Shape::calcInertia())
+        u32 addBody(const Transform& tr, f32 mass, f32 inertia);
+        void clear();
+
+        u32 getBodiesCount()const;
+        Transform calcTransform(u32 body_id)const;
+        const Vec2& getPosition(u32 body_id)const;
+        f32 getRotation(u32 body_id)const;
+        const Vec2& getLinearVelocity(u32 body_id)const;
+        f32 getAngularVelocity(u32 body_id)const;
+        void setLinearVelocity(u32 body_id, const Vec2& v);
+        void setAngularVelocity(u32 body_id, f32 w);     // setting velocity wakes body up
+        bool isAwake(u32 body_id)const;
+        // wakes all bodies that fell asleep together with body
+        void wakeUp(u32 body_id);
+
+        const Settings& getSettings()const;
+        Settings& accSettings();
+        const ContactCache& getContactCache()const;
+
+        // contact for next step
+        void addContact(u32 body_a, u32 body_b, const ContactManifold& cm, f32 friction = 0.5f, f32 restitution = 0.0f);
+        u32 getContactsCount()const;
+
+        // integrates velocities, solves contacts, integrates positions, corrects penetrations
+        // contacts are cleared afterwards
+        void step(f32 dt);
+
+        // islands of last step (only awake bodies)
+        const IslandBuilder& getIslands()const;
+    private:
+        void buildIslands_();
+        // islands are independent, so they could be solved in parallel
+        void solveIsland_(u32 island_id, f32 dt);
+        void initContact_(u32 i);
+        void warmStart_(u32 i);
+        void solveVelocity_(u32 i);
+        // returns separation
+        f32 solvePosition_(u32 i);
+        void storeImpulses_();
+        void updateSleeping_(f32 dt);
+        void clearContacts_();
+
+        void applyImpulse_(u32 body_a, u32 body_b, const Vec2& ra, const Vec2& rb, const Vec2& impulse);
+
+        Settings settings_;
+
+        // bodies
+        fast_vector<Vec2> positions_;
+        fast_vector<f32> rotations_;
+        fast_vector<Vec2> lin_vels_;
+        fast_vector<f32> ang_vels_;
+        fast_vector<f32> inv_masses_;
+        fast_vector<f32> inv_inertias_;
+        fast_vector<u8> awake_;
+        fast_vector<f32> sleep_times_;
+        fast_vector<u32> sleep_links_;     // circular lists of bodies that fell asleep together
+
+        // contact points
+        fast_vector<u32> bodies_a_;
+        fast_vector<u32> bodies_b_;
+        fast_vector<Vec2> points_;          // global position when added
+        fast_vector<Vec2> normals_;
+        fast_vector<f32> penetrations_;
+        fast_vector<f32> frictions_;
+        fast_vector<f32> restitutions_;
+        fast_vector<Vec2> ras_;             // from body origins to contact
+        fast_vector<Vec2> rbs_;
+        fast_vector<Vec2> local_as_;        // contact point in body frames (for position correction)
+        fast_vector<Vec2> local_bs_;
+        fast_vector<f32> normal_masses_;
+        fast_vector<f32> tangent_masses_;
+        fast_vector<f32> velocity_biases_;
+        fast_vector<f32> normal_impulses_;
+        fast_vector<f32> tangent_impulses_;
+
+        // first contact point of each manifold (+ end)
+        fast_vector<u32> manifold_starts_;
+
+        ContactCache cache_;
+        IslandBuilder islands_;
+    };
+
+}
+
+#include "ContactSolver.inl"
+#endif //CONTACTSOLVER_H
@@ -0,0 +1,370 @@
+#include "ContactSolver.h"
+
+namespace grynca {
+
+    inline ContactSolver::Settings::Settings()
+     : gravity(0, 0), velocity_iterations(8), position_iterations(3), warm_starting(true),
+       baumgarte(0.2f), linear_slop(0.05f), max_correction(2.0f), restitution_threshold(1.0f),
+       sleeping(true), sleep_linear_velocity(0.5f), sleep_angular_velocity(0.035f), time_to_sleep(0.5f)
+    {}
+
+    inline u32 ContactSolver::addBody(const Transform& tr, f32 mass, f32 inertia) {
+        u32 id = positions_.size();
+        positions_.push_back(tr.getPosition());
+        // starts from wrapped rotation (-Pi..Pi), accumulated while solving
+        rotations_.push_back(tr.getRotation().getRads());
+        lin_vels_.push_back(Vec2(0, 0));
+        ang_vels_.push_back(0.0f);
+        inv_masses_.push_back((mass > 0.0f)?1.0f/mass:0.0f);
+        inv_inertias_.push_back((mass > 0.0f && inertia > 0.0f)?1.0f/inertia:0.0f);
+        awake_.push_back(mass > 0.0f);
+        sleep_times_.push_back(0.0f);
+        sleep_links_.push_back(id);
+        return id;
+    }
+
+    inline void ContactSolver::clear() {
+        positions_.clear();
+        rotations_.clear();
+        lin_vels_.clear();
+        ang_vels_.clear();
+        inv_masses_.clear();
+        inv_inertias_.clear();
+        awake_.clear();
+        sleep_times_.clear();
+        sleep_links_.clear();
+        clearContacts_();
+        cache_.clear();
+    }
+
+    inline u32 ContactSolver::getBodiesCount()const {
+        return positions_.size();
+    }
+
+    inline Transform ContactSolver::calcTransform(u32 body_id)const {
+        return Transform(positions_[body_id], Angle(rotations_[body_id]));
+    }
+
+    inline const Vec2& ContactSolver::getPosition(u32 body_id)const {
+        return positions_[body_id];
+    }
+
+    inline f32 ContactSolver::getRotation(u32 body_id)const {
+        return rotations_[body_id];
+    }
+
+    inline const Vec2& ContactSolver::getLinearVelocity(u32 body_id)const {
+        return lin_vels_[body_id];
+    }
+
+    inline f32 ContactSolver::getAngularVelocity(u32 body_id)const {
+        return ang_vels_[body_id];
+    }
+
+    inline void ContactSolver::setLinearVelocity(u32 body_id, const Vec2& v) {
+        lin_vels_[body_id] = v;
+        wakeUp(body_id);
+    }
+
+    inline void ContactSolver::setAngularVelocity(u32 body_id, f32 w) {
+        ang_vels_[body_id] = w;
+        wakeUp(body_id);
+    }
+
+    inline bool ContactSolver::isAwake(u32 body_id)const {
+        return awake_[body_id] != 0;
+    }
+
+    inline void ContactSolver::wakeUp(u32 body_id) {
+        if (awake_[body_id] || inv_masses_[body_id] == 0.0f)
+            return;
+        u32 b = body_id;
+        do {
+            awake_[b] = 1;
+            sleep_times_[b] = 0.0f;
+            b = sleep_links_[b];
+        } while (b != body_id);
+    }
+
+    inline const ContactSolver::Settings& ContactSolver::getSettings()const {
+        return settings_;
+    }
+
+    inline ContactSolver::Settings& ContactSolver::accSettings() {
+        return settings_;
+    }
+
+    inline const ContactCache& ContactSolver::getContactCache()const {
+        return cache_;
+    }
+
+    inline void ContactSolver::addContact(u32 body_a, u32 body_b, const ContactManifold& cm, f32 friction, f32 restitution) {
+        ASSERT(body_a < getBodiesCount() && body_b < getBodiesCount());
+        if (!cm.size)
+            return;
+        if (manifold_starts_.empty())
+            manifold_starts_.push_back(0);
+
+        const CachedManifold& cached = cache_.update(body_a, body_b, cm);
+        for (u32 i=0; i<cm.size; ++i) {
+            bodies_a_.push_back(body_a);
+            bodies_b_.push_back(body_b);
+            points_.push_back(cm.points[i].position);
+            normals_.push_back(cm.normal);
+            penetrations_.push_back(cm.points[i].penetration);
+            frictions_.push_back(friction);
+            restitutions_.push_back(restitution);
+            normal_impulses_.push_back(settings_.warm_starting?cached.contacts[i].normal_impulse:0.0f);
+            tangent_impulses_.push_back(settings_.warm_starting?cached.contacts[i].tangent_impulse:0.0f);
+        }
+        manifold_starts_.push_back(bodies_a_.size());
+    }
+
+    inline u32 ContactSolver::getContactsCount()const {
+        return bodies_a_.size();
+    }
+
+    inline void ContactSolver::step(f32 dt) {
+        PROFILE_BLOCK("ContactSolver::step()");
+        buildIslands_();
+        for (u32 i=0; i<islands_.getIslandsCount(); ++i) {
+            solveIsland_(i, dt);
+        }
+        storeImpulses_();
+        if (settings_.sleeping)
+            updateSleeping_(dt);
+
+        cache_.endFrame();
+        clearContacts_();
+    }
+
+    inline const IslandBuilder& ContactSolver::getIslands()const {
+        return islands_;
+    }
+
+    inline void ContactSolver::buildIslands_() {
+        if (!settings_.sleeping) {
+            for (u32 i=0; i<getBodiesCount(); ++i) {
+                wakeUp(i);
+            }
+        }
+
+        // wake on touch (repeated, woken body may touch other sleeping ones)
+        bool woken = true;
+        while (woken) {
+            woken = false;
+            for (u32 m=0; m+1<manifold_starts_.size(); ++m) {
+                u32 a = bodies_a_[manifold_starts_[m]];
+                u32 b = bodies_b_[manifold_starts_[m]];
+                if (awake_[a] == awake_[b])
+                    continue;
+                woken |= (!awake_[a] && inv_masses_[a] > 0.0f) || (!awake_[b] && inv_masses_[b] > 0.0f);
+                wakeUp(a);
+                wakeUp(b);
+            }
+        }
+
+        islands_.reset(getBodiesCount());
+        for (u32 m=0; m+1<manifold_starts_.size(); ++m) {
+            u32 a = bodies_a_[manifold_starts_[m]];
+            u32 b = bodies_b_[manifold_starts_[m]];
+            islands_.addPair((inv_masses_[a] > 0.0f)?a:u32(InvalidId()), (inv_masses_[b] > 0.0f)?b:u32(InvalidId()));
+        }
+        islands_.build(awake_.begin());
+
+        u32 cnt = getContactsCount();
+        ras_.resize(cnt);
+        rbs_.resize(cnt);
+        local_as_.resize(cnt);
+        local_bs_.resize(cnt);
+        normal_masses_.resize(cnt);
+        tangent_masses_.resize(cnt);
+        velocity_biases_.resize(cnt);
+    }
+
+    inline void ContactSolver::solveIsland_(u32 island_id, f32 dt) {
+        u32 bodies_cnt, manifolds_cnt;
+        const u32* bodies = islands_.getIslandBodies(island_id, bodies_cnt);
+        const u32* manifolds = islands_.getIslandPairs(island_id, manifolds_cnt);
+
+        // integrate velocities
+        for (u32 i=0; i<bodies_cnt; ++i) {
+            lin_vels_[bodies[i]] += settings_.gravity*dt;
+        }
+
+        for (u32 m=0; m<manifolds_cnt; ++m) {
+            for (u32 i=manifold_starts_[manifolds[m]]; i<manifold_starts_[manifolds[m]+1]; ++i) {
+                initContact_(i);
+                if (settings_.warm_starting)
+                    warmStart_(i);
+            }
+        }
+        for (u32 it=0; it<settings_.velocity_iterations; ++it) {
+            for (u32 m=0; m<manifolds_cnt; ++m) {
+                for (u32 i=manifold_starts_[manifolds[m]]; i<manifold_starts_[manifolds[m]+1]; ++i) {
+                    solveVelocity_(i);
+                }
+            }
+        }
+
+        // integrate positions
+        for (u32 i=0; i<bodies_cnt; ++i) {
+            positions_[bodies[i]] += lin_vels_[bodies[i]]*dt;
+            rotations_[bodies[i]] += ang_vels_[bodies[i]]*dt;
+        }
+
+        for (u32 it=0; it<settings_.position_iterations; ++it) {
+            f32 max_penetration = 0.0f;
+            for (u32 m=0; m<manifolds_cnt; ++m) {
+                for (u32 i=manifold_starts_[manifolds[m]]; i<manifold_starts_[manifolds[m]+1]; ++i) {
+                    max_penetration = std::max(max_penetration, -solvePosition_(i));
+                }
+            }
+            if (max_penetration <= 3.0f*settings_.linear_slop)
+                break;
+        }
+    }
+
+    inline void ContactSolver::initContact_(u32 i) {
+        u32 a = bodies_a_[i];
+        u32 b = bodies_b_[i];
+        const Vec2& n = normals_[i];
+        Vec2 t = n.perpR();
+        // point on A and on B (normal goes from B to A)
+        Vec2 pt_a = points_[i];
+        Vec2 pt_b = points_[i] + n*penetrations_[i];
+        Vec2 ra = pt_a - positions_[a];
+        Vec2 rb = pt_b - positions_[b];
+        ras_[i] = ra;
+        rbs_[i] = rb;
+        local_as_[i] = ra.rotateInverse(Angle(rotations_[a]).getDir());
+        local_bs_[i] = rb.rotateInverse(Angle(rotations_[b]).getDir());
+
+        f32 ma = inv_masses_[a], mb = inv_masses_[b];
+        f32 ia = inv_inertias_[a], ib = inv_inertias_[b];
+        f32 rna = cross(ra, n), rnb = cross(rb, n);
+        f32 kn = ma + mb + ia*rna*rna + ib*rnb*rnb;
+        normal_masses_[i] = (kn > 0.0f)?1.0f/kn:0.0f;
+        f32 rta = cross(ra, t), rtb = cross(rb, t);
+        f32 kt = ma + mb + ia*rta*rta + ib*rtb*rtb;
+        tangent_masses_[i] = (kt > 0.0f)?1.0f/kt:0.0f;
+
+        // restitution
+        Vec2 dv = lin_vels_[a] + cross(ang_vels_[a], ra) - lin_vels_[b] - cross(ang_vels_[b], rb);
+        f32 vn = dot(dv, n);
+        velocity_biases_[i] = (vn < -settings_.restitution_threshold)?-restitutions_[i]*vn:0.0f;
+    }
+
+    inline void ContactSolver::warmStart_(u32 i) {
+        const Vec2& n = normals_[i];
+        Vec2 impulse = n*normal_impulses_[i] + n.perpR()*tangent_impulses_[i];
+        applyImpulse_(bodies_a_[i], bodies_b_[i], ras_[i], rbs_[i], impulse);
+    }
+
+    inline void ContactSolver::solveVelocity_(u32 i) {
+        u32 a = bodies_a_[i];
+        u32 b = bodies_b_[i];
+        const Vec2& ra = ras_[i];
+        const Vec2& rb = rbs_[i];
+        const Vec2& n = normals_[i];
+        Vec2 t = n.perpR();
+
+        // friction first (normal impulse is more important)
+        Vec2 dv = lin_vels_[a] + cross(ang_vels_[a], ra) - lin_vels_[b] - cross(ang_vels_[b], rb);
+        f32 max_friction = frictions_[i]*normal_impulses_[i];
+        f32 old_impulse = tangent_impulses_[i];
+        f32 new_impulse = std::max(-max_friction, std::min(old_impulse - tangent_masses_[i]*dot(dv, t), max_friction));
+        tangent_impulses_[i] = new_impulse;
+        applyImpulse_(a, b, ra, rb, t*(new_impulse - old_impulse));
+
+        dv = lin_vels_[a] + cross(ang_vels_[a], ra) - lin_vels_[b] - cross(ang_vels_[b], rb);
+        old_impulse = normal_impulses_[i];
+        new_impulse = std::max(old_impulse - normal_masses_[i]*(dot(dv, n) - velocity_biases_[i]), 0.0f);
+        normal_impulses_[i] = new_impulse;
+        applyImpulse_(a, b, ra, rb, n*(new_impulse - old_impulse));
+    }
+
+    inline void ContactSolver::storeImpulses_() {
+        for (u32 m=0; m+1<manifold_starts_.size(); ++m) {
+            u32 start = manifold_starts_[m];
+            CachedManifold* cached = cache_.find(bodies_a_[start], bodies_b_[start]);
+            ASSERT(cached && cached->size == manifold_starts_[m+1] - start);
+            for (u32 i=0; i<cached->size; ++i) {
+                cached->contacts[i].normal_impulse = normal_impulses_[start+i];
+                cached->contacts[i].tangent_impulse = tangent_impulses_[start+i];
+            }
+        }
+    }
+
+    inline f32 ContactSolver::solvePosition_(u32 i) {
+        u32 a = bodies_a_[i];
+        u32 b = bodies_b_[i];
+        const Vec2& n = normals_[i];
+        Vec2 ra = local_as_[i].rotate(Angle(rotations_[a]).getDir());
+        Vec2 rb = local_bs_[i].rotate(Angle(rotations_[b]).getDir());
+        // separation of contact points along normal (negative when penetrating)
+        f32 separation = dot((positions_[a] + ra) - (positions_[b] + rb), n);
+
+        f32 c = std::max(-settings_.max_correction, std::min(settings_.baumgarte*(separation + settings_.linear_slop), 0.0f));
+        f32 ma = inv_masses_[a], mb = inv_masses_[b];
+        f32 ia = inv_inertias_[a], ib = inv_inertias_[b];
+        f32 rna = cross(ra, n), rnb = cross(rb, n);
+        f32 k = ma + mb + ia*rna*rna + ib*rnb*rnb;
+        if (k <= 0.0f)
+            return separation;
+        Vec2 impulse = n*(-c/k);
+        positions_[a] += impulse*ma;
+        rotations_[a] += ia*cross(ra, impulse);
+        positions_[b] -= impulse*mb;
+        rotations_[b] -= ib*cross(rb, impulse);
+        return separation;
+    }
+
+    inline void ContactSolver::updateSleeping_(f32 dt) {
+        f32 lin_tol_sqr = settings_.sleep_linear_velocity*settings_.sleep_linear_velocity;
+        f32 ang_tol = settings_.sleep_angular_velocity;
+        for (u32 isl=0; isl<islands_.getIslandsCount(); ++isl) {
+            u32 bodies_cnt;
+            const u32* bodies = islands_.getIslandBodies(isl, bodies_cnt);
+            f32 min_sleep_time = std::numeric_limits<f32>::max();
+            for (u32 i=0; i<bodies_cnt; ++i) {
+                u32 b = bodies[i];
+                if (lin_vels_[b].getSqrLen() > lin_tol_sqr || fabsf(ang_vels_[b]) > ang_tol)
+                    sleep_times_[b] = 0.0f;
+                else
+                    sleep_times_[b] += dt;
+                min_sleep_time = std::min(min_sleep_time, sleep_times_[b]);
+            }
+
+            if (min_sleep_time < settings_.time_to_sleep)
+                continue;
+            for (u32 i=0; i<bodies_cnt; ++i) {
+                u32 b = bodies[i];
+                awake_[b] = 0;
+                lin_vels_[b] = Vec2(0, 0);
+                ang_vels_[b] = 0.0f;
+                sleep_links_[b] = bodies[(i+1)%bodies_cnt];
+            }
+        }
+    }
+
+    inline void ContactSolver::clearContacts_() {
+        bodies_a_.clear();
+        bodies_b_.clear();
+        points_.clear();
+        normals_.clear();
+        penetrations_.clear();
+        frictions_.clear();
+        restitutions_.clear();
+        normal_impulses_.clear();
+        tangent_impulses_.clear();
+        manifold_starts_.clear();
+    }
+
+    inline void ContactSolver::applyImpulse_(u32 body_a, u32 body_b, const Vec2& ra, const Vec2& rb, const Vec2& impulse) {
+        lin_vels_[body_a] += impulse*inv_masses_[body_a];
+        ang_vels_[body_a] += inv_inertias_[body_a]*cross(ra, impulse);
+        lin_vels_[body_b] -= impulse*inv_masses_[body_b];
+        ang_vels_[body_b] -= inv_inertias_[body_b]*cross(rb, impulse);
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef ISLANDS_H
+#define ISLANDS_H
+
+#include "functions/defs.h"
+#include "types/containers/fast_vector.h"
+
+namespace grynca {
+
+    // groups bodies connected by contact pairs to islands (union-find with path halving and union by size)
+    //  - static bodies do not connect islands (pass InvalidId() instead of their id)
+    //  - islands do not interact, so they can be solved independently (or put to sleep as a whole)
+    //  - after build() bodies and pairs of each island are stored contiguously
+    class IslandBuilder {
+    public:
+        // each body in its own island, no pairs
+        void reset(u32 bodies_count);
+        // returns pair id (order of adding)
+        u32 addPair(u32 body_a, u32 body_b);
+        u32 findRoot(u32 body_id);
+
+        // only bodies with nonzero include flag get to islands (e.g. skips static and sleeping bodies),
+        // pairs without included body are left out
+        void build(const u8* include);
+
+        u32 getIslandsCount()const;
+        // InvalidId() for left out body
+        u32 getIsland(u32 body_id)const;
+        const u32* getIslandBodies(u32 island_id, u32& count_out)const;
+        const u32* getIslandPairs(u32 island_id, u32& count_out)const;
+    private:
+        void union_(u32 body_a, u32 body_b);
+
+        fast_vector<u32> parents_;
+        fast_vector<u32> sizes_;
+        fast_vector<u32> pairs_a_;
+        fast_vector<u32> pairs_b_;
+
+        fast_vector<u32> body_islands_;
+        fast_vector<u32> root_islands_;
+        // ids grouped by islands, with start of each island (+ end)
+        fast_vector<u32> bodies_;
+        fast_vector<u32> body_starts_;
+        fast_vector<u32> pairs_;
+        fast_vector<u32> pair_starts_;
+    };
+
+}
+
+#include "Islands.inl"
+#endif //ISLANDS_H
@@ -0,0 +1,130 @@
+#include "Islands.h"
+
+namespace grynca {
+
+    inline void IslandBuilder::reset(u32 bodies_count) {
+        parents_.resize(bodies_count);
+        sizes_.resize(bodies_count);
+        for (u32 i=0; i<bodies_count; ++i) {
+            parents_[i] = i;
+            sizes_[i] = 1;
+        }
+        pairs_a_.clear();
+        pairs_b_.clear();
+        body_islands_.clear();
+        bodies_.clear();
+        body_starts_.clear();
+        pairs_.clear();
+        pair_starts_.clear();
+    }
+
+    inline u32 IslandBuilder::addPair(u32 body_a, u32 body_b) {
+        ASSERT(body_a != u32(InvalidId()) || body_b != u32(InvalidId()));
+        if (body_a != u32(InvalidId()) && body_b != u32(InvalidId()))
+            union_(body_a, body_b);
+        pairs_a_.push_back(body_a);
+        pairs_b_.push_back(body_b);
+        return pairs_a_.size()-1;
+    }
+
+    inline u32 IslandBuilder::findRoot(u32 body_id) {
+        while (parents_[body_id] != body_id) {
+            // path halving
+            parents_[body_id] = parents_[parents_[body_id]];
+            body_id = parents_[body_id];
+        }
+        return body_id;
+    }
+
+    inline void IslandBuilder::build(const u8* include) {
+        u32 bodies_cnt = parents_.size();
+        body_islands_.resize(bodies_cnt);
+        root_islands_.resize(bodies_cnt);
+        for (u32 i=0; i<bodies_cnt; ++i) {
+            root_islands_[i] = InvalidId();
+        }
+
+        // number islands & count their bodies
+        body_starts_.clear();
+        body_starts_.push_back(0);
+        for (u32 i=0; i<bodies_cnt; ++i) {
+            if (!include[i]) {
+                body_islands_[i] = InvalidId();
+                continue;
+            }
+            u32 root = findRoot(i);
+            if (root_islands_[root] == u32(InvalidId())) {
+                root_islands_[root] = body_starts_.size()-1;
+                body_starts_.push_back(0);
+            }
+            u32 island_id = root_islands_[root];
+            body_islands_[i] = island_id;
+            ++body_starts_[island_id+1];
+        }
+        u32 islands_cnt = getIslandsCount();
+        for (u32 i=0; i<islands_cnt; ++i) {
+            body_starts_[i+1] += body_starts_[i];
+        }
+
+        // counting sort of bodies (root_islands_ reused as write positions)
+        bodies_.resize(body_starts_[islands_cnt]);
+        for (u32 i=0; i<islands_cnt; ++i) {
+            root_islands_[i] = body_starts_[i];
+        }
+        for (u32 i=0; i<bodies_cnt; ++i) {
+            if (body_islands_[i] != u32(InvalidId()))
+                bodies_[root_islands_[body_islands_[i]]++] = i;
+        }
+
+        // same for pairs
+        pair_starts_.resize(islands_cnt+1);
+        for (u32 i=0; i<=islands_cnt; ++i) {
+            pair_starts_[i] = 0;
+        }
+        for (u32 p=0; p<pairs_a_.size(); ++p) {
+            u32 island_id = getIsland((pairs_a_[p] != u32(InvalidId()))?pairs_a_[p]:pairs_b_[p]);
+            if (island_id != u32(InvalidId()))
+                ++pair_starts_[island_id+1];
+        }
+        for (u32 i=0; i<islands_cnt; ++i) {
+            pair_starts_[i+1] += pair_starts_[i];
+            root_islands_[i] = pair_starts_[i];
+        }
+        pairs_.resize(pair_starts_[islands_cnt]);
+        for (u32 p=0; p<pairs_a_.size(); ++p) {
+            u32 island_id = getIsland((pairs_a_[p] != u32(InvalidId()))?pairs_a_[p]:pairs_b_[p]);
+            if (island_id != u32(InvalidId()))
+                pairs_[root_islands_[island_id]++] = p;
+        }
+    }
+
+    inline u32 IslandBuilder::getIslandsCount()const {
+        return body_starts_.empty()?0:body_starts_.size()-1;
+    }
+
+    inline u32 IslandBuilder::getIsland(u32 body_id)const {
+        return body_islands_[body_id];
+    }
+
+    inline const u32* IslandBuilder::getIslandBodies(u32 island_id, u32& count_out)const {
+        count_out = body_starts_[island_id+1] - body_starts_[island_id];
+        return bodies_.begin() + body_starts_[island_id];
+    }
+
+    inline const u32* IslandBuilder::getIslandPairs(u32 island_id, u32& count_out)const {
+        count_out = pair_starts_[island_id+1] - pair_starts_[island_id];
+        return pairs_.begin() + pair_starts_[island_id];
+    }
+
+    inline void IslandBuilder::union_(u32 body_a, u32 body_b) {
+        u32 ra = findRoot(body_a);
+        u32 rb = findRoot(body_b);
+        if (ra == rb)
+            return;
+        // smaller tree goes under larger one
+        if (sizes_[ra] < sizes_[rb])
+            std::swap(ra, rb);
+        parents_[rb] = ra;
+        sizes_[ra] += sizes_[rb];
+    }
+}
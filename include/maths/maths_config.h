@@ -7,8 +7,50 @@
 #ifndef MATHS_GJK_MAX_ITERATIONS
 #   define MATHS_GJK_MAX_ITERATIONS 32
 #endif
+// GJK/EPA support search starts from previous support vertex of each shape and walks neighbours
+// (off by default: GJK directions jump too much, SIMD full search is faster for pgons up to MATHS_MAX_PGON_SIZE)
+#ifndef MATHS_GJK_HILL_CLIMBING
+#   define MATHS_GJK_HILL_CLIMBING 0
+#endif
+#ifndef MATHS_PGON_MAX_CLIMB_STEPS
+#   define MATHS_PGON_MAX_CLIMB_STEPS 6
+#endif
+// Pgon points & normals stored inline (MATHS_MAX_PGON_SIZE capacity) instead of in heap allocated fast_vectors
+// (Pgon is then trivially copyable, but every Shape grows to its size)
+#ifndef MATHS_PGON_INLINE_STORAGE
+#   define MATHS_PGON_INLINE_STORAGE 0
+#endif
+// support point search uses SIMD packets for point sets at least this big
+#ifndef MATHS_SIMD_SUPPORT_MIN_POINTS
+#   define MATHS_SIMD_SUPPORT_MIN_POINTS 8
+#endif
+// point transforms & bounds use SIMD packets for point sets at least this big
+#ifndef MATHS_SIMD_TRANSFORM_MIN_POINTS
+#   define MATHS_SIMD_TRANSFORM_MIN_POINTS 4
+#endif
+// accuracy tier of sin/cos/atan2 used by Angle, Vec2::getAngle & Transform (see trig_funcs.h)
+//  0: libm, 1: fast polynomials (~1e-5), 2: precise polynomials (~1e-6)
+#ifndef MATHS_TRIG_ACCURACY
+#   ifdef USE_FAST_SIN
+#       define MATHS_TRIG_ACCURACY 1
+#   else
+#       define MATHS_TRIG_ACCURACY 0
+#   endif
+#endif
+// EPA polytope size (max iterations + 3)
 #ifndef MATHS_EPA_MAX_EDGES
-#   define MATHS_EPA_MAX_EDGES 32
+#   define MATHS_EPA_MAX_EDGES 64
+#endif
+// default distance tolerance for EPA termination
+#ifndef MATHS_EPA_TOLERANCE
+#   define MATHS_EPA_TOLERANCE 0.001f
+#endif
+// TOIHelper: distance considered as contact & conservative advancement steps limit
+#ifndef MATHS_TOI_TOLERANCE
+#   define MATHS_TOI_TOLERANCE 0.01f
+#endif
+#ifndef MATHS_TOI_MAX_ITERATIONS
+#   define MATHS_TOI_MAX_ITERATIONS 32
 #endif
 
 #endif //MATHS_CONFIG_H
@@ -1,7 +1,11 @@
 #ifndef MATHS_FUNCS_H
 #define MATHS_FUNCS_H
 
-#include "Vec2.h"
+#include "maths_config.h"
+#include "Vec2xN.h"
+#ifdef _MSC_VER
+#   include <intrin.h>
+#endif
 
 namespace grynca {
     namespace maths {
@@ -30,8 +34,8 @@ namespace grynca {
             return dot(pt-line_pt, line_normal);
         }
 
-        // returns point id
-        inline static u32 calcSupport(const Vec2* points, u32 points_cnt, const Dir2& dir) {
+        // returns point id (first one of equally good points)
+        inline static u32 calcSupportScalar(const Vec2* points, u32 points_cnt, const Dir2& dir) {
             ASSERT(points_cnt != 0);
 
             u32 best_id = 0;
@@ -46,8 +50,7 @@ namespace grynca {
             return best_id;
         }
 
-        // calcs also worst-id (support in negative dir)
-        inline static void calcSupportBestWorst(Vec2* points, u32 points_cnt, const Dir2& dir, u32& best_id, u32& worst_id) {
+        inline static void calcSupportBestWorstScalar(const Vec2* points, u32 points_cnt, const Dir2& dir, u32& best_id, u32& worst_id) {
             ASSERT(points_cnt != 0);
 
             best_id = 0;
@@ -68,6 +71,157 @@ namespace grynca {
             }
         }
 
+        // index of first occurrence of val (must be present), cnt <= 64
+        template <typename F>
+        inline u32 findFirstEqual_(const f32* vals, u32 cnt, u32 packets_end, f32 val) {
+            // branchless over packets, mispredicted early exit costs more than few compares
+            F v(val);
+            u64 mask = 0;
+            for (u32 i=0; i<packets_end; i+=F::Width) {
+                mask |= u64(getMask(F::load(vals+i) == v))<<i;
+            }
+            for (u32 i=packets_end; i<cnt; ++i) {
+                mask |= u64(vals[i] == val)<<i;
+            }
+            ASSERT_M(mask, "value must be present");
+#ifdef _MSC_VER
+            unsigned long id;
+            _BitScanForward64(&id, mask);
+            return u32(id);
+#else
+            return u32(__builtin_ctzll(mask));
+#endif
+        }
+
+        // projects F::Width points at once and tracks best projection per lane,
+        // second pass finds first point with best projection (same result as scalar search)
+        template <typename F, bool CalcWorst>
+        inline void calcSupportPackets(const Vec2* points, u32 points_cnt, const Dir2& dir, u32& best_id, u32& worst_id) {
+            static constexpr u32 BlockSize = 64;
+            static constexpr u32 W = F::Width;
+            ASSERT(points_cnt >= W);
+
+            Vec2xN<F> d(dir);
+            f32 projs[BlockSize];
+            f32 best = 0.0f, worst = 0.0f;
+            // blocks of points, last block shorter than W overlaps previous one
+            // (overlapped points are not better than best so far, so first best id is kept)
+            for (u32 first=0; first<points_cnt; first+=BlockSize) {
+                u32 cnt = std::min(BlockSize, points_cnt-first);
+                if (cnt < W) {
+                    first = points_cnt-W;
+                    cnt = W;
+                }
+                u32 packets_end = cnt - cnt%W;
+                const Vec2* pts = points+first;
+
+                F best_p = dot(Vec2xN<F>::load(pts), d);
+                F worst_p = best_p;
+                best_p.store(projs);
+                for (u32 i=W; i<packets_end; i+=W) {
+                    F proj = dot(Vec2xN<F>::load(pts+i), d);
+                    proj.store(projs+i);
+                    best_p = max(best_p, proj);
+                    if (CalcWorst)
+                        worst_p = min(worst_p, proj);
+                }
+
+                f32 lanes[W];
+                best_p.store(lanes);
+                f32 block_best = lanes[0];
+                for (u32 l=1; l<W; ++l)
+                    block_best = std::max(block_best, lanes[l]);
+                f32 block_worst = 0.0f;
+                if (CalcWorst) {
+                    worst_p.store(lanes);
+                    block_worst = lanes[0];
+                    for (u32 l=1; l<W; ++l)
+                        block_worst = std::min(block_worst, lanes[l]);
+                }
+                for (u32 i=packets_end; i<cnt; ++i) {
+                    projs[i] = dot(pts[i], dir);
+                    block_best = std::max(block_best, projs[i]);
+                    if (CalcWorst)
+                        block_worst = std::min(block_worst, projs[i]);
+                }
+
+                if (first == 0 || block_best > best) {
+                    best = block_best;
+                    best_id = first + findFirstEqual_<F>(projs, cnt, packets_end, block_best);
+                }
+                if (CalcWorst && (first == 0 || block_worst < worst)) {
+                    worst = block_worst;
+                    worst_id = first + findFirstEqual_<F>(projs, cnt, packets_end, block_worst);
+                }
+            }
+        }
+
+        // returns point id (first one of equally good points)
+        inline static u32 calcSupport(const Vec2* points, u32 points_cnt, const Dir2& dir) {
+#if MATHS_SIMD_SSE
+            if (points_cnt >= MATHS_SIMD_SUPPORT_MIN_POINTS && points_cnt >= F32xN::Width) {
+                u32 best_id, worst_id;
+                calcSupportPackets<F32xN, false>(points, points_cnt, dir, best_id, worst_id);
+                return best_id;
+            }
+#endif
+            return calcSupportScalar(points, points_cnt, dir);
+        }
+
+        // calcs also worst-id (support in negative dir)
+        inline static void calcSupportBestWorst(const Vec2* points, u32 points_cnt, const Dir2& dir, u32& best_id, u32& worst_id) {
+#if MATHS_SIMD_SSE
+            if (points_cnt >= MATHS_SIMD_SUPPORT_MIN_POINTS && points_cnt >= F32xN::Width) {
+                calcSupportPackets<F32xN, true>(points, points_cnt, dir, best_id, worst_id);
+                return;
+            }
+#endif
+            calcSupportBestWorstScalar(points, points_cnt, dir, best_id, worst_id);
+        }
+
+        // points_cnt >= F::Width, last packet may overlap previous one
+        template <typename F>
+        inline void calcBoundPackets(const Vec2* points, u32 points_cnt, Vec2& min_out, Vec2& max_out) {
+            static constexpr u32 W = F::Width;
+            ASSERT(points_cnt >= W);
+
+            Vec2xN<F> bmin = Vec2xN<F>::load(points+points_cnt-W);
+            Vec2xN<F> bmax = bmin;
+            for (u32 i=0; i+W<points_cnt; i+=W) {
+                Vec2xN<F> p = Vec2xN<F>::load(points+i);
+                bmin = min(bmin, p);
+                bmax = max(bmax, p);
+            }
+
+            min_out = bmin.get(0);
+            max_out = bmax.get(0);
+            for (u32 l=1; l<W; ++l) {
+                Vec2 lmin = bmin.get(l), lmax = bmax.get(l);
+                min_out.set(std::min(min_out.getX(), lmin.getX()), std::min(min_out.getY(), lmin.getY()));
+                max_out.set(std::max(max_out.getX(), lmax.getX()), std::max(max_out.getY(), lmax.getY()));
+            }
+        }
+
+        // min & max coords of points (points_cnt > 0)
+        inline static void calcBound(const Vec2* points, u32 points_cnt, Vec2& min_out, Vec2& max_out) {
+            ASSERT(points_cnt != 0);
+#if MATHS_SIMD_SSE
+            if (points_cnt >= MATHS_SIMD_TRANSFORM_MIN_POINTS && points_cnt >= F32x4::Width) {
+                if (points_cnt >= F32xN::Width)
+                    calcBoundPackets<F32xN>(points, points_cnt, min_out, max_out);
+                else
+                    calcBoundPackets<F32x4>(points, points_cnt, min_out, max_out);
+                return;
+            }
+#endif
+            min_out = max_out = points[0];
+            for (u32 i=1; i<points_cnt; ++i) {
+                const Vec2& p = points[i];
+                min_out.set(std::min(min_out.getX(), p.getX()), std::min(min_out.getY(), p.getY()));
+                max_out.set(std::max(max_out.getX(), p.getX()), std::max(max_out.getY(), p.getY()));
+            }
+        }
+
         // v1 & v2 are two vectors of triangle sharing vertex
         // for positive result v1 -> v2 must be clockwise rotation
         inline static f32 calcTriangleArea(const Vec2& v1, const Vec2& v2) {
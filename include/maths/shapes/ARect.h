@@ -40,6 +40,7 @@ namespace grynca {
 
         void expand(const ARect& r);
         void expand(const ARect& r, bool& expanded_out);
+        static ARect combine(const ARect& r1, const ARect& r2);     // bound of both rects
 
         ARect calcARectBound()const;
         ARect calcRotInvBound()const;
@@ -47,15 +48,18 @@ namespace grynca {
         // changes "this"
         // (if transform contains rotation, it will change ARect size to contain its rotated version)
         void transform(const Mat3& tr);
+        void transform(const Affine2& tr);
         void transform(const Transform& tr);
         void transformWithoutRotation(const Transform& tr);
 
         // this changes ARect to Rect, possibly rotated
         Rect transformOut(const Mat3& tr)const;
+        Rect transformOut(const Affine2& tr)const;
         Rect transformOut(const Transform& tr)const;
 
         Vec2 calcSupport(const Dir2& dir)const;
         Vec2 calcSupport(const Dir2& dir, u32& pt_id_out)const;
+        Vec2 calcSupportFrom(const Dir2& dir, u32& pt_id_io)const;     // same as calcSupport(), for GJK
 
         Vec2 getPoint(u32 pt_id)const;
         u32 wrapPointId(u32 pt_id)const;
@@ -63,10 +67,14 @@ namespace grynca {
         Dir2 getEdgeDir(u32 pt_id)const;
 
         bool isPointInside(const Vec2& p)const;
+        bool contains(const ARect& r)const;
+        // inclusive bounds test (no eps, no OverlapTmp), intended for broadphases
+        bool intersects(const ARect& r)const;
 
         Circle calcCircleBound()const;
 
         f32 calcArea()const;
+        f32 calcPerimeter()const;
         f32 calcInertia()const;
 
         template <typename ShapeT>
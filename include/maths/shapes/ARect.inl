@@ -1,5 +1,6 @@
 #include "shapes_h.h"
 #include "../Transform.h"
+#include "../maths_funcs.h"
 #include "OverlapTmp.h"
 #include "ContactManifold.h"
 
@@ -17,25 +18,7 @@ namespace grynca {
 
     inline ARect::ARect(const Vec2* points, u32 points_cnt) {
         ASSERT(points_cnt > 0);
-
-        bounds_[0] = bounds_[1] = points[0];
-
-        for (u32 i=1; i<points_cnt; ++i) {
-            const Vec2& p = points[i];
-            if (p.getX() < bounds_[0].getX()) {
-                bounds_[0].setX(p.getX());
-            }
-            else if (p.getX() > bounds_[1].getX()) {
-                bounds_[1].setX(p.getX());
-            }
-
-            if (p.getY() < bounds_[0].getY()) {
-                bounds_[0].setY(p.getY());
-            }
-            else if (p.getY() > bounds_[1].getY()) {
-                bounds_[1].setY(p.getY());
-            }
-        }
+        maths::calcBound(points, points_cnt, bounds_[0], bounds_[1]);
     }
 
     inline ARect ARect::createCentered(const Vec2& size) {
@@ -144,6 +127,14 @@ namespace grynca {
         }
     }
 
+    inline ARect ARect::combine(const ARect& r1, const ARect& r2) {
+    // static
+        ARect rslt;
+        rslt.bounds_[0].set(std::min(r1.bounds_[0].getX(), r2.bounds_[0].getX()), std::min(r1.bounds_[0].getY(), r2.bounds_[0].getY()));
+        rslt.bounds_[1].set(std::max(r1.bounds_[1].getX(), r2.bounds_[1].getX()), std::max(r1.bounds_[1].getY(), r2.bounds_[1].getY()));
+        return rslt;
+    }
+
     inline ARect ARect::calcARectBound()const {
         return *this;
     }
@@ -158,13 +149,12 @@ namespace grynca {
 
 
     inline void ARect::transform(const Mat3& tr) {
-        Vec2 pts[4] = {
-                tr * getLeftTop(),
-                tr * getRightTop(),
-                tr * getRightBot(),
-                tr * getLeftBot()
-        };
-        *this = ARect(&pts[0], 4);
+        transform(Affine2(tr));
+    }
+
+    inline void ARect::transform(const Affine2& tr) {
+        Vec2 pts[4] = {getLeftTop(), getRightTop(), getRightBot(), getLeftBot()};
+        tr.transformPoints(pts, 4, pts, bounds_[0], bounds_[1]);
     }
 
     inline void ARect::transform(const Transform& tr) {
@@ -194,9 +184,13 @@ namespace grynca {
         return transformOut(Transform(tr));
     }
 
+    inline Rect ARect::transformOut(const Affine2& tr)const {
+        return transformOut(Transform(tr));
+    }
+
     inline Rect ARect::transformOut(const Transform& tr)const {
         Vec2 offset(getLeftTop());
-        return Rect(tr.getPosition(), getSize()*tr.getScale(), offset*tr.getScale(), tr.getRotation(), tr.getRotDir());
+        return Rect(tr.getPosition(), getSize()*tr.getScale(), offset*tr.getScale(), tr.getRotDir());
     }
 
     inline Vec2 ARect::calcSupport(const Dir2& dir)const {
@@ -224,6 +218,10 @@ namespace grynca {
         return getLeftTop();
     }
 
+    inline Vec2 ARect::calcSupportFrom(const Dir2& dir, u32& pt_id_io)const {
+        return calcSupport(dir, pt_id_io);
+    }
+
     inline Vec2 ARect::getPoint(u32 pt_id)const {
         switch (pt_id) {
             case 0: return getLeftTop();
@@ -266,6 +264,20 @@ namespace grynca {
 
     }
 
+    inline bool ARect::contains(const ARect& r)const {
+        return bounds_[0].getX() <= r.bounds_[0].getX()
+               && bounds_[0].getY() <= r.bounds_[0].getY()
+               && r.bounds_[1].getX() <= bounds_[1].getX()
+               && r.bounds_[1].getY() <= bounds_[1].getY();
+    }
+
+    inline bool ARect::intersects(const ARect& r)const {
+        return bounds_[0].getX() <= r.bounds_[1].getX()
+               && r.bounds_[0].getX() <= bounds_[1].getX()
+               && bounds_[0].getY() <= r.bounds_[1].getY()
+               && r.bounds_[0].getY() <= bounds_[1].getY();
+    }
+
     inline Circle ARect::calcCircleBound()const {
         Vec2 hs = getSize()*0.5f;
         return Circle(getLeftTop()+hs, hs.getLen());
@@ -276,6 +288,11 @@ namespace grynca {
         return s.getX()*s.getY();
     }
 
+    inline f32 ARect::calcPerimeter()const {
+        Vec2 s = getSize();
+        return 2*(s.getX() + s.getY());
+    }
+
     inline f32 ARect::calcInertia()const {
         const Vec2& offset = getLeftTop();
         Vec2 size = getSize();
@@ -372,23 +389,23 @@ namespace grynca {
     }
 
     inline bool ARect::overlaps(const Circle& c, OverlapTmp& otmp)const {
-        otmp.arect_circle_.r_halfe = getSize()*0.5f;
+        Vec2 r_halfe = getSize()*0.5f;
         otmp.arect_circle_.v = c.getCenter()-getCenter();
         // clamp to half extent
         if (otmp.arect_circle_.v.getX() > 0.0f) {
             otmp.arect_circle_.fid = 0;
-            otmp.arect_circle_.v.setX(std::min(otmp.arect_circle_.v.getX(), otmp.arect_circle_.r_halfe.getX()));
+            otmp.arect_circle_.v.setX(std::min(otmp.arect_circle_.v.getX(), r_halfe.getX()));
         }
         else {
             otmp.arect_circle_.fid = 1;
-            otmp.arect_circle_.v.setX(std::max(otmp.arect_circle_.v.getX(), -otmp.arect_circle_.r_halfe.getX()));
+            otmp.arect_circle_.v.setX(std::max(otmp.arect_circle_.v.getX(), -r_halfe.getX()));
         }
         if (otmp.arect_circle_.v.getY() > 0.0f) {
-            otmp.arect_circle_.v.setY(std::min(otmp.arect_circle_.v.getY(), otmp.arect_circle_.r_halfe.getY()));
+            otmp.arect_circle_.v.setY(std::min(otmp.arect_circle_.v.getY(), r_halfe.getY()));
         }
         else {
             otmp.arect_circle_.fid |= (1<<1);
-            otmp.arect_circle_.v.setY(std::max(otmp.arect_circle_.v.getY(), -otmp.arect_circle_.r_halfe.getY()));
+            otmp.arect_circle_.v.setY(std::max(otmp.arect_circle_.v.getY(), -r_halfe.getY()));
         }
 
         // closes point on rect to circle
@@ -409,8 +426,9 @@ namespace grynca {
         }
         else {
             // circle center inside rectangle
-            f32 x_overlap = otmp.arect_circle_.r_halfe.getX() - fabsf(otmp.arect_circle_.v.getX());
-            f32 y_overlap = otmp.arect_circle_.r_halfe.getY() - fabsf(otmp.arect_circle_.v.getY());
+            Vec2 r_halfe = getSize()*0.5f;
+            f32 x_overlap = r_halfe.getX() - fabsf(otmp.arect_circle_.v.getX());
+            f32 y_overlap = r_halfe.getY() - fabsf(otmp.arect_circle_.v.getY());
 
             if (x_overlap < y_overlap) {
                 if (otmp.arect_circle_.v.getX() > 0) {
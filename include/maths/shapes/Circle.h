@@ -21,9 +21,11 @@ namespace grynca {
         // only uniform scale works
         // changes "this"
         void transform(const Mat3& tr);
+        void transform(const Affine2& tr);
         void transform(const Transform& tr);
 
         Circle transformOut(const Mat3& tr)const;
+        Circle transformOut(const Affine2& tr)const;
         Circle transformOut(const Transform& tr)const;
         Vec2 calcSupport(const Dir2& dir)const;
 
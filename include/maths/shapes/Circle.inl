@@ -32,6 +32,10 @@ namespace grynca {
     }
 
     inline void Circle::transform(const Mat3& tr) {
+        transform(Affine2(tr));
+    }
+
+    inline void Circle::transform(const Affine2& tr) {
         Dir2 trad = tr*Dir2(getRadius(), 0);
         c_ = tr*getCenter();
         r_ = trad.getLen();
@@ -46,6 +50,10 @@ namespace grynca {
     }
 
     inline Circle Circle::transformOut(const Mat3& tr)const {
+        return transformOut(Affine2(tr));
+    }
+
+    inline Circle Circle::transformOut(const Affine2& tr)const {
         Dir2 trad = tr*Dir2(getRadius(), 0);
         return Circle(tr*getCenter(), trad.getLen());
     }
@@ -146,4 +154,14 @@ namespace grynca {
         os << "Circle= c:" << c.getCenter() << ", r:" << c.r_;
         return os;
     }
-}
\ No newline at end of file
+
+    // GJK sees circle as its center point inflated by radius
+    template <>
+    struct GJKShape<Circle> {
+        static constexpr bool HasRadius = true;
+        static Vec2 calcSupport(const Circle& c, const Dir2&, u32& pt_id_out) { pt_id_out = 0; return c.getCenter(); }
+        static Vec2 calcSupportFrom(const Circle& c, const Dir2&, u32& pt_id_io) { pt_id_io = 0; return c.getCenter(); }
+        static Vec2 getPoint(const Circle& c, u32) { return c.getCenter(); }
+        static f32 getRadius(const Circle& c) { return c.getRadius(); }
+    };
+}
@@ -5,6 +5,46 @@
 
 namespace grynca {
 
+    // GJK state kept by caller per persistent pair (between frames)
+    //  - separated pair: starts from last separating direction (usually exits after first support)
+    //  - overlapping pair: restores last simplex triangle from support ids
+    struct GJKCache {
+        GJKCache() : valid(false) {}
+        void reset() { valid = false; }
+
+        bool valid;
+        bool overlapping;
+        Vec2 dir;                   // last search direction (separating axis when !overlapping)
+        u32 simplex_ids[3][2];      // support ids (shape1, shape2) of triangle a, b, c
+    };
+
+    // terminal simplex of overlapping GJK2D::isOverlapping() (as support ids)
+    //  - small enough to be kept between overlaps() and calcContact() instead of whole GJK2D
+    struct GJKSimplex {
+        u32 ids[3][2];      // support ids (shape1, shape2) of triangle a, b, c
+        u32 hints[2];
+    };
+
+    // result of GJK2D::calcDistance()
+    struct DistanceInfo {
+        f32 distance;       // 0 for overlapping shapes (closest points and normal are not set then)
+        Vec2 point_a;       // closest points on shapes
+        Vec2 point_b;
+        Dir2 normal;        // from B to A (as ContactManifold normal)
+    };
+
+    // shape as seen by GJK: support points of its core (with ids) inflated by radius
+    //  - circle is its center with radius (specialized in Circle.inl)
+    //  - radius is used only by calcDistance(), overlap & EPA paths do not compile for shapes with radius
+    template <typename ShapeT>
+    struct GJKShape {
+        static constexpr bool HasRadius = false;
+        static Vec2 calcSupport(const ShapeT& s, const Dir2& dir, u32& pt_id_out) { return s.calcSupport(dir, pt_id_out); }
+        static Vec2 calcSupportFrom(const ShapeT& s, const Dir2& dir, u32& pt_id_io) { return s.calcSupportFrom(dir, pt_id_io); }
+        static Vec2 getPoint(const ShapeT& s, u32 pt_id) { return s.getPoint(pt_id); }
+        static f32 getRadius(const ShapeT&) { return 0.0f; }
+    };
+
     template <typename ShapeT1, typename ShapeT2>
     class GJK2D {
     public:
@@ -13,15 +53,35 @@ namespace grynca {
         void setShapes(const ShapeT1& s1, const ShapeT2& s2);
 
         bool isOverlapping();
-        void calcPenetrationInfo();
+        // warm-started from cache (which is updated), shapes must be the same as when cache was filled
+        bool isOverlapping(GJKCache& cache_io);
+        // EPA, stops when closest polytope edge is within tolerance from Minkowski diff. border
+        // or after max_iterations (clamped to MaxEPAIterations)
+        void calcPenetrationInfo(f32 tolerance = MATHS_EPA_TOLERANCE, u32 max_iterations = MaxEPAIterations);
+        // distance and closest points of separated shapes (Johnson's sub-simplex solver)
+        //  returns false when shapes are farther than max_dist (di_out is not set then, query ends early)
+        bool calcDistance(DistanceInfo& di_out, f32 max_dist = std::numeric_limits<f32>::max());
+
+        // saves/restores exact simplex after overlapping isOverlapping() (shapes must not change in between),
+        //  calcPenetrationInfo() can then be called on restored GJK2D
+        void storeSimplex(GJKSimplex& simplex_out)const;
+        void restoreSimplex(const GJKSimplex& simplex);
 
         const ContactManifold& getContactManifold()const;
-    private:
-        static constexpr u32 MAX_EPA_ITERATIONS = MATHS_EPA_MAX_EDGES - 3; // we start at 3 edges and each iteration 1 edge is added
+        // support evaluations done by last isOverlapping() or calcDistance()
+        u32 getLastIterations()const;
+        // last calcPenetrationInfo(): polytope expansions done & bound of penetration depth error
+        u32 getEPAIterations()const;
+        f32 getEPAErrorBound()const;
 
+        static constexpr u32 MaxEPAIterations = MATHS_EPA_MAX_EDGES - 3; // we start at 3 edges and each iteration 1 edge is added
+    private:
+        static constexpr bool HasRadius_ = GJKShape<ShapeT1>::HasRadius || GJKShape<ShapeT2>::HasRadius;
         struct Supp {
             Supp() {}
-            void set(const ShapeT1& s1, const ShapeT2& s2, const Dir2& d);
+            // hints_io: last support ids of both shapes
+            void set(const ShapeT1& s1, const ShapeT2& s2, const Dir2& d, u32* hints_io);
+            void setFromIds(const ShapeT1& s1, const ShapeT2& s2, u32 id_a, u32 id_b);
 
             u32 supp_a_id, supp_b_id;
             Vec2 supp_a;
@@ -38,33 +98,55 @@ namespace grynca {
             void calcContactManifoldFlip(const ShapeT1& s1, const ShapeT2& s2, ContactManifold& cm_out);
 
             void clip_(ClipVertex* points, const Dir2& dir, f32 offset, u8 clip_edge);
-
-            struct GreaterThan {
-                bool operator()(const EdgeCtx& e1, const EdgeCtx& e2) {
-                    return e1.dist > e2.dist;
-                }
-            };
         };
 
+        // polytope edges, binary min-heap (by dist) of pool indices
         struct Edges {
-            const EdgeCtx& operator[](u32 i)const { ASSERT(i<size_); return *edges_[i]; }
-            u32 size()const { return size_; }
+            Edges() : heap_size_(0), pool_size_(0) {}
+
+            EdgeCtx& top() { return pool_[heap_[0]]; }
+            u32 popTop();       // returns freed pool id
+            void push(u32 pool_id);
+            u32 allocate() { ASSERT(pool_size_ < MATHS_EPA_MAX_EDGES); return pool_size_++; }
 
             EdgeCtx pool_[MATHS_EPA_MAX_EDGES];
-            EdgeCtx* edges_[MATHS_EPA_MAX_EDGES];        // keep these sorted by dist (descending)
-            u32 size_;
+            u32 heap_[MATHS_EPA_MAX_EDGES];
+            u32 heap_size_;
+            u32 pool_size_;
+        private:
+            bool less_(u32 h1, u32 h2)const { return pool_[heap_[h1]].dist < pool_[heap_[h2]].dist; }
         };
 
+        // starts with point simplex in dir
+        bool searchFrom_(const Vec2& dir);
+        // expands triangle until it contains zero
+        bool iterate_();
+        // tests zero against triangle (a, b_, c_), when outside replaces one point with a and sets v_
+        bool updateTriangle_(const Supp& a);
+        // also checks winding expected by EPA
+        bool triangleContainsZero_()const;
+        void setSupp_(Supp& supp_out, const Dir2& d);
+        // reduces simplex to the smallest sub-simplex containing its point closest to zero,
+        // sets v_ to that point and lambdas_out to its barycentric coords
+        // returns false when triangle simplex contains zero
+        bool solveSimplex_(Supp* simplex, u32& size_io, f32* lambdas_out);
 
         void calcEdgeDistToZeroInner_(const Vec2& a, const Vec2& b, f32& dist_out, Dir2& norm_out);
         void calcEdgeCtx_(const Supp& a, const Supp& b, EdgeCtx& edge_out);
         void setPenInfo_(EdgeCtx& edge);
+        static bool isSameSupp_(const Supp& s1, const Supp& s2);
 
         const ShapeT1* s1_;
         const ShapeT2* s2_;
 
         Vec2 v_;
         Supp a_, b_, c_;
+        u32 supp_hints_[2];
+        u32 iterations_;
+        u32 epa_iterations_;
+        f32 epa_error_bound_;
+        // triangle restored from cache may have points inside Minkowski diff. (not usable for EPA as is)
+        bool simplex_restored_;
 
         // penetration info
         ContactManifold cm_;
@@ -11,27 +11,109 @@ namespace grynca {
 
     G2D_TPL
     inline G2D_TYPE::GJK2D()
-     : s1_(NULL), s2_(NULL)
+     : s1_(NULL), s2_(NULL), supp_hints_{0, 0}, iterations_(0), epa_iterations_(0), epa_error_bound_(0), simplex_restored_(false)
     {}
 
     G2D_TPL
     inline void G2D_TYPE::setShapes(const ST1& s1, const ST2& s2) {
         s1_ = &s1;
         s2_ = &s2;
+        supp_hints_[0] = supp_hints_[1] = 0;
     }
 
     G2D_TPL
     inline bool G2D_TYPE::isOverlapping() {
-        v_.set(1, 0); //some arbitrary starting vector
+        static_assert(!HasRadius_, "GJK overlap ignores radius (only calcDistance() supports circles)");
+        iterations_ = 0;
+        simplex_restored_ = false;
+        return searchFrom_(Vec2(1, 0));     //some arbitrary starting vector
+    }
 
-        c_.set(*s1_, *s2_, v_);
+    G2D_TPL
+    inline bool G2D_TYPE::isOverlapping(GJKCache& cache_io) {
+        static_assert(!HasRadius_, "GJK overlap ignores radius (only calcDistance() supports circles)");
+        iterations_ = 0;
+        simplex_restored_ = false;
+        bool rslt;
+        if (!cache_io.valid) {
+            rslt = searchFrom_(Vec2(1, 0));
+        }
+        else if (!cache_io.overlapping) {
+            rslt = searchFrom_(cache_io.dir);
+        }
+        else {
+            a_.setFromIds(*s1_, *s2_, cache_io.simplex_ids[0][0], cache_io.simplex_ids[0][1]);
+            b_.setFromIds(*s1_, *s2_, cache_io.simplex_ids[1][0], cache_io.simplex_ids[1][1]);
+            c_.setFromIds(*s1_, *s2_, cache_io.simplex_ids[2][0], cache_io.simplex_ids[2][1]);
+            supp_hints_[0] = a_.supp_a_id;
+            supp_hints_[1] = a_.supp_b_id;
+            // points are in Minkowski diff. so containing zero proves overlap
+            if (triangleContainsZero_()) {
+                simplex_restored_ = true;
+                rslt = true;
+            }
+            else {
+                rslt = searchFrom_(cache_io.dir);
+            }
+        }
+
+        cache_io.valid = true;
+        cache_io.overlapping = rslt;
+        if (!simplex_restored_) {
+            cache_io.dir = v_;
+        }
+        if (rslt) {
+            const Supp* simplex[3] = {&a_, &b_, &c_};
+            for (u32 i=0; i<3; ++i) {
+                cache_io.simplex_ids[i][0] = simplex[i]->supp_a_id;
+                cache_io.simplex_ids[i][1] = simplex[i]->supp_b_id;
+            }
+        }
+        return rslt;
+    }
+
+    G2D_TPL
+    inline void G2D_TYPE::storeSimplex(GJKSimplex& simplex_out)const {
+        const Supp* simplex[3] = {&a_, &b_, &c_};
+        for (u32 i=0; i<3; ++i) {
+            simplex_out.ids[i][0] = simplex[i]->supp_a_id;
+            simplex_out.ids[i][1] = simplex[i]->supp_b_id;
+        }
+        simplex_out.hints[0] = supp_hints_[0];
+        simplex_out.hints[1] = supp_hints_[1];
+    }
+
+    G2D_TPL
+    inline void G2D_TYPE::restoreSimplex(const GJKSimplex& simplex) {
+        // support ids give same points as when stored -> simplex is on Minkowski diff. border
+        a_.setFromIds(*s1_, *s2_, simplex.ids[0][0], simplex.ids[0][1]);
+        b_.setFromIds(*s1_, *s2_, simplex.ids[1][0], simplex.ids[1][1]);
+        c_.setFromIds(*s1_, *s2_, simplex.ids[2][0], simplex.ids[2][1]);
+        supp_hints_[0] = simplex.hints[0];
+        supp_hints_[1] = simplex.hints[1];
+        simplex_restored_ = false;
+    }
+
+    G2D_TPL
+    inline u32 G2D_TYPE::getLastIterations()const {
+        return iterations_;
+    }
+
+    G2D_TPL
+    inline bool G2D_TYPE::searchFrom_(const Vec2& dir) {
+        v_ = dir;
+        if (v_.isZero()) {
+            v_.set(1, 0);
+        }
+
+        setSupp_(c_, v_);
         if(dot(c_.supp, v_) < maths::EPS) {
             return false;
         }
 
         // 0-simplex - point
         v_ = -c_.supp;
-        b_.set(*s1_, *s2_, v_);
+        setSupp_(b_, v_);
 
         // 1-simplex - line segment
         if(dot(b_.supp, v_) < maths::EPS) {
@@ -48,46 +130,26 @@ namespace grynca {
             std::swap(b_,c_);       // so that triangle will be clockwise winded
         }
 
+        return iterate_();
+    }
+
+    G2D_TPL
+    inline bool G2D_TYPE::iterate_() {
         static constexpr f32 EPS = 2*maths::EPS;        // use more tolerant EPS
         // 2-simplex - triangle
         for(u32 iterations = 0; iterations < MATHS_GJK_MAX_ITERATIONS; iterations++ ) {
             // limit iterations (it can cycle when rounding errors happen)
             Supp a;
-            a.set(*s1_, *s2_, v_);   // third triangle point
+            setSupp_(a, v_);   // third triangle point
 
             if(dot(a.supp, v_) < EPS) {
                 return false;
             }
 
-            Vec2 ao = -a.supp;       // to origin
-
-            // edges vectors
-            Vec2 ab = b_.supp - a.supp;
-            Vec2 ac = c_.supp - a.supp;
-
-            //compute a vector within the plane of the triangle,
-            //pointing away from the edge ab
-            // out-pointing vector of AB
-            Vec2 abp = ab.perpL();
-            if(dot(abp, ao) > -EPS) {
-                //the origin lies outside the triangle,
-                //near the edge ab
-                c_ = a;
-                v_ = abp;
-                continue;
-            }
-
-            //perform a similar test for the edge ac
-            Vec2 acp = ac.perpR();
-            if(dot(acp, ao) > -EPS) {
-                b_ = a;
-                v_ = acp;
-                continue;
+            if (updateTriangle_(a)) {
+                a_ = a;     // is needed for EPA
+                return true;
             }
-
-            //if we get here, then the origin must be within the triangle
-            a_ = a;     // is needed for EPA
-            return true;
         }
 
         //out of iterations (probably rounding errors)
@@ -96,57 +158,168 @@ namespace grynca {
     }
 
     G2D_TPL
-    inline void G2D_TYPE::calcPenetrationInfo() {
+    inline bool G2D_TYPE::updateTriangle_(const Supp& a) {
+        static constexpr f32 EPS = 2*maths::EPS;
+        Vec2 ao = -a.supp;       // to origin
+
+        // edges vectors
+        Vec2 ab = b_.supp - a.supp;
+        Vec2 ac = c_.supp - a.supp;
+
+        //compute a vector within the plane of the triangle,
+        //pointing away from the edge ab
+        // out-pointing vector of AB
+        Vec2 abp = ab.perpL();
+        if(dot(abp, ao) > -EPS) {
+            //the origin lies outside the triangle,
+            //near the edge ab
+            c_ = a;
+            v_ = abp;
+            return false;
+        }
+
+        //perform a similar test for the edge ac
+        Vec2 acp = ac.perpR();
+        if(dot(acp, ao) > -EPS) {
+            b_ = a;
+            v_ = acp;
+            return false;
+        }
+
+        //if we get here, then the origin must be within the triangle
+        return true;
+    }
+
+    G2D_TPL
+    inline bool G2D_TYPE::triangleContainsZero_()const {
+        // winding of triangles found by GJK is positive
+        return cross(b_.supp - a_.supp, -a_.supp) > 0.0f
+               && cross(c_.supp - b_.supp, -b_.supp) > 0.0f
+               && cross(a_.supp - c_.supp, -c_.supp) > 0.0f;
+    }
+
+    G2D_TPL
+    inline void G2D_TYPE::setSupp_(Supp& supp_out, const Dir2& d) {
+        ++iterations_;
+        supp_out.set(*s1_, *s2_, d, supp_hints_);
+    }
+
+    G2D_TPL
+    inline void G2D_TYPE::calcPenetrationInfo(f32 tolerance, u32 max_iterations) {
+        static_assert(!HasRadius_, "GJK overlap ignores radius (only calcDistance() supports circles)");
         //http://www.dyn4j.org/2010/05/epa-expanding-polytope-algorithm/
         // we must find point on Minkowski diff. polygon that is nearest to origin
         // we already have triangle simplex
         //  -> calc distances to origin for all 3 edges and find nearest
 
-        Edges edges;
-        calcEdgeCtx_(a_, b_, edges.pool_[0]);
-        calcEdgeCtx_(b_, c_, edges.pool_[1]);
-        calcEdgeCtx_(c_, a_, edges.pool_[2]);
-        edges.size_ = 3;
+        if (simplex_restored_) {
+            // move restored points to Minkowski diff. border (supports in their directions)
+            a_.set(*s1_, *s2_, a_.supp, supp_hints_);
+            b_.set(*s1_, *s2_, b_.supp, supp_hints_);
+            c_.set(*s1_, *s2_, c_.supp, supp_hints_);
+            simplex_restored_ = false;
+            if (!triangleContainsZero_() && !searchFrom_(Vec2(1, 0))) {
+                // touching only (within EPS)
+                cm_.size = 0;
+                return;
+            }
+        }
 
-        sortThree(edges.pool_[0], edges.pool_[1], edges.pool_[2], edges.edges_, typename EdgeCtx::GreaterThan());
+        if (max_iterations > MaxEPAIterations)
+            max_iterations = MaxEPAIterations;
+        Edges edges;
+        const Supp* simplex[3] = {&a_, &b_, &c_};
+        for (u32 i=0; i<3; ++i) {
+            u32 e = edges.allocate();
+            calcEdgeCtx_(*simplex[i], *simplex[(i+1)%3], edges.pool_[e]);
+            edges.push(e);
+        }
 
-        // try to expand polygon in best_n dir and find some other point on Mink. diff border
-        for(u32 iterations = 0; iterations < MAX_EPA_ITERATIONS; iterations++ ) {
-            EdgeCtx* last_e = edges.edges_[edges.size_-1];   // last edge has best distance to zero
-            Dir2 n = last_e->normal;
+        // penetration depth is between closest edge dist (polytope is inside Minkowski diff.)
+        // and smallest support dist found so far
+        f32 upper_bound = std::numeric_limits<f32>::max();
+        for (epa_iterations_ = 0; epa_iterations_ < max_iterations; ++epa_iterations_) {
+            EdgeCtx& closest = edges.top();
+            Dir2 n = closest.normal;
             Supp pt;
-            pt.set(*s1_, *s2_, n);
+            pt.set(*s1_, *s2_, n, supp_hints_);
             f32 pt_dist = dot(pt.supp, n);
-            if (pt_dist - last_e->dist < maths::EPS) {
-                // we could not expand in that direction (meaning we already reached Mink.diff border in that dir)
+            upper_bound = std::min(upper_bound, pt_dist);
+            if (pt_dist - closest.dist < tolerance || isSameSupp_(pt, closest.pt1) || isSameSupp_(pt, closest.pt2)) {
+                // we could not expand in that direction (meaning we already reached Mink.diff border in that dir,
+                //  same vertex found again means tolerance is under float precision)
                 // -> we are done
-                setPenInfo_(*last_e);
+                epa_error_bound_ = std::max(upper_bound - closest.dist, 0.0f);
+                setPenInfo_(closest);
                 return;
             }
 
             // this edge is not on Min.diff. border
             //  -> expand edge to 2 new edges (going through "pt")
-            Supp a = last_e->pt1;
-            Supp b = last_e->pt2;
-
-            EdgeCtx* e1 = last_e;   // reuse previous edge memory for first
-            EdgeCtx* e2 = &edges.pool_[edges.size_];
-            calcEdgeCtx_(a, pt, *e1);
-            calcEdgeCtx_(pt, b, *e2);
-
-            // keep new edges sorted
-            --edges.size_;
-            u32 ins_pos = bisectFindInsert(edges, *e1, typename EdgeCtx::GreaterThan());
-            arrayInsert(edges.edges_, ins_pos, 1, edges.size_, MATHS_EPA_MAX_EDGES);
-            edges.edges_[ins_pos] = e1;
-            ++edges.size_;
-            ins_pos = bisectFindInsert(edges, *e2, typename EdgeCtx::GreaterThan());
-            arrayInsert(edges.edges_, ins_pos, 1, edges.size_, MATHS_EPA_MAX_EDGES);
-            edges.edges_[ins_pos] = e2;
-            ++edges.size_;
-        }
-        // run out of iterations (this should happen really rarely - probably due to floating point errors)
-        setPenInfo_(*edges.edges_[edges.size_-1]);
+            Supp a = closest.pt1;
+            Supp b = closest.pt2;
+            u32 e1 = edges.popTop();       // reuse closest edge memory for first
+            u32 e2 = edges.allocate();
+            calcEdgeCtx_(a, pt, edges.pool_[e1]);
+            calcEdgeCtx_(pt, b, edges.pool_[e2]);
+            edges.push(e1);
+            edges.push(e2);
+        }
+        // run out of iterations (deep penetrations of round shapes or floating point errors)
+        EdgeCtx& closest = edges.top();
+        epa_error_bound_ = std::max(upper_bound - closest.dist, 0.0f);
+        setPenInfo_(closest);
+    }
+
+    G2D_TPL
+    inline bool G2D_TYPE::isSameSupp_(const Supp& s1, const Supp& s2) {
+        // static
+        return s1.supp_a_id == s2.supp_a_id && s1.supp_b_id == s2.supp_b_id;
+    }
+
+    G2D_TPL
+    inline u32 G2D_TYPE::getEPAIterations()const {
+        return epa_iterations_;
+    }
+
+    G2D_TPL
+    inline f32 G2D_TYPE::getEPAErrorBound()const {
+        return epa_error_bound_;
+    }
+
+    G2D_TPL
+    inline u32 G2D_TYPE::Edges::popTop() {
+        u32 top_id = heap_[0];
+        --heap_size_;
+        heap_[0] = heap_[heap_size_];
+        // sift down
+        u32 i = 0;
+        for (;;) {
+            u32 l = 2*i+1, r = l+1, smallest = i;
+            if (l < heap_size_ && less_(l, smallest))
+                smallest = l;
+            if (r < heap_size_ && less_(r, smallest))
+                smallest = r;
+            if (smallest == i)
+                break;
+            std::swap(heap_[i], heap_[smallest]);
+            i = smallest;
+        }
+        return top_id;
+    }
+
+    G2D_TPL
+    inline void G2D_TYPE::Edges::push(u32 pool_id) {
+        u32 i = heap_size_++;
+        heap_[i] = pool_id;
+        // sift up
+        while (i > 0) {
+            u32 parent = (i-1)/2;
+            if (!less_(i, parent))
+                break;
+            std::swap(heap_[i], heap_[parent]);
+            i = parent;
+        }
     }
 
     G2D_TPL
@@ -155,9 +328,194 @@ namespace grynca {
     }
 
     G2D_TPL
-    inline void G2D_TYPE::Supp::set(const ST1& s1, const ST2& s2, const Dir2& d) {
-        supp_a = s1.calcSupport(d, supp_a_id);
-        supp_b = s2.calcSupport(-d, supp_b_id);
+    inline bool G2D_TYPE::calcDistance(DistanceInfo& di_out, f32 max_dist) {
+        // GJK on shape cores, radii are added at the end
+        //  (Gilbert-Johnson-Keerthi distance algorithm, simplex solver as in Box2D's b2Distance)
+        iterations_ = 0;
+        simplex_restored_ = false;
+        f32 radius_a = GJKShape<ST1>::getRadius(*s1_);
+        f32 radius_b = GJKShape<ST2>::getRadius(*s2_);
+
+        Supp simplex[3];
+        f32 lambdas[3] = {1.0f, 0.0f, 0.0f};
+        u32 size = 1;
+        setSupp_(simplex[0], Vec2(1, 0));     //some arbitrary starting vector
+        v_ = simplex[0].supp;
+        for (u32 iterations = 0; iterations < MATHS_GJK_MAX_ITERATIONS; ++iterations) {
+            f32 v_sqr_len = v_.getSqrLen();
+            if (v_sqr_len < maths::EPS*maths::EPS) {
+                // cores are touching
+                di_out.distance = 0.0f;
+                return true;
+            }
+            Supp w;
+            setSupp_(w, -v_);
+            // whole Minkowski diff. is behind plane through w (perpendicular to v_)
+            f32 v_dot_w = dot(v_, w.supp);
+            f32 v_len = sqrtf(v_sqr_len);
+            if (v_dot_w/v_len - radius_a - radius_b > max_dist) {
+                return false;
+            }
+
+            bool duplicate = false;
+            for (u32 i=0; i<size; ++i) {
+                duplicate |= (w.supp_a_id == simplex[i].supp_a_id && w.supp_b_id == simplex[i].supp_b_id);
+            }
+            if (duplicate || v_sqr_len - v_dot_w <= maths::EPS*v_len) {
+                // no progress towards zero -> v_ is closest point
+                break;
+            }
+
+            simplex[size++] = w;
+            if (!solveSimplex_(simplex, size, lambdas)) {
+                // cores overlap
+                di_out.distance = 0.0f;
+                return true;
+            }
+        }
+
+        Vec2 pt_a(0, 0), pt_b(0, 0);
+        for (u32 i=0; i<size; ++i) {
+            pt_a += simplex[i].supp_a*lambdas[i];
+            pt_b += simplex[i].supp_b*lambdas[i];
+        }
+        Vec2 ba = pt_a - pt_b;
+        f32 core_dist = ba.getLen();
+        f32 dist = core_dist - radius_a - radius_b;
+        if (dist > max_dist) {
+            return false;
+        }
+        if (dist <= 0.0f) {
+            di_out.distance = 0.0f;
+            return true;
+        }
+        di_out.distance = dist;
+        di_out.normal = ba/core_dist;
+        di_out.point_a = pt_a - di_out.normal*radius_a;
+        di_out.point_b = pt_b + di_out.normal*radius_b;
+        return true;
+    }
+
+    G2D_TPL
+    inline bool G2D_TYPE::solveSimplex_(Supp* simplex, u32& size_io, f32* lambdas_out) {
+        // barycentric coords of closest point are (unnormalized) d_i for sub-simplex regions
+        if (size_io == 2) {
+            const Vec2& w1 = simplex[0].supp;
+            const Vec2& w2 = simplex[1].supp;
+            Vec2 e12 = w2 - w1;
+            f32 d12_1 = dot(w2, e12);
+            f32 d12_2 = -dot(w1, e12);
+            if (d12_2 <= 0.0f) {
+                // w1 region
+                size_io = 1;
+                lambdas_out[0] = 1.0f;
+            }
+            else if (d12_1 <= 0.0f) {
+                // w2 region
+                simplex[0] = simplex[1];
+                size_io = 1;
+                lambdas_out[0] = 1.0f;
+            }
+            else {
+                f32 inv_d = 1.0f/(d12_1 + d12_2);
+                lambdas_out[0] = d12_1*inv_d;
+                lambdas_out[1] = d12_2*inv_d;
+            }
+        }
+        else {
+            ASSERT(size_io == 3);
+            const Vec2& w1 = simplex[0].supp;
+            const Vec2& w2 = simplex[1].supp;
+            const Vec2& w3 = simplex[2].supp;
+
+            Vec2 e12 = w2 - w1;
+            f32 d12_1 = dot(w2, e12);
+            f32 d12_2 = -dot(w1, e12);
+            Vec2 e13 = w3 - w1;
+            f32 d13_1 = dot(w3, e13);
+            f32 d13_2 = -dot(w1, e13);
+            Vec2 e23 = w3 - w2;
+            f32 d23_1 = dot(w3, e23);
+            f32 d23_2 = -dot(w2, e23);
+
+            f32 n123 = cross(e12, e13);
+            f32 d123_1 = n123*cross(w2, w3);
+            f32 d123_2 = n123*cross(w3, w1);
+            f32 d123_3 = n123*cross(w1, w2);
+
+            if (d12_2 <= 0.0f && d13_2 <= 0.0f) {
+                // w1 region
+                size_io = 1;
+                lambdas_out[0] = 1.0f;
+            }
+            else if (d12_1 > 0.0f && d12_2 > 0.0f && d123_3 <= 0.0f) {
+                // e12 region
+                f32 inv_d = 1.0f/(d12_1 + d12_2);
+                size_io = 2;
+                lambdas_out[0] = d12_1*inv_d;
+                lambdas_out[1] = d12_2*inv_d;
+            }
+            else if (d13_1 > 0.0f && d13_2 > 0.0f && d123_2 <= 0.0f) {
+                // e13 region
+                f32 inv_d = 1.0f/(d13_1 + d13_2);
+                simplex[1] = simplex[2];
+                size_io = 2;
+                lambdas_out[0] = d13_1*inv_d;
+                lambdas_out[1] = d13_2*inv_d;
+            }
+            else if (d12_1 <= 0.0f && d23_2 <= 0.0f) {
+                // w2 region
+                simplex[0] = simplex[1];
+                size_io = 1;
+                lambdas_out[0] = 1.0f;
+            }
+            else if (d13_1 <= 0.0f && d23_1 <= 0.0f) {
+                // w3 region
+                simplex[0] = simplex[2];
+                size_io = 1;
+                lambdas_out[0] = 1.0f;
+            }
+            else if (d23_1 > 0.0f && d23_2 > 0.0f && d123_1 <= 0.0f) {
+                // e23 region
+                f32 inv_d = 1.0f/(d23_1 + d23_2);
+                simplex[0] = simplex[2];
+                size_io = 2;
+                lambdas_out[0] = d23_2*inv_d;
+                lambdas_out[1] = d23_1*inv_d;
+            }
+            else {
+                // zero is inside triangle
+                return false;
+            }
+        }
+
+        v_ = simplex[0].supp*lambdas_out[0];
+        for (u32 i=1; i<size_io; ++i) {
+            v_ += simplex[i].supp*lambdas_out[i];
+        }
+        return true;
+    }
+
+    G2D_TPL
+    inline void G2D_TYPE::Supp::set(const ST1& s1, const ST2& s2, const Dir2& d, u32* hints_io) {
+#if MATHS_GJK_HILL_CLIMBING
+        supp_a = GJKShape<ST1>::calcSupportFrom(s1, d, hints_io[0]);
+        supp_b = GJKShape<ST2>::calcSupportFrom(s2, -d, hints_io[1]);
+        supp_a_id = hints_io[0];
+        supp_b_id = hints_io[1];
+#else
+        supp_a = GJKShape<ST1>::calcSupport(s1, d, supp_a_id);
+        supp_b = GJKShape<ST2>::calcSupport(s2, -d, supp_b_id);
+#endif
+        supp = supp_a-supp_b;
+    }
+
+    G2D_TPL
+    inline void G2D_TYPE::Supp::setFromIds(const ST1& s1, const ST2& s2, u32 id_a, u32 id_b) {
+        supp_a_id = id_a;
+        supp_b_id = id_b;
+        supp_a = GJKShape<ST1>::getPoint(s1, id_a);
+        supp_b = GJKShape<ST2>::getPoint(s2, id_b);
         supp = supp_a-supp_b;
     }
 
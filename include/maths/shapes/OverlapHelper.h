@@ -10,6 +10,12 @@ namespace grynca {
     // fw
     class Shape;
 
+    // input for batched narrowphase ([0] is shape A, [1] is shape B)
+    struct OverlapPair {
+        const Shape* shapes[2];
+        const Transform* transforms[2];
+    };
+
     class OverlapHelper {
     public:
         OverlapHelper();
@@ -22,21 +28,62 @@ namespace grynca {
         void calcContactG();        // calculates global manifold
         void calcContactGL();       // calculates both global and local manifolds
 
+        // GJK distance query, closest points and normal are global, false when farther than max_dist
+        //  (closest points are found in ref. shape's frame, with non-uniform scale they are approximate)
+        bool calcDistance(DistanceInfo& di_out, f32 max_dist = std::numeric_limits<f32>::max());
+
         const ContactManifold& getContactManifoldG()const;
         ContactManifold& accContactManifoldG();
         const ContactManifold& getContactManifoldA()const;
         ContactManifold& accContactManifoldA();
         const ContactManifold& getContactManifoldB()const;
         ContactManifold& accContactManifoldB();
+
+        // pairs are bucketed by their types combination and each bucket is processed in its own loop
+        // overlaps_out[i] is set for each pair, global manifold is written to cms_out[i] for overlapping pairs (if cms_out is not NULL)
+        void overlapsBatch(const OverlapPair* pairs, u32 pairs_cnt, bool* overlaps_out, ContactManifold* cms_out = NULL);
     private:
+        static constexpr u32 BatchChunkSize_ = 256;
+
+        struct SingleF_;
+        struct BatchF_;
+        struct DistanceF_;
+        // transformed target shape storage (Pgon has its own scratch so that its memory is reused)
+        template <typename TargetShapeRsltT>
+        struct Target_;
+
+        // shape with higher priority is reference, the other (target) is transformed to its frame
+        // (so that the cheaper shape gets transformed)
+        template <typename ShapeT>
+        struct RefPriority_;
+        // type target is transformed to (ARect can't be rotated)
+        template <typename ShapeT>
+        struct TargetRslt_;
+        // ShapePairTable entry selecting reference and target shape types for types combination
+        template <typename Func>
+        struct DispatchE_;
+
+        // calls f.call<RefShapeT, TargetShapeT, TargetShapeRsltT>(bool ref_is_b) via ShapePairTable
+        template <typename Func>
+        static bool dispatchTypes_(i32 tid_a, i32 tid_b, Func& f);
+
         void changeRefShape_();
         template <typename RefShapeT, typename TargetShapeT, typename TargetShapeRsltT = TargetShapeT>
         bool overlapsInner_();
+        template <typename RefShapeT, typename TargetShapeRsltT>
+        void calcContactInner_(ContactManifold& cm_out);
+        template <typename RefShapeT, typename TargetShapeT, typename TargetShapeRsltT = TargetShapeT>
+        bool calcDistanceInner_(DistanceInfo& di_out, f32 max_dist);
+        template <typename RefShapeT, typename TargetShapeT, typename TargetShapeRsltT = TargetShapeT>
+        void overlapsBatchInner_(const OverlapPair* pairs, const u32* pair_ids, u32 pairs_cnt, bool ref_is_b,
+                                 bool* overlaps_out, ContactManifold* cms_out);
 
         u32 ref_shape_id_;
         f32 normal_mult_;
         const Shape* shapes_[2];
         Shape tr_target_shape_;     // transformed target shape
+        Pgon tr_target_pgon_;       // transformed target pgon (reused, no allocations after warm-up)
+        void (OverlapHelper::*calc_contact_f_)(ContactManifold& cm_out);       // set by overlapsInner_()
 
         Transform shape_tr_[2];
         Transform target_to_ref_tr_;
@@ -44,6 +91,8 @@ namespace grynca {
         OverlapTmp otmp_;
         ContactManifold cm_l_[2];   // local contact manifolds
         ContactManifold cm_g_;      // global contact manifold
+
+        fast_vector<u32> batch_order_;      // pair ids of chunk sorted by types combination
     };
 
 }
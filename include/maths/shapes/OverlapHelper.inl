@@ -1,11 +1,10 @@
 #include "OverlapHelper.h"
 #include "Shape.h"
-#define TID(ST) Shape::getTypeIdOf<ST>()
 
 namespace grynca {
 
     inline OverlapHelper::OverlapHelper()
-     : ref_shape_id_(0), normal_mult_(1.0f)
+     : ref_shape_id_(0), normal_mult_(1.0f), calc_contact_f_(NULL)
     {
      shapes_[0] = shapes_[1] = NULL;
     }
@@ -17,6 +16,7 @@ namespace grynca {
         shape_tr_[1] = shapeB_tr;
         ref_shape_id_ = 0;
         normal_mult_ = 1.0f;
+        calc_contact_f_ = NULL;     // contact needs overlaps() for new shapes
     }
 
     inline void OverlapHelper::setShapeA(const Shape& shape, const Transform& tr) {
@@ -24,6 +24,7 @@ namespace grynca {
         shape_tr_[0] = tr;
         ref_shape_id_ = 0;
         normal_mult_ = 1.0f;
+        calc_contact_f_ = NULL;
     }
 
     inline void OverlapHelper::setShapeB(const Shape& shape, const Transform& tr) {
@@ -31,81 +32,94 @@ namespace grynca {
         shape_tr_[1] = tr;
         ref_shape_id_ = 0;
         normal_mult_ = 1.0f;
+        calc_contact_f_ = NULL;
     }
 
+    struct OverlapHelper::SingleF_ {
+        template <typename RefShapeT, typename TargetShapeT, typename TargetShapeRsltT>
+        bool call(bool ref_is_b) {
+            oh->ref_shape_id_ = 0;
+            oh->normal_mult_ = 1.0f;
+            if (ref_is_b)
+                oh->changeRefShape_();
+            return oh->overlapsInner_<RefShapeT, TargetShapeT, TargetShapeRsltT>();
+        }
+
+        OverlapHelper* oh;
+    };
+
+    struct OverlapHelper::BatchF_ {
+        template <typename RefShapeT, typename TargetShapeT, typename TargetShapeRsltT>
+        bool call(bool ref_is_b) {
+            oh->overlapsBatchInner_<RefShapeT, TargetShapeT, TargetShapeRsltT>(pairs, pair_ids, pairs_cnt, ref_is_b, overlaps_out, cms_out);
+            return true;
+        }
+
+        OverlapHelper* oh;
+        const OverlapPair* pairs;
+        const u32* pair_ids;
+        u32 pairs_cnt;
+        bool* overlaps_out;
+        ContactManifold* cms_out;
+    };
+
+    struct OverlapHelper::DistanceF_ {
+        template <typename RefShapeT, typename TargetShapeT, typename TargetShapeRsltT>
+        bool call(bool ref_is_b) {
+            oh->ref_shape_id_ = 0;
+            oh->normal_mult_ = 1.0f;
+            if (ref_is_b)
+                oh->changeRefShape_();
+            return oh->calcDistanceInner_<RefShapeT, TargetShapeT, TargetShapeRsltT>(*di_out, max_dist);
+        }
+
+        OverlapHelper* oh;
+        DistanceInfo* di_out;
+        f32 max_dist;
+    };
+
+    template <typename TargetShapeRsltT>
+    struct OverlapHelper::Target_ {
+        template <typename TargetShapeT>
+        static const TargetShapeRsltT& set(OverlapHelper& oh, const TargetShapeT& src, const Transform& tr) {
+            oh.tr_target_shape_.set<TargetShapeRsltT>(src);
+            TargetShapeRsltT& ts = oh.tr_target_shape_.acc<TargetShapeRsltT>();
+            ts.transform(tr);
+            return ts;
+        }
+
+        static const TargetShapeRsltT& get(const OverlapHelper& oh) {
+            return oh.tr_target_shape_.get<TargetShapeRsltT>();
+        }
+    };
+
+    template <>
+    struct OverlapHelper::Target_<Pgon> {
+        static const Pgon& set(OverlapHelper& oh, const Pgon& src, const Transform& tr) {
+            oh.tr_target_pgon_.setTransformed(src, tr);
+            return oh.tr_target_pgon_;
+        }
+
+        static const Pgon& get(const OverlapHelper& oh) {
+            return oh.tr_target_pgon_;
+        }
+    };
+
     inline bool OverlapHelper::overlaps() {
         PROFILE_BLOCK("OverlapHelper::overlaps()");
-        // one shape will be transformed to other shape's frame
-        // this switch makes sure that it transforms shape that is cheaper to transform
-        // then it calls overlaps() func directly
-
-        const Shape* rs = shapes_[ref_shape_id_];
-        const Shape* ts = shapes_[1-ref_shape_id_];
-        i32 rs_tid = rs->getTypeId();
-        i32 ts_tid = ts->getTypeId();
-        switch (rs_tid) {
-            case TID(Ray): {
-                switch (ts_tid) {
-                    case TID(Ray): return overlapsInner_<Ray, Ray>();
-                    case TID(Circle): return overlapsInner_<Ray, Circle>();
-                    case TID(ARect): changeRefShape_(); return overlapsInner_<ARect, Ray>();
-                    case TID(Rect): changeRefShape_(); return overlapsInner_<Rect, Ray>();
-                    case TID(Pgon): changeRefShape_(); return overlapsInner_<Pgon, Ray>();
-                }
-            }break;
-            case TID(Circle): {
-                switch (ts_tid) {
-                    case TID(Circle): return overlapsInner_<Circle, Circle>();
-                    case TID(Ray): changeRefShape_(); return overlapsInner_<Ray, Circle>();
-                    case TID(ARect): changeRefShape_(); return overlapsInner_<ARect, Circle>();
-                    case TID(Rect): changeRefShape_(); return overlapsInner_<Rect, Circle>();
-                    case TID(Pgon): changeRefShape_(); return overlapsInner_<Pgon, Circle>();
-                }
-            }break;
-            case TID(ARect): {
-                switch (ts_tid) {
-                    case TID(Ray): return overlapsInner_<ARect, Ray>();
-                    case TID(Circle): return overlapsInner_<ARect, Circle>();
-                    case TID(ARect):
-                        // make Rect from target ARect so that it can be transformed (rotated) to ref. frame
-                        return overlapsInner_<ARect, ARect, Rect>();
-                    case TID(Rect): return overlapsInner_<ARect, Rect>();
-                    case TID(Pgon):
-                        // make Rect from target ARect so that it can be transformed (rotated) to ref. frame
-                        changeRefShape_(); return  overlapsInner_<Pgon, ARect, Rect>();
-                }
-            }break;
-            case TID(Rect): {
-                switch (ts_tid) {
-                    case TID(Ray): return overlapsInner_<Rect, Ray>();
-                    case TID(Circle): return overlapsInner_<Rect, Circle>();
-                    case TID(ARect): changeRefShape_(); return overlapsInner_<ARect, Rect>();
-                    case TID(Rect): return overlapsInner_<Rect, Rect>();
-                    case TID(Pgon): changeRefShape_(); return overlapsInner_<Pgon, Rect>();
-                }
-            }break;
-            case TID(Pgon): {
-                switch (ts_tid) {
-                    case TID(Ray):return overlapsInner_<Pgon, Ray>();
-                    case TID(Circle): return overlapsInner_<Pgon, Circle>();
-                        // make Rect from ARect so that it can be transformed (rotated) to Pgon frame
-                    case TID(ARect): return overlapsInner_<Pgon, ARect, Rect>();
-                    case TID(Rect): return overlapsInner_<Pgon, Rect>();
-                    case TID(Pgon): return overlapsInner_<Pgon, Pgon>();
-                }
-            }break;
-        }
-        NEVER_GET_HERE("unknown types");
-        return false;
+        SingleF_ f;
+        f.oh = this;
+        return dispatchTypes_(shapes_[0]->getTypeId(), shapes_[1]->getTypeId(), f);
     }
 
     inline void OverlapHelper::calcContactG() {
         PROFILE_BLOCK("OverlapHelper::calcContactG()");
+        ASSERT_M(calc_contact_f_, "Call overlaps() first.");
         ContactManifold& ref_cm = cm_l_[ref_shape_id_];
-        shapes_[ref_shape_id_]->calcContact(tr_target_shape_, otmp_, ref_cm);
+        (this->*calc_contact_f_)(ref_cm);
         ref_cm.normal *= normal_mult_;
 
-        Mat3 trm = shape_tr_[ref_shape_id_].calcMatrix();
+        Affine2 trm = shape_tr_[ref_shape_id_].calcAffine();
         cm_g_ = ref_cm;
         cm_g_.normal = trm*ref_cm.normal;
         for (u32 i=0; i<cm_g_.size; ++i) {
@@ -118,7 +132,7 @@ namespace grynca {
 
         ContactManifold& ref_cm = cm_l_[ref_shape_id_];
         Transform ref_to_target_tr = -target_to_ref_tr_;
-        Mat3 trm = ref_to_target_tr.calcMatrix();
+        Affine2 trm = ref_to_target_tr.calcAffine();
         ContactManifold& tgt_cm = cm_l_[1-ref_shape_id_];
         tgt_cm = ref_cm;
         tgt_cm.normal = trm*ref_cm.normal;
@@ -127,6 +141,15 @@ namespace grynca {
         }
     }
 
+    inline bool OverlapHelper::calcDistance(DistanceInfo& di_out, f32 max_dist) {
+        PROFILE_BLOCK("OverlapHelper::calcDistance()");
+        DistanceF_ f;
+        f.oh = this;
+        f.di_out = &di_out;
+        f.max_dist = max_dist;
+        return dispatchTypes_(shapes_[0]->getTypeId(), shapes_[1]->getTypeId(), f);
+    }
+
     inline const ContactManifold& OverlapHelper::getContactManifoldG()const {
         return cm_g_;
     }
@@ -151,6 +174,88 @@ namespace grynca {
         return cm_l_[1];
     }
 
+    inline void OverlapHelper::overlapsBatch(const OverlapPair* pairs, u32 pairs_cnt, bool* overlaps_out, ContactManifold* cms_out) {
+        PROFILE_BLOCK("OverlapHelper::overlapsBatch()");
+        static constexpr u32 types_cnt = ShapeTypes::getTypesCount();
+        static constexpr u32 combos_cnt = types_cnt*types_cnt;
+
+        BatchF_ f;
+        f.oh = this;
+        f.pairs = pairs;
+        f.overlaps_out = overlaps_out;
+        f.cms_out = cms_out;
+        batch_order_.resize(std::min(pairs_cnt, u32(BatchChunkSize_)));
+        // pairs are bucketed in chunks so that shapes data stay in cache
+        for (u32 chunk_start=0; chunk_start<pairs_cnt; chunk_start+=BatchChunkSize_) {
+            u32 chunk_end = std::min(chunk_start+BatchChunkSize_, pairs_cnt);
+
+            // counting sort of pairs by types combination
+            u32 offsets[combos_cnt+1] = {};
+            for (u32 i=chunk_start; i<chunk_end; ++i) {
+                u32 combo = pairs[i].shapes[0]->getTypeId()*types_cnt + pairs[i].shapes[1]->getTypeId();
+                ++offsets[combo+1];
+            }
+            for (u32 c=0; c<combos_cnt; ++c) {
+                offsets[c+1] += offsets[c];
+            }
+            u32 fill[combos_cnt];
+            memcpy(fill, offsets, sizeof(fill));
+            for (u32 i=chunk_start; i<chunk_end; ++i) {
+                u32 combo = pairs[i].shapes[0]->getTypeId()*types_cnt + pairs[i].shapes[1]->getTypeId();
+                batch_order_[fill[combo]++] = i;
+            }
+
+            for (u32 c=0; c<combos_cnt; ++c) {
+                f.pairs_cnt = offsets[c+1] - offsets[c];
+                if (!f.pairs_cnt)
+                    continue;
+                f.pair_ids = &batch_order_[offsets[c]];
+                dispatchTypes_(c/types_cnt, c%types_cnt, f);
+            }
+        }
+    }
+
+    template <typename ShapeT>
+    struct OverlapHelper::RefPriority_ {
+        // new shape types are targets of existing ones
+        static constexpr u32 value = 0;
+    };
+
+    template <> struct OverlapHelper::RefPriority_<Circle> { static constexpr u32 value = 0; };
+    template <> struct OverlapHelper::RefPriority_<Ray> { static constexpr u32 value = 1; };
+    template <> struct OverlapHelper::RefPriority_<Rect> { static constexpr u32 value = 2; };
+    template <> struct OverlapHelper::RefPriority_<ARect> { static constexpr u32 value = 3; };
+    template <> struct OverlapHelper::RefPriority_<Pgon> { static constexpr u32 value = 4; };
+
+    template <typename ShapeT>
+    struct OverlapHelper::TargetRslt_ {
+        typedef ShapeT Type;
+    };
+
+    template <>
+    struct OverlapHelper::TargetRslt_<ARect> {
+        // make Rect from target ARect so that it can be transformed (rotated) to ref. frame
+        typedef Rect Type;
+    };
+
+    template <typename Func>
+    struct OverlapHelper::DispatchE_ {
+        template <typename ShapeAT, typename ShapeBT>
+        static bool call(Func& f) {
+            // A is reference for same priorities
+            static constexpr bool ref_is_b = RefPriority_<ShapeBT>::value > RefPriority_<ShapeAT>::value;
+            typedef std::conditional_t<ref_is_b, ShapeBT, ShapeAT> RefShapeT;
+            typedef std::conditional_t<ref_is_b, ShapeAT, ShapeBT> TargetShapeT;
+            return f.template call<RefShapeT, TargetShapeT, typename TargetRslt_<TargetShapeT>::Type>(ref_is_b);
+        }
+    };
+
+    template <typename Func>
+    inline bool OverlapHelper::dispatchTypes_(i32 tid_a, i32 tid_b, Func& f) {
+        // static
+        return ShapePairTable<DispatchE_<Func> >::get(tid_a, tid_b)(f);
+    }
+
     inline void OverlapHelper::changeRefShape_() {
         ref_shape_id_ = 1-ref_shape_id_;
         normal_mult_ *= -1;
@@ -158,15 +263,77 @@ namespace grynca {
 
     template <typename RefShapeT, typename TargetShapeT, typename TargetShapeRsltT>
     inline bool OverlapHelper::overlapsInner_() {
-        tr_target_shape_.set<TargetShapeRsltT>(shapes_[1-ref_shape_id_]->get<TargetShapeT>());
         target_to_ref_tr_ = (-shape_tr_[ref_shape_id_])*shape_tr_[1-ref_shape_id_];
-
-        TargetShapeRsltT& ts = tr_target_shape_.acc<TargetShapeRsltT>();
-        ts.transform(target_to_ref_tr_);
+        const TargetShapeRsltT& ts = Target_<TargetShapeRsltT>::set(*this, shapes_[1-ref_shape_id_]->get<TargetShapeT>(), target_to_ref_tr_);
+        calc_contact_f_ = &OverlapHelper::calcContactInner_<RefShapeT, TargetShapeRsltT>;
         const RefShapeT& rs = shapes_[ref_shape_id_]->get<RefShapeT>();
         return rs.overlaps(ts, otmp_);
     }
 
+    template <typename RefShapeT, typename TargetShapeRsltT>
+    inline void OverlapHelper::calcContactInner_(ContactManifold& cm_out) {
+        const RefShapeT& rs = shapes_[ref_shape_id_]->get<RefShapeT>();
+        rs.calcContact(Target_<TargetShapeRsltT>::get(*this), otmp_, cm_out);
+    }
+
+    template <typename RefShapeT, typename TargetShapeT, typename TargetShapeRsltT>
+    inline bool OverlapHelper::calcDistanceInner_(DistanceInfo& di_out, f32 max_dist) {
+        target_to_ref_tr_ = (-shape_tr_[ref_shape_id_])*shape_tr_[1-ref_shape_id_];
+        const TargetShapeRsltT& ts = Target_<TargetShapeRsltT>::set(*this, shapes_[1-ref_shape_id_]->get<TargetShapeT>(), target_to_ref_tr_);
+        const RefShapeT& rs = shapes_[ref_shape_id_]->get<RefShapeT>();
+        // ref. frame is scaled, global distance >= local distance*min(|scale|)
+        const Vec2& ref_scale = shape_tr_[ref_shape_id_].getScale();
+        f32 min_scale = std::min(fabsf(ref_scale.getX()), fabsf(ref_scale.getY()));
+        f32 local_max_dist = std::numeric_limits<f32>::max();
+        if (max_dist < local_max_dist*min_scale)
+            local_max_dist = max_dist/min_scale;
+        GJK2D<RefShapeT, TargetShapeRsltT> gjk;
+        gjk.setShapes(rs, ts);
+        if (!gjk.calcDistance(di_out, local_max_dist))
+            return false;
+        if (di_out.distance == 0.0f)
+            return true;
+
+        // to global frame (ref. frame may be scaled -> distance is recalculated)
+        Affine2 trm = shape_tr_[ref_shape_id_].calcAffine();
+        Vec2 ref_pt = trm*di_out.point_a;
+        Vec2 target_pt = trm*di_out.point_b;
+        di_out.point_a = ref_shape_id_?target_pt:ref_pt;
+        di_out.point_b = ref_shape_id_?ref_pt:target_pt;
+        Vec2 ba = di_out.point_a - di_out.point_b;
+        di_out.distance = ba.getLen();
+        di_out.normal = ba/di_out.distance;
+        return di_out.distance <= max_dist;
+    }
+
+    template <typename RefShapeT, typename TargetShapeT, typename TargetShapeRsltT>
+    inline void OverlapHelper::overlapsBatchInner_(const OverlapPair* pairs, const u32* pair_ids, u32 pairs_cnt, bool ref_is_b,
+                                                   bool* overlaps_out, ContactManifold* cms_out)
+    {
+        u32 ref_id = ref_is_b?1:0;
+        f32 normal_mult = ref_is_b?-1.0f:1.0f;
+        for (u32 i=0; i<pairs_cnt; ++i) {
+            u32 pair_id = pair_ids[i];
+            const OverlapPair& p = pairs[pair_id];
+            const Transform& ref_tr = *p.transforms[ref_id];
+
+            Transform target_to_ref_tr = (-ref_tr)*(*p.transforms[1-ref_id]);
+            const TargetShapeRsltT& ts = Target_<TargetShapeRsltT>::set(*this, p.shapes[1-ref_id]->get<TargetShapeT>(), target_to_ref_tr);
+            const RefShapeT& rs = p.shapes[ref_id]->get<RefShapeT>();
+            bool overlap = rs.overlaps(ts, otmp_);
+            overlaps_out[pair_id] = overlap;
+            if (!overlap || !cms_out)
+                continue;
+
+            ContactManifold& cm = cms_out[pair_id];
+            rs.calcContact(ts, otmp_, cm);
+            Affine2 trm = ref_tr.calcAffine();
+            cm.normal *= normal_mult;
+            cm.normal = trm*cm.normal;
+            for (u32 j=0; j<cm.size; ++j) {
+                cm.points[j].position = trm*cm.points[j].position;
+            }
+        }
+    }
 }
 
-#undef TID
\ No newline at end of file
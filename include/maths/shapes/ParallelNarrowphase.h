@@ -0,0 +1,32 @@
+#ifndef PARALLELNARROWPHASE_H
+#define PARALLELNARROWPHASE_H
+
+#include "OverlapHelper.h"
+#include "../TaskPool.h"
+
+namespace grynca {
+
+    // overlapsBatch() with pairs split to chunks processed by TaskPool threads
+    //  - each thread has its own OverlapHelper (its scratch is never shared)
+    //  - results are written at pair indices, so they are the same as of single threaded batch (independent of scheduling)
+    //  - lazy Pgon normals of input shapes are calculated up front (shapes are only read by threads)
+    class ParallelNarrowphase {
+    public:
+        // threads count including calling thread, 0 for hardware concurrency
+        ParallelNarrowphase(u32 threads_cnt = 0, u32 chunk_size = 256);
+
+        u32 getThreadsCount()const;
+        u32 getChunkSize()const;
+
+        // same as OverlapHelper::overlapsBatch()
+        void overlapsBatch(const OverlapPair* pairs, u32 pairs_cnt, bool* overlaps_out, ContactManifold* cms_out = NULL);
+    private:
+        TaskPool pool_;
+        u32 chunk_size_;
+        fast_vector<OverlapHelper> helpers_;        // per thread
+    };
+
+}
+
+#include "ParallelNarrowphase.inl"
+#endif //PARALLELNARROWPHASE_H
@@ -0,0 +1,35 @@
+#include "ParallelNarrowphase.h"
+
+namespace grynca {
+
+    inline ParallelNarrowphase::ParallelNarrowphase(u32 threads_cnt, u32 chunk_size)
+     : pool_(threads_cnt), chunk_size_(chunk_size), helpers_(pool_.getThreadsCount())
+    {
+        ASSERT(chunk_size_ > 0);
+    }
+
+    inline u32 ParallelNarrowphase::getThreadsCount()const {
+        return pool_.getThreadsCount();
+    }
+
+    inline u32 ParallelNarrowphase::getChunkSize()const {
+        return chunk_size_;
+    }
+
+    inline void ParallelNarrowphase::overlapsBatch(const OverlapPair* pairs, u32 pairs_cnt, bool* overlaps_out, ContactManifold* cms_out) {
+        PROFILE_BLOCK("ParallelNarrowphase::overlapsBatch()");
+        for (u32 i=0; i<pairs_cnt; ++i) {
+            for (u32 j=0; j<2; ++j) {
+                if (pairs[i].shapes[j]->getTypeId() == Shape::getTypeIdOf<Pgon>())
+                    pairs[i].shapes[j]->get<Pgon>().calculateNormalsIfNeeded();
+            }
+        }
+
+        u32 chunks_cnt = (pairs_cnt + chunk_size_ - 1)/chunk_size_;
+        pool_.parallelFor(chunks_cnt, [&](u32 chunk_id, u32 thread_id) {
+            u32 start = chunk_id*chunk_size_;
+            u32 cnt = std::min(chunk_size_, pairs_cnt - start);
+            helpers_[thread_id].overlapsBatch(pairs+start, cnt, overlaps_out+start, cms_out?cms_out+start:NULL);
+        });
+    }
+}
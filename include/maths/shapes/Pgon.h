@@ -2,6 +2,7 @@
 #define POLYGON_H
 
 #include "../maths_config.h"
+#include "../FixedVector.h"
 #include "types/Mask.h"
 #include "shapes_fw.h"
 
@@ -14,16 +15,31 @@ namespace grynca {
 
         Pgon();
         Pgon(const Vec2* points, u32 points_cnt);
+#if MATHS_PGON_INLINE_STORAGE
+        Pgon(const Pgon& p) = default;
+        Pgon& operator=(const Pgon& p) = default;
+#else
         Pgon(const Pgon& p);
+#endif
         Pgon(Pgon&& p) = default;
 
         ARect calcARectBound()const;
         // changes "this"
         void transform(const Mat3& tr);
+        void transform(const Affine2& tr);
         void transform(const Transform& tr);
+        // also calculates bound of transformed points (same pass, pgon must not be empty as for calcARectBound())
+        void transform(const Affine2& tr, ARect& bound_out);
         // returns new transformed obj
         Pgon transformOut(const Mat3& tr)const;
+        Pgon transformOut(const Affine2& tr)const;
         Pgon transformOut(const Transform& tr)const;
+        // sets "this" to transformed src, reuses already allocated memory
+        void setTransformed(const Pgon& src, const Mat3& tr);
+        void setTransformed(const Pgon& src, const Affine2& tr);
+        void setTransformed(const Pgon& src, const Transform& tr);
+        // with bound of transformed points (src must not be empty)
+        void setTransformed(const Pgon& src, const Affine2& tr, ARect& bound_out);
 
         bool isPointInside(const Vec2& p)const;
         f32 calcArea()const;
@@ -61,6 +77,9 @@ namespace grynca {
         void reverse();
         Vec2 calcSupport(const Dir2& dir)const;
         Vec2 calcSupport(const Dir2& dir, u32& pt_id_out)const;
+        // hill-climbs from pt_id_io (e.g. previous support) over neighbours, stores support id to pt_id_io
+        //  - pgon must be convex, falls back to full search on flat spots
+        Vec2 calcSupportFrom(const Dir2& dir, u32& pt_id_io)const;
         u32 findNearestPointTo(const Vec2& target_pt, f32& dist_sqr_out)const;
         ARect calcTightAABB() const;
         ARect calcFatAABB(const Vec2& fatness) const;
@@ -99,13 +118,28 @@ namespace grynca {
         void calcContact(const Pgon& p, OverlapTmp& otmp, ContactManifold& cm_out)const;
     private:
         void calculateNormals_()const;
+        // only GJK simplex is kept in OverlapTmp, GJK2D is rebuilt from it in calcContact()
+        template <typename ShapeT>
+        bool overlapsGJK_(const ShapeT& s, OverlapTmp& otmp)const;
+        template <typename ShapeT>
+        void calcContactGJK_(const ShapeT& s, OverlapTmp& otmp, ContactManifold& cm_out)const;
 
         static constexpr u32 BitsForEdgeId_ = floorLog2(MATHS_MAX_PGON_SIZE);
+        // longer walks are slower than (SIMD) full search
+        static constexpr u32 MaxClimbSteps_ = MATHS_PGON_MAX_CLIMB_STEPS;
+
+#if MATHS_PGON_INLINE_STORAGE
+        template <typename T>
+        using Storage_ = FixedVector<T, MATHS_MAX_PGON_SIZE>;
+#else
+        template <typename T>
+        using Storage_ = fast_vector<T>;
+#endif
 
         mutable Mask<MATHS_MAX_PGON_SIZE> dirty_normals_;
 
-        fast_vector<Vec2> points_;
-        mutable fast_vector<Dir2> normals_;
+        Storage_<Vec2> points_;
+        mutable Storage_<Dir2> normals_;
     };
 
     class PgonModifier {
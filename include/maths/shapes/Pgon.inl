@@ -18,36 +18,49 @@ namespace grynca {
         dirty_normals_.set();
     }
 
+#if !MATHS_PGON_INLINE_STORAGE
     inline Pgon::Pgon(const Pgon& p)
      : dirty_normals_(p.dirty_normals_),
        points_(p.points_),
        normals_(p.normals_)
     {
     }
+#endif
 
     inline ARect Pgon::calcARectBound()const {
         return ARect(&points_[0], u32(points_.size()));
     }
 
     inline void Pgon::transform(const Mat3& tr) {
-        for (u32 i=0; i<points_.size(); ++i) {
-            points_[i] = tr*points_[i];
-        }
+        transform(Affine2(tr));
+    }
+
+    inline void Pgon::transform(const Affine2& tr) {
+        tr.transformPoints(points_.begin(), u32(points_.size()), points_.begin());
         if (!normals_.empty() || dirty_normals_.any()) {
             invalidateNormals();
         }
     }
 
     inline void Pgon::transform(const Transform& tr) {
-        transform(tr.calcMatrix());
+        transform(tr.calcAffine());
+    }
+
+    inline void Pgon::transform(const Affine2& tr, ARect& bound_out) {
+        tr.transformPoints(points_.begin(), u32(points_.size()), points_.begin(), bound_out.accBounds()[0], bound_out.accBounds()[1]);
+        if (!normals_.empty() || dirty_normals_.any()) {
+            invalidateNormals();
+        }
     }
 
     inline Pgon Pgon::transformOut(const Mat3& tr)const {
+        return transformOut(Affine2(tr));
+    }
+
+    inline Pgon Pgon::transformOut(const Affine2& tr)const {
         Pgon rslt;
         rslt.points_.resize(points_.size());
-        for (u32 i=0; i<points_.size(); ++i) {
-            rslt.points_[i] = tr*points_[i];
-        }
+        tr.transformPoints(points_.begin(), u32(points_.size()), rslt.points_.begin());
         if (!normals_.empty() || dirty_normals_.any()) {
             rslt.invalidateNormals();
         }
@@ -55,7 +68,29 @@ namespace grynca {
     }
 
     inline Pgon Pgon::transformOut(const Transform& tr)const {
-        return transformOut(tr.calcMatrix());
+        return transformOut(tr.calcAffine());
+    }
+
+    inline void Pgon::setTransformed(const Pgon& src, const Mat3& tr) {
+        setTransformed(src, Affine2(tr));
+    }
+
+    inline void Pgon::setTransformed(const Pgon& src, const Affine2& tr) {
+        ASSERT(&src != this);
+        points_.resize(src.points_.size());
+        tr.transformPoints(src.points_.begin(), u32(points_.size()), points_.begin());
+        invalidateNormals();
+    }
+
+    inline void Pgon::setTransformed(const Pgon& src, const Transform& tr) {
+        setTransformed(src, tr.calcAffine());
+    }
+
+    inline void Pgon::setTransformed(const Pgon& src, const Affine2& tr, ARect& bound_out) {
+        ASSERT(&src != this);
+        points_.resize(src.points_.size());
+        tr.transformPoints(src.points_.begin(), u32(points_.size()), points_.begin(), bound_out.accBounds()[0], bound_out.accBounds()[1]);
+        invalidateNormals();
     }
 
     inline bool Pgon::isPointInside(const Vec2& p)const {
@@ -255,6 +290,52 @@ namespace grynca {
         return points_[pt_id_out];
     }
 
+    inline Vec2 Pgon::calcSupportFrom(const Dir2& dir, u32& pt_id_io)const {
+        ASSERT_M(points_.size(), "dont call on empty pgon");
+        u32 cnt = (u32)points_.size();
+        if (cnt < 3) {
+            return calcSupport(dir, pt_id_io);
+        }
+
+        u32 id = (pt_id_io < cnt) ? pt_id_io : 0;
+        f32 proj = dot(points_[id], dir);
+        u32 next = (id+1 == cnt) ? 0 : id+1;
+        u32 prev = (id == 0) ? cnt-1 : id-1;
+        f32 next_proj = dot(points_[next], dir);
+        f32 prev_proj = dot(points_[prev], dir);
+
+        if (next_proj == proj || prev_proj == proj) {
+            // flat spot (edge perpendicular to dir) can be minimum as well
+            return calcSupport(dir, pt_id_io);
+        }
+        if (next_proj > proj) {
+            // walk forward
+            for (u32 steps=0; next_proj > proj; ++steps) {
+                if (steps == MaxClimbSteps_) {
+                    return calcSupport(dir, pt_id_io);
+                }
+                id = next;
+                proj = next_proj;
+                next = (id+1 == cnt) ? 0 : id+1;
+                next_proj = dot(points_[next], dir);
+            }
+        }
+        else if (prev_proj > proj) {
+            // walk backward
+            for (u32 steps=0; prev_proj > proj; ++steps) {
+                if (steps == MaxClimbSteps_) {
+                    return calcSupport(dir, pt_id_io);
+                }
+                id = prev;
+                proj = prev_proj;
+                prev = (id == 0) ? cnt-1 : id-1;
+                prev_proj = dot(points_[prev], dir);
+            }
+        }
+        pt_id_io = id;
+        return points_[id];
+    }
+
     inline bool Pgon::isClockwise()const {
         f32 area = 0;
         loopEdges([&area](const Vec2& p1, const Vec2& p2, u32&) {
@@ -409,15 +490,12 @@ namespace grynca {
     }
 
     inline bool Pgon::overlaps(const ARect& ar, OverlapTmp& otmp)const {
-        otmp.pgon_arect_.gjk.setShapes(*this, ar);
-        return otmp.pgon_arect_.gjk.isOverlapping();
+        return overlapsGJK_(ar, otmp);
     }
 
     inline void Pgon::calcContact(const ARect& ar, OverlapTmp& otmp, ContactManifold& cm_out)const {
-        UNUSED(ar);
         calculateNormalsIfNeeded();
-        otmp.pgon_arect_.gjk.calcPenetrationInfo();
-        cm_out = otmp.pgon_arect_.gjk.getContactManifold();
+        calcContactGJK_(ar, otmp, cm_out);
     }
 
     inline bool Pgon::overlaps(const Circle& c, OverlapTmp& otmp)const {
@@ -425,6 +503,7 @@ namespace grynca {
         ASSERT(getSize() > 2);
         calculateNormalsIfNeeded();
         // pgon edges
+        otmp.pgon_circle_.min_pen = std::numeric_limits<f32>::max();
         for (u32 i = 0; i<getSize(); ++i) {
             const Vec2& vert = getPoint(i);
             const Dir2& normal = getNormal(i);
@@ -433,10 +512,14 @@ namespace grynca {
 
             f32 pen1 = vert_proj - (cc_proj+c.getRadius());
             f32 pen2 = vert_proj - (cc_proj-c.getRadius());
-            otmp.pgon_circle_.pen[i] = std::max(pen1, pen2);
-            if (otmp.pgon_circle_.pen[i] < maths::EPS) {
+            f32 pen = std::max(pen1, pen2);
+            if (pen < maths::EPS) {
                 return false;
             }
+            if (pen < otmp.pgon_circle_.min_pen) {
+                otmp.pgon_circle_.min_pen = pen;
+                otmp.pgon_circle_.min_pen_id = i;
+            }
         }
 
         // project on axis between circle center & nearest point
@@ -455,8 +538,8 @@ namespace grynca {
 
     inline void Pgon::calcContact(const Circle& c, OverlapTmp& otmp, ContactManifold& cm_out)const {
         // min penetration for projections on normals
-        u32 min_id = u32(std::min_element(otmp.pgon_circle_.pen, otmp.pgon_circle_.pen+getSize()) - otmp.pgon_circle_.pen);
-        f32 min_pen = otmp.pgon_circle_.pen[min_id];
+        u32 min_id = otmp.pgon_circle_.min_pen_id;
+        f32 min_pen = otmp.pgon_circle_.min_pen;
 
         cm_out.size = 1;
         // project point on closest edge
@@ -558,28 +641,41 @@ namespace grynca {
     }
 
     inline bool Pgon::overlaps(const Rect& r, OverlapTmp& otmp)const {
-        otmp.pgon_rect_.gjk.setShapes(*this, r);
-        return otmp.pgon_rect_.gjk.isOverlapping();
+        return overlapsGJK_(r, otmp);
     }
 
     inline void Pgon::calcContact(const Rect& r, OverlapTmp& otmp, ContactManifold& cm_out)const {
-        UNUSED(r);
         calculateNormalsIfNeeded();
-        otmp.pgon_rect_.gjk.calcPenetrationInfo();
-        cm_out = otmp.pgon_rect_.gjk.getContactManifold();
+        calcContactGJK_(r, otmp, cm_out);
     }
 
     inline bool Pgon::overlaps(const Pgon& p, OverlapTmp& otmp)const {
-        otmp.pgon_pgon_.gjk.setShapes(*this, p);
-        return otmp.pgon_pgon_.gjk.isOverlapping();
+        return overlapsGJK_(p, otmp);
     }
 
     inline void Pgon::calcContact(const Pgon& p, OverlapTmp& otmp, ContactManifold& cm_out)const {
-        UNUSED(p);
         calculateNormalsIfNeeded();
         p.calculateNormalsIfNeeded();
-        otmp.pgon_pgon_.gjk.calcPenetrationInfo();
-        cm_out = otmp.pgon_pgon_.gjk.getContactManifold();
+        calcContactGJK_(p, otmp, cm_out);
+    }
+
+    template <typename ShapeT>
+    inline bool Pgon::overlapsGJK_(const ShapeT& s, OverlapTmp& otmp)const {
+        GJK2D<Pgon, ShapeT> gjk;
+        gjk.setShapes(*this, s);
+        if (!gjk.isOverlapping())
+            return false;
+        gjk.storeSimplex(otmp.pgon_gjk_.simplex);
+        return true;
+    }
+
+    template <typename ShapeT>
+    inline void Pgon::calcContactGJK_(const ShapeT& s, OverlapTmp& otmp, ContactManifold& cm_out)const {
+        GJK2D<Pgon, ShapeT> gjk;
+        gjk.setShapes(*this, s);
+        gjk.restoreSimplex(otmp.pgon_gjk_.simplex);
+        gjk.calcPenetrationInfo();
+        cm_out = gjk.getContactManifold();
     }
 
     inline void Pgon::calculateNormals_()const {
@@ -68,12 +68,18 @@ namespace grynca {
         ARect calcARectBound()const;
         // changes "this"
         void transform(const Mat3& tr);
+        void transform(const Affine2& tr);
         void transform(const Transform& tr);
         // returns new transformed obj
         Ray transformOut(const Mat3& tr)const;
+        Ray transformOut(const Affine2& tr)const;
         Ray transformOut(const Transform& tr)const;
 
         Vec2 calcSupport(const Dir2& dir)const;
+        // point ids: 0 - start, 1 - end
+        Vec2 calcSupport(const Dir2& dir, u32& pt_id_out)const;
+        Vec2 calcSupportFrom(const Dir2& dir, u32& pt_id_io)const;     // same as calcSupport(), for GJK
+        Vec2 getPoint(u32 pt_id)const;
 
         // eps is tolerance in distance from ray direction
         bool isPointInside(const Vec2& p, f32 eps = maths::EPS)const;
@@ -128,11 +128,19 @@ namespace grynca {
         *this = transformOut(tr);
     }
 
+    inline void Ray::transform(const Affine2& tr) {
+        *this = transformOut(tr);
+    }
+
     inline void Ray::transform(const Transform& tr) {
         *this = transformOut(tr);
     }
 
     inline Ray Ray::transformOut(const Mat3& tr)const {
+        return transformOut(Affine2(tr));
+    }
+
+    inline Ray Ray::transformOut(const Affine2& tr)const {
         Ray rslt(tr*getStart(), tr*getEnd());
         if (isDirNormalized()) {
             rslt.normalize_(rslt.dir_, rslt.length_, rslt.flags_);
@@ -144,7 +152,7 @@ namespace grynca {
     }
 
     inline Ray Ray::transformOut(const Transform& tr)const {
-        return transformOut(tr.calcMatrix());
+        return transformOut(tr.calcAffine());
     }
 
     inline Vec2 Ray::calcSupport(const Dir2& dir)const {
@@ -154,6 +162,19 @@ namespace grynca {
                 :getStart();
     }
 
+    inline Vec2 Ray::calcSupport(const Dir2& dir, u32& pt_id_out)const {
+        pt_id_out = (dot(dir, dir_)>0.0f)?1:0;
+        return getPoint(pt_id_out);
+    }
+
+    inline Vec2 Ray::calcSupportFrom(const Dir2& dir, u32& pt_id_io)const {
+        return calcSupport(dir, pt_id_io);
+    }
+
+    inline Vec2 Ray::getPoint(u32 pt_id)const {
+        return pt_id?getEnd():getStart();
+    }
+
     inline bool Ray::isPointInside(const Vec2& p, f32 eps)const {
         Dir2 dir = getDir();
         Dir2 n = dir.perpL();
@@ -289,7 +310,7 @@ namespace grynca {
         cm_out.size = 1;
         cm_out.normal = -getDir();
         cm_out.points[0].penetration = (1.0f - otmp.ray_ray_.t) * getLength();
-        cm_out.points[1].position = getStart() + otmp.ray_ray_.t * otmp.ray_ray_.rv1;
+        cm_out.points[0].position = getStart() + otmp.ray_ray_.t * otmp.ray_ray_.rv1;
     }
 
     inline bool Ray::overlaps(const Rect& r, OverlapTmp& otmp)const {
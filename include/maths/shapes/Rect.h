@@ -16,7 +16,7 @@ namespace grynca {
         Rect(const Vec2& position, const Vec2& size);       // offset = {0,0} - position at left-top corner
         Rect(const Vec2& position, const Vec2& size , const Vec2& offset, Angle rot = 0);
         Rect(const Vec2& position, const Vec2& size, const Vec2& offset, const Dir2& rot_dir);
-        Rect(const Vec2& position, const Vec2& size, const Vec2& offset, Angle rot, const Dir2& rot_dir);
+        Rect(const Vec2& position, const Vec2& size, const Vec2& offset, Angle rot, const Dir2& rot_dir);     // only rot_dir is kept
         Rect(const ARect& arect);
 
         Vec2 getLeftTop()const;
@@ -32,7 +32,7 @@ namespace grynca {
         const Vec2& getPosition()const;
         const Vec2& getSize()const;
         const Vec2& getOffset()const;
-        const Angle& getRotation()const;
+        Angle getRotation()const;     // calculated from rot. dir (-Pi..Pi, rotations past Pi are wrapped)
 
         bool isZero();
 
@@ -40,16 +40,20 @@ namespace grynca {
         void setSize(const Vec2& s);
         void setOffset(const Vec2& o);
         void setRotation(const Angle& rot);
+        void setRotation(const Dir2& rot_dir);
 
         ARect calcARectBound()const;
         // changes "this"
         void transform(const Mat3& tr);
+        void transform(const Affine2& tr);
         void transform(const Transform& tr);
         // returns new transformed obj
         Rect transformOut(const Mat3& tr)const;
+        Rect transformOut(const Affine2& tr)const;
         Rect transformOut(const Transform& tr)const;
         Vec2 calcSupport(const Dir2& dir)const;
         Vec2 calcSupport(const Dir2& dir, u32& pt_id_out)const;
+        Vec2 calcSupportFrom(const Dir2& dir, u32& pt_id_io)const;     // same as calcSupport(), for GJK
         Vec2 getPoint(u32 pt_id)const;
         Dir2 getNormal(u32 pt_id)const;
         Dir2 getEdgeDir(u32 pt_id)const;
@@ -98,6 +102,10 @@ namespace grynca {
         Vec2 getRT_(const Vec2& rot_offset)const;
         Vec2 getRB_(const Vec2& rot_offset)const;
         Vec2 getLB_(const Vec2& rot_offset)const;
+        // shapes transformed to local space (of ARect(getOffset(), getSize())),
+        //  recalculated in calcContact() so they need not be kept in OverlapTmp
+        Circle calcLocalCircle_(const Circle& c)const;
+        Ray calcLocalRay_(const Ray& r)const;
 
         void computeIncidentEdge_(ClipVertex *c, const Vec2 &h, const Vec2 &center, const Dir2 &rot_dir,
                                   const Vec2 &normal)const;
@@ -108,7 +116,6 @@ namespace grynca {
         Vec2 position_;
         Vec2 size_;
         Vec2 offset_;  // vector offsetting rotation center (from left-top)
-        Angle rotation_;
         Dir2 rot_dir_;      // (cos, sin), first col. of 2x2 rot. matrix
     };
 }
@@ -8,26 +8,24 @@
 namespace grynca {
 
     inline Rect::Rect()
-     : position_(0,0), size_(0, 0), offset_(0,0), rotation_(0), rot_dir_(1.0f, 0.0f)
+     : position_(0,0), size_(0, 0), offset_(0,0), rot_dir_(1.0f, 0.0f)
     {}
 
     inline Rect::Rect(const Vec2& position, const Vec2& size)
-     : position_(position), size_(size), offset_(0,0), rotation_(0), rot_dir_(1.0f, 0.0f)
+     : position_(position), size_(size), offset_(0,0), rot_dir_(1.0f, 0.0f)
     {}
 
     inline Rect::Rect(const Vec2& position, const Vec2& size, const Vec2& offset, Angle rot)
-     : position_(position), size_(size), offset_(offset), rotation_(rot), rot_dir_(rot.getDir())
+     : position_(position), size_(size), offset_(offset), rot_dir_(rot.getDir())
     {
     }
 
     inline Rect::Rect(const Vec2& position, const Vec2& size, const Vec2& offset, const Dir2& rot_dir)
-     : position_(position), size_(size), offset_(offset), rotation_(rot_dir.getAngle()),
-       rot_dir_(rot_dir)
+     : position_(position), size_(size), offset_(offset), rot_dir_(rot_dir)
     {}
 
     inline Rect::Rect(const Vec2& position, const Vec2& size, const Vec2& offset, Angle rot, const Dir2& rot_dir)
-     : position_(position), size_(size), offset_(offset), rotation_(rot),
-       rot_dir_(rot_dir)
+     : position_(position), size_(size), offset_(offset), rot_dir_(rot_dir)
     {
 #ifdef DEBUG_BUILD
         ASSERT(fabsf(rot_dir.getAngle() - rot.normalize()) < maths::EPS);
@@ -35,7 +33,7 @@ namespace grynca {
     }
 
     inline Rect::Rect(const ARect& arect)
-     : position_(0, 0), size_(arect.getSize()), offset_(arect.getLeftTop()), rotation_(0.0f), rot_dir_(1.0f, 0.0f)
+     : position_(0, 0), size_(arect.getSize()), offset_(arect.getLeftTop()), rot_dir_(1.0f, 0.0f)
     {
     }
 
@@ -92,8 +90,8 @@ namespace grynca {
         return offset_;
     }
 
-    inline const Angle& Rect::getRotation()const {
-        return rotation_;
+    inline Angle Rect::getRotation()const {
+        return rot_dir_.getAngle();
     }
 
     inline bool Rect::isZero() {
@@ -113,10 +111,13 @@ namespace grynca {
     }
 
     inline void Rect::setRotation(const Angle& rot) {
-        rotation_ = rot;
         rot_dir_ = rot.getDir();
     }
 
+    inline void Rect::setRotation(const Dir2& rot_dir) {
+        rot_dir_ = rot_dir;
+    }
+
     inline ARect Rect::calcARectBound()const {
         Vec2 corners[4];
         getCorners(corners);
@@ -127,23 +128,28 @@ namespace grynca {
         transform(Transform(tr));
     }
 
+    inline void Rect::transform(const Affine2& tr) {
+        transform(Transform(tr));
+    }
+
     inline void Rect::transform(const Transform& tr) {
         position_ += tr.getPosition();
         size_ *= tr.getScale();
         offset_ *= tr.getScale();
-        rotation_ += tr.getRotation();
-        rot_dir_ = rotation_.getDir();
+        rot_dir_ = Angle::renormalizeRotDir(Angle::combineRotations(rot_dir_, tr.getRotDir()));
     }
 
     inline Rect Rect::transformOut(const Mat3& tr)const {
         return transformOut(Transform(tr));
     }
 
+    inline Rect Rect::transformOut(const Affine2& tr)const {
+        return transformOut(Transform(tr));
+    }
+
     inline Rect Rect::transformOut(const Transform& tr)const {
-        // TODO: find out why this does not work
-//        f32 new_sin = sinr_*tr.getRotCos() + cosr_*tr.getRotSin();
-//        f32 new_cos = cosr_*tr.getRotCos() + sinr_*tr.getRotSin();
-        return Rect(position_ + tr.getPosition(), size_*tr.getScale(), offset_*tr.getScale(), rotation_+tr.getRotation());
+        Dir2 rot_dir = Angle::renormalizeRotDir(Angle::combineRotations(rot_dir_, tr.getRotDir()));
+        return Rect(position_ + tr.getPosition(), size_*tr.getScale(), offset_*tr.getScale(), rot_dir);
     }
 
     inline Vec2 Rect::calcSupport(const Dir2& dir)const {
@@ -184,6 +190,10 @@ namespace grynca {
         return getLeftTop();
     }
 
+    inline Vec2 Rect::calcSupportFrom(const Dir2& dir, u32& pt_id_io)const {
+        return calcSupport(dir, pt_id_io);
+    }
+
     inline Vec2 Rect::getPoint(u32 pt_id)const {
         switch (pt_id) {
             case 0: return getLeftTop();
@@ -266,16 +276,12 @@ namespace grynca {
     inline bool Rect::overlaps(const Circle& c, OverlapTmp& otmp)const {
         // make Aligned Rectangle centered on {0,0}
         ARect ar(getOffset(), getSize());
-        // transform center to rect space
-        Vec2 transformed_center = c.getCenter()-getPosition();
-        transformed_center = transformed_center.rotateInverse(rot_dir_);
-        otmp.arect_circle_.transformed_c = Circle(transformed_center, c.getRadius());
-        return ar.overlaps(otmp.arect_circle_.transformed_c, otmp);
+        return ar.overlaps(calcLocalCircle_(c), otmp);
     }
 
     inline void Rect::calcContact(const Circle& c, OverlapTmp& otmp, ContactManifold& cm_out)const {
         ARect ar(getOffset(), getSize());
-        ar.calcContact(otmp.arect_circle_.transformed_c, otmp, cm_out);
+        ar.calcContact(calcLocalCircle_(c), otmp, cm_out);
 
         // rotate normal back
         cm_out.normal = cm_out.normal.rotate(rot_dir_);
@@ -289,22 +295,13 @@ namespace grynca {
     inline bool Rect::overlaps(const Ray& r, OverlapTmp& otmp)const {
         // make Aligned Rectangle centered on {0,0}
         ARect ar(getOffset(), getSize());
-
-        // transform Ray to its local space
-
-        Vec2 transformed_start = r.getStart() - getPosition();
-        transformed_start = transformed_start.rotateInverse(rot_dir_);
-        Dir2 transformed_dir = r.getDir().rotateInverse(rot_dir_);
-
-        otmp.arect_ray_.transformed_r = Ray(transformed_start, transformed_dir, r.getLength(), Ray::CalcDirInfo());
-
-        return ar.overlaps(otmp.arect_ray_.transformed_r, otmp);
+        return ar.overlaps(calcLocalRay_(r), otmp);
     }
 
     inline void Rect::calcContact(const Ray& r, OverlapTmp& otmp, ContactManifold& cm_out)const {
         // make Aligned Rectangle centered on {0,0}
         ARect ar(getOffset(), getSize());
-        ar.calcContact(otmp.arect_ray_.transformed_r, otmp, cm_out);
+        ar.calcContact(calcLocalRay_(r), otmp, cm_out);
 
         // rotate normal back
         cm_out.normal = cm_out.normal.rotate(rot_dir_);
@@ -319,16 +316,13 @@ namespace grynca {
         // SAT
         auto& tmp = otmp.rect_rect_;
 
-        tmp.hA = getSize()*0.5f;
-        tmp.hB = r.getSize()*0.5f;
+        Vec2 hA = getSize()*0.5f;
+        Vec2 hB = r.getSize()*0.5f;
 
         Dir2 irA = Angle::invertRotDir(rot_dir_);
         Dir2 irB = Angle::invertRotDir(r.rot_dir_);
 
-        tmp.cA = getCenter();
-        tmp.cB = r.getCenter();
-
-        Vec2 dp = tmp.cB - tmp.cA;
+        Vec2 dp = r.getCenter() - getCenter();
         tmp.dA = dp.rotate(irA);     // rotate by A inv.rot
         tmp.dB = dp.rotate(irB);     // rotate by B inv.rot
 
@@ -341,18 +335,22 @@ namespace grynca {
         Vec2 dB_abs(fabsf(tmp.dB.getX()), fabsf(tmp.dB.getY()));
 
         // Box A faces
-        tmp.faceA = dA_abs - tmp.hA - Vec2(dot(C1, tmp.hB), dot(C2, tmp.hB));
+        tmp.faceA = dA_abs - hA - Vec2(dot(C1, hB), dot(C2, hB));
         if (tmp.faceA.getX() > -maths::EPS || tmp.faceA.getY() > -maths::EPS) {
             return false;
         }
 
         // Box B faces
-        tmp.faceB = dB_abs - tmp.hB - Vec2(dot(C1, tmp.hA), dot(C2, tmp.hA));
+        tmp.faceB = dB_abs - hB - Vec2(dot(C1, hA), dot(C2, hA));
         return !(tmp.faceB.getX() > -maths::EPS || tmp.faceB.getY() > -maths::EPS);
     }
 
     inline void Rect::calcContact(const Rect& r, OverlapTmp& otmp, ContactManifold& cm_out)const {
         auto& tmp = otmp.rect_rect_;
+        Vec2 hA = getSize()*0.5f;
+        Vec2 hB = r.getSize()*0.5f;
+        Vec2 cA = getCenter();
+        Vec2 cB = r.getCenter();
 
         Dir2 rAY = rot_dir_.perpR();
         Dir2 rBY = r.rot_dir_.perpR();
@@ -364,20 +362,20 @@ namespace grynca {
         static const f32 relative_tol = 0.95f;
         static const f32 absolute_tol = 0.01f;
 
-        if (tmp.faceA.getY() > (sep * relative_tol + absolute_tol * tmp.hA.getY())) {
+        if (tmp.faceA.getY() > (sep * relative_tol + absolute_tol * hA.getY())) {
             axis = aFaceAY;
             sep = tmp.faceA.getY();
             normal = (tmp.dA.getY() > 0.0f) ? rAY : -rAY;
         }
 
         // Box B faces
-        if (tmp.faceB.getX() > (sep * relative_tol + absolute_tol * tmp.hB.getX())) {
+        if (tmp.faceB.getX() > (sep * relative_tol + absolute_tol * hB.getX())) {
             axis = aFaceBX;
             sep = tmp.faceB.getX();
             normal = (tmp.dB.getX() > 0.0f) ? r.rot_dir_ : -r.rot_dir_;
         }
 
-        if (tmp.faceB.getY() > (sep * relative_tol + absolute_tol * tmp.hB.getY())) {
+        if (tmp.faceB.getY() > (sep * relative_tol + absolute_tol * hB.getY())) {
             axis = aFaceBY;
             //sep = tmp.faceB.getY();
             normal = (tmp.dB.getY() > 0.0f) ? rBY : -rBY;
@@ -392,47 +390,47 @@ namespace grynca {
         switch (axis) {
             case aFaceAX: {
                 front_normal = normal;
-                front = dot(tmp.cA, front_normal) + tmp.hA.getX();
+                front = dot(cA, front_normal) + hA.getX();
                 side_normal = rAY;
-                f32 side = dot(tmp.cA, side_normal);
-                neg_side = -side + tmp.hA.getY();
-                pos_side =  side + tmp.hA.getY();
+                f32 side = dot(cA, side_normal);
+                neg_side = -side + hA.getY();
+                pos_side =  side + hA.getY();
                 ref_neg_edge = EDGE1;
                 ref_pos_edge = EDGE3;
-                computeIncidentEdge_(incident_edge, tmp.hB, tmp.cB, r.rot_dir_, front_normal);
+                computeIncidentEdge_(incident_edge, hB, cB, r.rot_dir_, front_normal);
             }break;
             case aFaceAY: {
                 front_normal = normal;
-                front = dot(tmp.cA, front_normal) + tmp.hA.getY();
+                front = dot(cA, front_normal) + hA.getY();
                 side_normal = rot_dir_;
-                f32 side = dot(tmp.cA, side_normal);
-                neg_side = -side + tmp.hA.getX();
-                pos_side =  side + tmp.hA.getX();
+                f32 side = dot(cA, side_normal);
+                neg_side = -side + hA.getX();
+                pos_side =  side + hA.getX();
                 ref_neg_edge = EDGE4;
                 ref_pos_edge = EDGE2;
-                computeIncidentEdge_(incident_edge, tmp.hB, tmp.cB, r.rot_dir_, front_normal);
+                computeIncidentEdge_(incident_edge, hB, cB, r.rot_dir_, front_normal);
             }break;
             case aFaceBX: {
                 front_normal = -normal;
-                front = dot(tmp.cB, front_normal) + tmp.hB.getX();
+                front = dot(cB, front_normal) + hB.getX();
                 side_normal = rBY;
-                f32 side = dot(tmp.cB, side_normal);
-                neg_side = -side + tmp.hB.getY();
-                pos_side =  side + tmp.hB.getY();
+                f32 side = dot(cB, side_normal);
+                neg_side = -side + hB.getY();
+                pos_side =  side + hB.getY();
                 ref_neg_edge = EDGE1;
                 ref_pos_edge = EDGE3;
-                computeIncidentEdge_(incident_edge, tmp.hA, tmp.cA, rot_dir_, front_normal);
+                computeIncidentEdge_(incident_edge, hA, cA, rot_dir_, front_normal);
             }break;
             case aFaceBY: {
                 front_normal = -normal;
-                front = dot(tmp.cB, front_normal) + tmp.hB.getY();
+                front = dot(cB, front_normal) + hB.getY();
                 side_normal = r.rot_dir_;;
-                f32 side = dot(tmp.cB, side_normal);
-                neg_side = -side + tmp.hB.getX();
-                pos_side =  side + tmp.hB.getX();
+                f32 side = dot(cB, side_normal);
+                neg_side = -side + hB.getX();
+                pos_side =  side + hB.getX();
                 ref_neg_edge = EDGE4;
                 ref_pos_edge = EDGE2;
-                computeIncidentEdge_(incident_edge, tmp.hA, tmp.cA, rot_dir_, front_normal);
+                computeIncidentEdge_(incident_edge, hA, cA, rot_dir_, front_normal);
             }break;
         }
 
@@ -501,6 +499,20 @@ namespace grynca {
         return getLT_(rot_offset)+(getHeightDir()*getSize().getY());
     }
 
+    inline Circle Rect::calcLocalCircle_(const Circle& c)const {
+        // transform center to rect space
+        Vec2 transformed_center = c.getCenter()-getPosition();
+        transformed_center = transformed_center.rotateInverse(rot_dir_);
+        return Circle(transformed_center, c.getRadius());
+    }
+
+    inline Ray Rect::calcLocalRay_(const Ray& r)const {
+        Vec2 transformed_start = r.getStart() - getPosition();
+        transformed_start = transformed_start.rotateInverse(rot_dir_);
+        Dir2 transformed_dir = r.getDir().rotateInverse(rot_dir_);
+        return Ray(transformed_start, transformed_dir, r.getLength(), Ray::CalcDirInfo());
+    }
+
     inline void Rect::computeIncidentEdge_(ClipVertex *c, const Vec2 &h, const Vec2 &center, const Dir2 &rot_dir, const Vec2 &normal)const {
         static constexpr f32 th = 0.707106781f;
         f32 cos = dot(rot_dir, normal);
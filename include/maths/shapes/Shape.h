@@ -3,6 +3,7 @@
 
 #include "ShapeTypes.h"
 #include "types/containers/VArray.h"
+#include "ShapePairTable.h"
 
 namespace grynca {
 
@@ -12,6 +13,7 @@ namespace grynca {
     public:
         ARect calcARectBound()const;
         void transform(const Mat3& tr);
+        void transform(const Affine2& tr);
         void transform(const Transform& tr);
         bool isPointInside(const Vec2& pt)const;
         f32 calcArea()const;
@@ -21,24 +23,41 @@ namespace grynca {
         bool overlaps(const Shape& sh, OverlapTmp& otmp)const;
         void calcContact(const Shape& sh, OverlapTmp& otmp, ContactManifold& cm_out)const;
         Vec2 calcSupport(const Dir2& dir)const;
+        // GJK distance query (both shapes in same space), false when farther than max_dist
+        bool calcDistance(const Shape& sh, DistanceInfo& di_out, f32 max_dist = std::numeric_limits<f32>::max())const;
     private:
         TEMPLATED_FUNCTOR(CalcARectBoundF_, (T* sh) { return sh->calcARectBound(); })
-        TEMPLATED_FUNCTOR(Transform1F_, (T* sh, Shape& out, const Mat3& tr) { out.set(sh->transformOut(tr)); })
+        TEMPLATED_FUNCTOR(Transform1F_, (T* sh, Shape& out, const Affine2& tr) { out.set(sh->transformOut(tr)); })
         TEMPLATED_FUNCTOR(Transform2F_, (T* sh, Shape& out, const Transform& tr) { out.set(sh->transformOut(tr)); })
         TEMPLATED_FUNCTOR(IsPointInsideF_, (T* sh, const Vec2& pt) { return sh->isPointInside(pt); })
         TEMPLATED_FUNCTOR(CalcAreaF_, (T* sh) { return sh->calcArea(); })
         TEMPLATED_FUNCTOR(CalcInertiaF_, (T* sh) { return sh->calcInertia(); })
         TEMPLATED_FUNCTOR(PrintF_, (T* sh, std::ostream& os) { os << *sh; })
-        template <typename T2>
-        TEMPLATED_FUNCTOR(OverlapsInnerF_, (T* sh2, T2* sh1) { return sh1->overlaps(*sh2); })
-        TEMPLATED_FUNCTOR(OverlapsF_, (T* sh1, const Shape& sh2) { return sh2.callFunctor<OverlapsInnerF_<T> >(sh1); })
-        template <typename T2>
-        TEMPLATED_FUNCTOR(Overlaps2InnerF_, (T* sh2, T2* sh1, OverlapTmp& otmp) { return sh1->overlaps(*sh2, otmp); })
-        TEMPLATED_FUNCTOR(Overlaps2F_, (T* sh1, const Shape& sh2, OverlapTmp& otmp) { return sh2.callFunctor<Overlaps2InnerF_<T> >(sh1, otmp); })
-        template <typename T2>
-        TEMPLATED_FUNCTOR(CalcContactInnerF_, (T* sh2, T2* sh1, OverlapTmp& otmp, ContactManifold& cm_out) { sh1->calcContact(*sh2, otmp, cm_out); })
-        TEMPLATED_FUNCTOR(CalcContactF_, (T* sh1, const Shape& sh2, OverlapTmp& otmp, ContactManifold& cm_out) { sh2.callFunctor<CalcContactInnerF_<T> >(sh1, otmp, cm_out); })
         TEMPLATED_FUNCTOR(CalcSupportF_, (T* sh, const Dir2& dir) { return sh->calcSupport(dir); })
+
+        // ShapePairTable entries (pair of shapes dispatched with one indirect call)
+        struct OverlapsE_ {
+            template <typename T1, typename T2>
+            static bool call(const Shape& sh1, const Shape& sh2) { return sh1.get<T1>().overlaps(sh2.get<T2>()); }
+        };
+        struct OverlapsTmpE_ {
+            template <typename T1, typename T2>
+            static bool call(const Shape& sh1, const Shape& sh2, OverlapTmp& otmp) { return sh1.get<T1>().overlaps(sh2.get<T2>(), otmp); }
+        };
+        struct CalcContactE_ {
+            template <typename T1, typename T2>
+            static void call(const Shape& sh1, const Shape& sh2, OverlapTmp& otmp, ContactManifold& cm_out) {
+                sh1.get<T1>().calcContact(sh2.get<T2>(), otmp, cm_out);
+            }
+        };
+        struct CalcDistanceE_ {
+            template <typename T1, typename T2>
+            static bool call(const Shape& sh1, const Shape& sh2, DistanceInfo& di_out, f32 max_dist) {
+                GJK2D<T1, T2> gjk;
+                gjk.setShapes(sh1.get<T1>(), sh2.get<T2>());
+                return gjk.calcDistance(di_out, max_dist);
+            }
+        };
     };
 }
 
@@ -12,6 +12,10 @@ namespace grynca {
     }
 
     inline void Shape::transform(const Mat3& tr) {
+        transform(Affine2(tr));
+    }
+
+    inline void Shape::transform(const Affine2& tr) {
         V::callFunctor<Transform1F_>(*this, tr);
     }
 
@@ -32,18 +36,22 @@ namespace grynca {
     }
 
     inline bool Shape::overlaps(const Shape& sh)const {
-        return V::callFunctor<OverlapsF_>(sh);
+        return ShapePairTable<OverlapsE_>::get(getTypeId(), sh.getTypeId())(*this, sh);
     }
 
     inline bool Shape::overlaps(const Shape& sh, OverlapTmp& otmp)const {
-        return V::callFunctor<Overlaps2F_>(sh, otmp);
+        return ShapePairTable<OverlapsTmpE_>::get(getTypeId(), sh.getTypeId())(*this, sh, otmp);
     }
 
     inline void Shape::calcContact(const Shape& sh, OverlapTmp& otmp, ContactManifold& cm_out)const {
-        V::callFunctor<CalcContactF_>(sh, otmp, cm_out);
+        ShapePairTable<CalcContactE_>::get(getTypeId(), sh.getTypeId())(*this, sh, otmp, cm_out);
     }
 
     inline Vec2 Shape::calcSupport(const Dir2& dir)const {
         return V::callFunctor<CalcSupportF_>(dir);
     }
+
+    inline bool Shape::calcDistance(const Shape& sh, DistanceInfo& di_out, f32 max_dist)const {
+        return ShapePairTable<CalcDistanceE_>::get(getTypeId(), sh.getTypeId())(*this, sh, di_out, max_dist);
+    }
 }
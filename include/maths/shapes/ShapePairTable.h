@@ -0,0 +1,38 @@
+#ifndef SHAPEPAIRTABLE_H
+#define SHAPEPAIRTABLE_H
+
+#include "ShapeTypes.h"
+#include <array>
+#include <tuple>
+#include <utility>
+
+namespace grynca {
+
+    // compile-time table of Func::call<ShapeTypeA, ShapeTypeB> pointers (all must have same signature)
+    //  - indexed by pair of type ids, so pair dispatch costs one indirect call
+    //  - generated from types pack, so it grows with new shape types
+    template <typename Func, typename TP = ShapeTypes>
+    class ShapePairTable;
+
+    template <typename Func, typename... Ts>
+    class ShapePairTable<Func, TypesPack<Ts...> > {
+        template <size_t I>
+        using TypeAt_ = typename std::tuple_element<I, std::tuple<Ts...> >::type;
+    public:
+        static constexpr u32 TypesCount = sizeof...(Ts);
+        typedef decltype(&Func::template call<TypeAt_<0>, TypeAt_<0> >) FuncPtr;
+
+        static FuncPtr get(i32 tid_a, i32 tid_b);
+    private:
+        typedef std::array<FuncPtr, TypesCount*TypesCount> Table_;
+
+        template <size_t... Is>
+        static constexpr std::array<FuncPtr, sizeof...(Is)> make_(std::index_sequence<Is...>);
+
+        static constexpr Table_ table_ = make_(std::make_index_sequence<TypesCount*TypesCount>());
+    };
+
+}
+
+#include "ShapePairTable.inl"
+#endif //SHAPEPAIRTABLE_H
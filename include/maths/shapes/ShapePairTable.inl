@@ -0,0 +1,23 @@
+#include "ShapePairTable.h"
+
+namespace grynca {
+
+    template <typename Func, typename... Ts>
+    constexpr typename ShapePairTable<Func, TypesPack<Ts...> >::Table_ ShapePairTable<Func, TypesPack<Ts...> >::table_;
+
+    template <typename Func, typename... Ts>
+    inline typename ShapePairTable<Func, TypesPack<Ts...> >::FuncPtr ShapePairTable<Func, TypesPack<Ts...> >::get(i32 tid_a, i32 tid_b) {
+        // static
+        ASSERT(u32(tid_a) < TypesCount && u32(tid_b) < TypesCount);
+        return table_[tid_a*TypesCount + tid_b];
+    }
+
+    template <typename Func, typename... Ts>
+    template <size_t... Is>
+    inline constexpr std::array<typename ShapePairTable<Func, TypesPack<Ts...> >::FuncPtr, sizeof...(Is)>
+        ShapePairTable<Func, TypesPack<Ts...> >::make_(std::index_sequence<Is...>)
+    {
+        // static
+        return {{ &Func::template call<TypeAt_<Is/TypesCount>, TypeAt_<Is%TypesCount> >... }};
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef TOIHELPER_H
+#define TOIHELPER_H
+
+#include "../maths_config.h"
+#include "../Transform.h"
+#include "OverlapHelper.h"
+
+namespace grynca {
+
+    // fw
+    class Shape;
+
+    struct TOIInfo {
+        f32 t;          // time of first contact in [0, 1] (fraction of motion)
+        Dir2 normal;    // from B to A at time of contact (not set when shapes overlap at start)
+        Vec2 point;     // contact point (between closest points)
+        u32 iterations;
+    };
+
+    // time of impact of two moving shapes by conservative advancement
+    //  - shapes move from start to end transform (linear position, shortest rotation), scale is taken from start
+    //  - each step advances by distance / upper bound of approach speed, so shapes never pass through each other
+    //  - scale must be uniform (with non-uniform scale OverlapHelper's distance is approximate, not a lower bound)
+    //  - contact is when distance is under tolerance
+    class TOIHelper {
+    public:
+        TOIHelper(f32 tolerance = MATHS_TOI_TOLERANCE, u32 max_iterations = MATHS_TOI_MAX_ITERATIONS);
+
+        void setTolerance(f32 tolerance);
+        void setMaxIterations(u32 max_iterations);
+
+        // returns false when shapes do not touch during motion
+        // (or when iteration budget runs out, toi_out.t is then safe time to advance to)
+        bool calcTOI(const Shape& shapeA, const Transform& a_start, const Transform& a_end,
+                     const Shape& shapeB, const Transform& b_start, const Transform& b_end, TOIInfo& toi_out);
+
+        static Transform interpolate(const Transform& start, const Transform& end, f32 t);
+    private:
+        // max distance of shape point from its transform origin
+        static f32 calcMaxRadius_(const Shape& shape, const Transform& tr);
+
+        f32 tolerance_;
+        u32 max_iterations_;
+        OverlapHelper oh_;
+    };
+
+}
+
+#include "TOIHelper.inl"
+#endif //TOIHELPER_H
@@ -0,0 +1,83 @@
+#include "TOIHelper.h"
+#include "Shape.h"
+
+namespace grynca {
+
+    inline TOIHelper::TOIHelper(f32 tolerance, u32 max_iterations)
+     : tolerance_(tolerance), max_iterations_(max_iterations)
+    {}
+
+    inline void TOIHelper::setTolerance(f32 tolerance) {
+        tolerance_ = tolerance;
+    }
+
+    inline void TOIHelper::setMaxIterations(u32 max_iterations) {
+        max_iterations_ = max_iterations;
+    }
+
+    inline bool TOIHelper::calcTOI(const Shape& shapeA, const Transform& a_start, const Transform& a_end,
+                                   const Shape& shapeB, const Transform& b_start, const Transform& b_end, TOIInfo& toi_out)
+    {
+        PROFILE_BLOCK("TOIHelper::calcTOI()");
+        ASSERT_M(a_start.getScale().getX() == a_start.getScale().getY() && b_start.getScale().getX() == b_start.getScale().getY(),
+                 "use only uniform scale.");
+        // http://www.continuousphysics.com/BulletContinuousCollisionDetection.pdf (conservative advancement)
+        Vec2 rel_move = (a_end.getPosition() - a_start.getPosition()) - (b_end.getPosition() - b_start.getPosition());
+        f32 rot_a = fabsf((a_end.getRotation() - a_start.getRotation()).normalize());
+        f32 rot_b = fabsf((b_end.getRotation() - b_start.getRotation()).normalize());
+        // max speed of any shape point due to rotation
+        f32 rot_speed = rot_a*calcMaxRadius_(shapeA, a_start) + rot_b*calcMaxRadius_(shapeB, b_start);
+
+        DistanceInfo di;
+        toi_out.t = 0.0f;
+        for (toi_out.iterations = 0; toi_out.iterations < max_iterations_; ++toi_out.iterations) {
+            f32 t = toi_out.t;
+            oh_.set(shapeA, shapeB, interpolate(a_start, a_end, t), interpolate(b_start, b_end, t));
+            // farther than shapes can travel until end -> no contact
+            f32 max_travel = rel_move.getLen() + rot_speed;
+            if (!oh_.calcDistance(di, max_travel*(1.0f - t) + tolerance_)) {
+                toi_out.t = 1.0f;
+                return false;
+            }
+            if (di.distance < tolerance_) {
+                // touching (or overlapping at start)
+                if (di.distance > 0.0f) {
+                    toi_out.normal = di.normal;
+                    toi_out.point = (di.point_a + di.point_b)*0.5f;
+                }
+                return true;
+            }
+
+            // upper bound of approach speed along normal (A moves against normal towards B)
+            f32 approach_speed = -dot(rel_move, di.normal) + rot_speed;
+            if (approach_speed <= maths::EPS) {
+                toi_out.t = 1.0f;
+                return false;
+            }
+            toi_out.t += di.distance/approach_speed;
+            if (toi_out.t >= 1.0f) {
+                toi_out.t = 1.0f;
+                return false;
+            }
+        }
+        return false;
+    }
+
+    inline Transform TOIHelper::interpolate(const Transform& start, const Transform& end, f32 t) {
+        // static
+        Vec2 pos = start.getPosition() + (end.getPosition() - start.getPosition())*t;
+        // rotations are wrapped to -Pi..Pi, normalized delta turns the shorter way
+        Angle rot = start.getRotation() + (end.getRotation() - start.getRotation()).normalize()*t;
+        return Transform(pos, rot, start.getScale());
+    }
+
+    inline f32 TOIHelper::calcMaxRadius_(const Shape& shape, const Transform& tr) {
+        // static
+        ARect bound = shape.calcARectBound();
+        const Vec2& lt = bound.getLeftTop();
+        const Vec2& rb = bound.getRightBot();
+        Vec2 far_corner(std::max(fabsf(lt.getX()), fabsf(rb.getX())), std::max(fabsf(lt.getY()), fabsf(rb.getY())));
+        Vec2 scale = tr.getScale();
+        return far_corner.getLen()*std::max(fabsf(scale.getX()), fabsf(scale.getY()));
+    }
+}
@@ -7,6 +7,7 @@ namespace grynca {
 
     class Transform;
     class Mat3;
+    class Affine2;
     class OverlapTmp;
     class ContactManifold;
 
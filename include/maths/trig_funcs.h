@@ -0,0 +1,250 @@
+#ifndef TRIG_FUNCS_H
+#define TRIG_FUNCS_H
+
+#include "maths_config.h"
+#include "SIMD.h"
+#include <cmath>
+
+// sin/cos/atan2 with accuracy tier selected at compile time (MATHS_TRIG_ACCURACY)
+//  0: libm
+//  1: fast, minimax polynomials deg 5/4/9 (sin/cos/atan), abs error <= ~1.5e-5
+//  2: precise, deg 7/8/15, abs error <= ~3e-7 (float rounding dominates, sin/cos ~7e-7 at |x| ~ 4Pi with -ffast-math
+//     which folds the Pi/2 parts below into one constant)
+// tiers 1 & 2 are branchless and same code runs for f32 and F32x4/F32x8 packets (lanes match scalar results),
+// range reduction is Cody-Waite with Pi/2 split in 3 parts (error grows for |x| > ~1e4),
+// atan2 does not distinguish signed zeros (atan2(0, 0) = 0, atan2(-0, -1) = Pi)
+
+namespace grynca {
+    namespace maths {
+        namespace trig_ {
+            // scalar counterparts of packet ops (packet ones are hidden friends found by ADL)
+            inline f32 select(bool mask, f32 t, f32 f) { return mask?t:f; }
+            inline f32 round(f32 v) { return rintf(v); }
+            inline f32 abs(f32 v) { return fabsf(v); }
+            inline f32 min(f32 a, f32 b) { return (b<a)?b:a; }
+            inline f32 max(f32 a, f32 b) { return (a<b)?b:a; }
+
+            static constexpr f32 Pi = 3.1415927410125732421875f;
+            static constexpr f32 Pi_2 = Pi*0.5f;
+            static constexpr f32 InvPi_2 = 0.636619772367581343f;
+            // Pi/2 = PiO2_1 + PiO2_2 + PiO2_3, PiO2_1 has 8 significant bits (q*PiO2_1 exact for |q| < 2^16)
+            static constexpr f32 PiO2_1 = 1.5703125f;
+            static constexpr f32 PiO2_2 = 4.837512969970703125e-4f;
+            static constexpr f32 PiO2_3 = 7.54978995489188216e-8f;
+
+            template <u32 Tier> struct Polys;
+
+            template <>
+            struct Polys<1> {
+                // |r| <= Pi/4, z = r*r
+                template <typename F>
+                static F sin(const F& r, const F& z) {
+                    return r + r*z*(F(-1.66629400e-1f) + z*F(8.15157095e-3f));
+                }
+
+                template <typename F>
+                static F cos(const F& z) {
+                    return F(1.0f) + z*(F(-4.99776307e-1f) + z*F(4.04889358e-2f));
+                }
+
+                // 0 <= t <= 1, z = t*t
+                template <typename F>
+                static F atan(const F& t, const F& z) {
+                    return t*(F(9.99866330e-1f) + z*(F(-3.30304786e-1f) + z*(F(1.80159297e-1f)
+                            + z*(F(-8.51563545e-2f) + z*F(2.08451159e-2f)))));
+                }
+            };
+
+            template <>
+            struct Polys<2> {
+                template <typename F>
+                static F sin(const F& r, const F& z) {
+                    return r + r*z*(F(-1.66666507e-1f) + z*(F(8.33197866e-3f) + z*F(-1.94956362e-4f)));
+                }
+
+                template <typename F>
+                static F cos(const F& z) {
+                    return F(1.0f) - F(0.5f)*z + z*z*(F(4.16666547e-2f) + z*(F(-1.38876544e-3f) + z*F(2.44638374e-5f)));
+                }
+
+                template <typename F>
+                static F atan(const F& t, const F& z) {
+                    return t*(F(9.99999336e-1f) + z*(F(-3.33298607e-1f) + z*(F(1.99465653e-1f) + z*(F(-1.39086282e-1f)
+                            + z*(F(9.64219443e-2f) + z*(F(-5.59122924e-2f) + z*(F(2.18629368e-2f) + z*F(-4.05456197e-3f))))))));
+                }
+            };
+
+            template <u32 Tier>
+            struct Trig {
+                template <typename F>
+                static void sinCos(const F& x, F& sin_out, F& cos_out) {
+                    // x = q*Pi/2 + r, |r| <= Pi/4
+                    F q = round(x*F(InvPi_2));
+                    F r = ((x - q*F(PiO2_1)) - q*F(PiO2_2)) - q*F(PiO2_3);
+                    F z = r*r;
+                    F s = Polys<Tier>::sin(r, z);
+                    F c = Polys<Tier>::cos(z);
+
+                    // quadrant q mod 4 as m in -2..2
+                    F m = q - F(4.0f)*round(q*F(0.25f));
+                    auto swap = (abs(m) == F(1.0f));
+                    F sn = select(swap, c, s);
+                    F cs = select(swap, s, c);
+                    // sin: s, c, -s, -c  cos: c, -s, -c, s  (m = 0, 1, 2, 3)
+                    sin_out = select((m < F(-0.5f)) | (m > F(1.5f)), -sn, sn);
+                    cos_out = select((m > F(0.5f)) | (m < F(-1.5f)), -cs, cs);
+                }
+
+                template <typename F>
+                static F atan2(const F& y, const F& x) {
+                    F ax = abs(x);
+                    F ay = abs(y);
+                    F mx = max(ax, ay);
+                    F t = min(ax, ay)/select(mx == F(0.0f), F(1.0f), mx);
+                    F a = Polys<Tier>::atan(t, t*t);
+                    a = select(ay > ax, F(Pi_2) - a, a);
+                    a = select(x < F(0.0f), F(Pi) - a, a);
+                    return select(y < F(0.0f), -a, a);
+                }
+            };
+
+            template <>
+            struct Trig<0> {
+                static void sinCos(f32 x, f32& sin_out, f32& cos_out) {
+#ifdef _WIN32
+                    sin_out = sinf(x);
+                    // cos from sin with sign by quadrant
+                    int q = ::abs((int)(x/Pi_2))%4;
+                    if (q == 1 || q == 2)
+                        cos_out = -sqrtf(1.0f - sin_out*sin_out);
+                    else
+                        cos_out = sqrtf(1.0f - sin_out*sin_out);
+#else
+                    sincosf(x, &sin_out, &cos_out);
+#endif
+                }
+
+                static f32 atan2(f32 y, f32 x) {
+                    return atan2f(y, x);
+                }
+
+                // packets lane by lane
+                template <typename F>
+                static void sinCos(const F& x, F& sin_out, F& cos_out) {
+                    f32 xs[F::Width], ss[F::Width], cs[F::Width];
+                    x.store(xs);
+                    for (u32 l=0; l<F::Width; ++l) {
+                        sinCos(xs[l], ss[l], cs[l]);
+                    }
+                    sin_out = F::load(ss);
+                    cos_out = F::load(cs);
+                }
+
+                template <typename F>
+                static F atan2(const F& y, const F& x) {
+                    f32 ys[F::Width], xs[F::Width];
+                    y.store(ys);
+                    x.store(xs);
+                    for (u32 l=0; l<F::Width; ++l) {
+                        ys[l] = atan2f(ys[l], xs[l]);
+                    }
+                    return F::load(ys);
+                }
+            };
+
+            // n >= F::Width, last packet may overlap previous one (loaded first so in-place use is safe)
+            template <u32 Tier, typename F>
+            inline void calcSinCosPackets(const f32* xs, u32 n, f32* sin_out, f32* cos_out) {
+                static constexpr u32 W = F::Width;
+                ASSERT(n >= W);
+                F last_s, last_c;
+                Trig<Tier>::sinCos(F::load(xs+n-W), last_s, last_c);
+                for (u32 i=0; i+W<n; i+=W) {
+                    F s, c;
+                    Trig<Tier>::sinCos(F::load(xs+i), s, c);
+                    s.store(sin_out+i);
+                    c.store(cos_out+i);
+                }
+                last_s.store(sin_out+n-W);
+                last_c.store(cos_out+n-W);
+            }
+
+            template <u32 Tier, typename F>
+            inline void calcAtan2Packets(const f32* ys, const f32* xs, u32 n, f32* out) {
+                static constexpr u32 W = F::Width;
+                ASSERT(n >= W);
+                F last = Trig<Tier>::atan2(F::load(ys+n-W), F::load(xs+n-W));
+                for (u32 i=0; i+W<n; i+=W) {
+                    Trig<Tier>::atan2(F::load(ys+i), F::load(xs+i)).store(out+i);
+                }
+                last.store(out+n-W);
+            }
+        }
+
+        // F is f32, F32x4 or F32x8
+        template <u32 Tier = MATHS_TRIG_ACCURACY, typename F>
+        inline void calcSinCos(const F& x, F& sin_out, F& cos_out) {
+            trig_::Trig<Tier>::sinCos(x, sin_out, cos_out);
+        }
+
+        template <u32 Tier = MATHS_TRIG_ACCURACY>
+        inline f32 calcSin(f32 x) {
+            if (Tier == 0)
+                return sinf(x);
+            f32 s, c;
+            calcSinCos<Tier>(x, s, c);
+            return s;
+        }
+
+        template <u32 Tier = MATHS_TRIG_ACCURACY>
+        inline f32 calcCos(f32 x) {
+            if (Tier == 0)
+                return cosf(x);
+            f32 s, c;
+            calcSinCos<Tier>(x, s, c);
+            return c;
+        }
+
+        // result in -Pi..Pi
+        template <u32 Tier = MATHS_TRIG_ACCURACY, typename F>
+        inline F calcAtan2(const F& y, const F& x) {
+            return trig_::Trig<Tier>::atan2(y, x);
+        }
+
+        // batch versions (outputs can be same as inputs)
+        template <u32 Tier = MATHS_TRIG_ACCURACY>
+        inline void calcSinCos(const f32* xs, u32 n, f32* sin_out, f32* cos_out) {
+#if MATHS_SIMD_SSE
+            if (Tier != 0 && n >= F32x4::Width) {
+                if (n >= F32xN::Width)
+                    trig_::calcSinCosPackets<Tier, F32xN>(xs, n, sin_out, cos_out);
+                else
+                    trig_::calcSinCosPackets<Tier, F32x4>(xs, n, sin_out, cos_out);
+                return;
+            }
+#endif
+            for (u32 i=0; i<n; ++i) {
+                f32 x = xs[i];
+                calcSinCos<Tier>(x, sin_out[i], cos_out[i]);
+            }
+        }
+
+        template <u32 Tier = MATHS_TRIG_ACCURACY>
+        inline void calcAtan2(const f32* ys, const f32* xs, u32 n, f32* out) {
+#if MATHS_SIMD_SSE
+            if (Tier != 0 && n >= F32x4::Width) {
+                if (n >= F32xN::Width)
+                    trig_::calcAtan2Packets<Tier, F32xN>(ys, xs, n, out);
+                else
+                    trig_::calcAtan2Packets<Tier, F32x4>(ys, xs, n, out);
+                return;
+            }
+#endif
+            for (u32 i=0; i<n; ++i) {
+                out[i] = calcAtan2<Tier>(ys[i], xs[i]);
+            }
+        }
+    }
+}
+
+#endif //TRIG_FUNCS_H
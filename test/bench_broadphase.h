@@ -0,0 +1,391 @@
+#ifndef BENCH_BROADPHASE_H
+#define BENCH_BROADPHASE_H
+
+#include "maths.h"
+#include "bench_common.h"
+
+class BroadphaseBench {
+public:
+    void run() {
+        std::cout << "== Broadphase ==" << std::endl;
+        u32 sizes[] = {1000, 10000, 100000};
+        for (u32 i=0; i<ARRAY_SIZE(sizes); ++i) {
+            benchAABBTree(sizes[i]);
+        }
+        for (u32 i=0; i<ARRAY_SIZE(sizes); ++i) {
+            benchSAP(sizes[i], 0.0f);
+        }
+        // randomized motion, teleporting bodies break temporal coherence
+        benchSAP(1000, 0.1f);
+        benchSAP(1000, 1.0f);
+        benchSAP(10000, 0.01f);
+        benchSAP(10000, 0.1f);
+        benchSAPTouching(32);
+        for (u32 i=0; i<ARRAY_SIZE(sizes); ++i) {
+            benchSpatialGrid(sizes[i]);
+        }
+        benchStaticBVH(5000);
+        benchStaticBVH(50000);
+    }
+
+    void benchAABBTree(u32 n) {
+        fast_vector<Shape> shapes;
+        fast_vector<Transform> transforms;
+        fast_vector<ARect> bounds;
+        genScene_(n, shapes, transforms, bounds);
+
+        // brute force (for large counts extrapolated from first BruteMax_ shapes)
+        u32 brute_n = std::min(n, u32(BruteMax_));
+        u32 brute_pairs = 0;
+        BenchTimer t;
+        for (u32 i=0; i<brute_n; ++i) {
+            for (u32 j=i+1; j<brute_n; ++j) {
+                if (bounds[i].intersects(bounds[j]))
+                    ++brute_pairs;
+            }
+        }
+        f64 brute_ms = t.getElapsedMs();
+        if (brute_n != n) {
+            f64 scale = f64(n)/brute_n;
+            brute_ms *= scale*scale;
+        }
+
+        AABBTree tree;
+        fast_vector<u32> proxies(n);
+        t.reset();
+        for (u32 i=0; i<n; ++i) {
+            proxies[i] = tree.addProxy(bounds[i], i);
+        }
+        f64 build_ms = t.getElapsedMs();
+
+        u32 tree_pairs = 0;
+        t.reset();
+        tree.queryPairs([&tree_pairs](u32, u32) { ++tree_pairs; });
+        f64 query_ms = t.getElapsedMs();
+        tree.queryNewPairs([](u32, u32) {});
+
+        // coherent movement, only reinserted proxies produce new pairs
+        u32 reinserted = 0;
+        u32 new_pairs = 0;
+        t.reset();
+        for (u32 f=0; f<Frames_; ++f) {
+            for (u32 i=0; i<n; ++i) {
+                Vec2 d(randFloat(-0.5f, 0.5f), randFloat(-0.5f, 0.5f));
+                transforms[i].move(d);
+                ARect b = shapes[i].calcARectBound();
+                b.transformWithoutRotation(transforms[i]);
+                reinserted += tree.moveProxy(proxies[i], b, d);
+            }
+            tree.queryNewPairs([&new_pairs](u32, u32) { ++new_pairs; });
+        }
+        f64 move_ms = t.getElapsedMs()/Frames_;
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << " AABBTree n=" << n << ": brute " << brute_ms << " ms" << (brute_n!=n?" (extrapolated)":"")
+                  << ", build " << build_ms << " ms, pairs " << query_ms << " ms"
+                  << " (" << tree_pairs << " candidates, height " << tree.getHeight() << ")"
+                  << ", move+new pairs " << move_ms << " ms/frame (" << reinserted/Frames_ << " reinserted, " << new_pairs/Frames_ << " new)" << std::endl;
+        if (brute_n == n && tree_pairs < brute_pairs) {
+            std::cout << "  ERROR: tree reported less pairs than brute force (" << brute_pairs << ")" << std::endl;
+        }
+    }
+
+    // teleport_ratio: part of bodies moved to random position each frame (rest moves coherently)
+    void benchSAP(u32 n, f32 teleport_ratio) {
+        fast_vector<Shape> shapes;
+        fast_vector<Transform> transforms;
+        fast_vector<ARect> bounds;
+        genScene_(n, shapes, transforms, bounds);
+        f32 world_size = sqrtf(f32(n))*8.0f;
+
+        SweepAndPrune sap;
+        fast_vector<u32> proxies(n);
+        u32 begins = 0, ends = 0;
+        auto begin_cb = [&begins](u32, u32) { ++begins; };
+        auto end_cb = [&ends](u32, u32) { ++ends; };
+        BenchTimer t;
+        for (u32 i=0; i<n; ++i) {
+            proxies[i] = sap.addProxy(bounds[i], i);
+        }
+        sap.update(begin_cb, end_cb);
+        f64 build_ms = t.getElapsedMs();
+        u32 initial_pairs = sap.getPairsCount();
+
+        begins = ends = 0;
+        u64 swaps = 0;
+        u32 teleports = u32(n*teleport_ratio);
+        t.reset();
+        for (u32 f=0; f<Frames_; ++f) {
+            for (u32 i=0; i<n; ++i) {
+                if (i < teleports) {
+                    transforms[i].setPosition(Vec2(randFloat(0, world_size), randFloat(0, world_size)));
+                }
+                else {
+                    transforms[i].move(Vec2(randFloat(-0.5f, 0.5f), randFloat(-0.5f, 0.5f)));
+                }
+                bounds[i] = shapes[i].calcARectBound();
+                bounds[i].transformWithoutRotation(transforms[i]);
+                sap.moveProxy(proxies[i], bounds[i]);
+            }
+            sap.update(begin_cb, end_cb);
+            swaps += sap.getLastSwapsCount();
+        }
+        f64 update_ms = t.getElapsedMs()/Frames_;
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << " SAP n=" << n << " teleport " << teleport_ratio*100 << "%: build " << build_ms << " ms (" << initial_pairs << " pairs)"
+                  << ", update " << update_ms << " ms/frame (" << swaps/Frames_ << " swaps, "
+                  << begins/Frames_ << " begin, " << ends/Frames_ << " end)" << std::endl;
+
+        if (n <= BruteMax_) {
+            u32 brute_pairs = 0;
+            for (u32 i=0; i<n; ++i) {
+                for (u32 j=i+1; j<n; ++j) {
+                    if (bounds[i].intersects(bounds[j]))
+                        ++brute_pairs;
+                }
+            }
+            if (brute_pairs != sap.getPairsCount()) {
+                std::cout << "  ERROR: SAP has " << sap.getPairsCount() << " pairs, brute force " << brute_pairs << std::endl;
+            }
+        }
+    }
+
+    // unit boxes on integer grid (only touching neighbours, endpoints with equal values),
+    // moved by whole units so ties stay exact, pairs checked against brute force each frame
+    void benchSAPTouching(u32 grid_size) {
+        srand(4);
+        u32 n = grid_size*grid_size;
+        fast_vector<Vec2> positions(n);
+        for (u32 i=0; i<n; ++i) {
+            positions[i].set(f32(i%grid_size), f32(i/grid_size));
+        }
+
+        SweepAndPrune sap;
+        fast_vector<u32> proxies(n);
+        auto nop_cb = [](u32, u32) {};
+        for (u32 i=0; i<n; ++i) {
+            proxies[i] = sap.addProxy(ARect(positions[i], Vec2(1, 1)), i);
+        }
+        sap.update(nop_cb, nop_cb);
+        u32 initial_pairs = sap.getPairsCount();
+
+        u32 errors = 0;
+        for (u32 f=0; f<=Frames_; ++f) {
+            if (f) {
+                for (u32 k=0; k<n/10; ++k) {
+                    u32 i = rand()%n;
+                    positions[i] += (rand()%2)?Vec2(f32(rand()%3) - 1, 0):Vec2(0, f32(rand()%3) - 1);
+                    sap.moveProxy(proxies[i], ARect(positions[i], Vec2(1, 1)));
+                }
+                sap.update(nop_cb, nop_cb);
+            }
+            u32 brute_pairs = 0;
+            for (u32 i=0; i<n; ++i) {
+                for (u32 j=i+1; j<n; ++j) {
+                    if (sap.getBound(proxies[i]).intersects(sap.getBound(proxies[j])))
+                        ++brute_pairs;
+                }
+            }
+            errors += (brute_pairs != sap.getPairsCount());
+        }
+
+        std::cout << " SAP touching boxes n=" << n << ": " << initial_pairs << " pairs at start, "
+                  << sap.getPairsCount() << " at end" << std::endl;
+        if (errors) {
+            std::cout << "  ERROR: SAP pairs differ from brute force in " << errors << " frames" << std::endl;
+        }
+    }
+
+    void benchSpatialGrid(u32 n) {
+        fast_vector<Shape> shapes;
+        fast_vector<Transform> transforms;
+        fast_vector<ARect> bounds;
+        genScene_(n, shapes, transforms, bounds);
+        f32 world_size = sqrtf(f32(n))*8.0f;
+
+        // cell about size of largest shape
+        SpatialGrid grid(4.0f, n);
+        fast_vector<u32> proxies(n);
+        BenchTimer t;
+        for (u32 i=0; i<n; ++i) {
+            proxies[i] = grid.addProxy(bounds[i], i);
+        }
+        f64 build_ms = t.getElapsedMs();
+
+        u32 pairs = 0;
+        t.reset();
+        for (u32 f=0; f<Frames_; ++f) {
+            for (u32 i=0; i<n; ++i) {
+                transforms[i].move(Vec2(randFloat(-0.5f, 0.5f), randFloat(-0.5f, 0.5f)));
+                bounds[i] = shapes[i].calcARectBound();
+                bounds[i].transformWithoutRotation(transforms[i]);
+                grid.moveProxy(proxies[i], bounds[i]);
+            }
+            grid.queryPairs([&pairs](u32, u32) { ++pairs; });
+        }
+        f64 frame_ms = t.getElapsedMs()/Frames_;
+
+        // region and ray queries
+        u32 queries = 1000;
+        u32 region_hits = 0, ray_hits = 0;
+        t.reset();
+        for (u32 i=0; i<queries; ++i) {
+            Vec2 c(randFloat(0, world_size), randFloat(0, world_size));
+            grid.queryOverlaps(Circle(c, 10.0f), [&region_hits](u32) { ++region_hits; return true; });
+        }
+        f64 region_us = t.getElapsedMs()*1000/queries;
+        t.reset();
+        for (u32 i=0; i<queries; ++i) {
+            Vec2 s(randFloat(0, world_size), randFloat(0, world_size));
+            Ray r(s, s+Vec2(randFloat(-50, 50), randFloat(-50, 50)));
+            grid.queryRay(r, [&ray_hits](u32) { ++ray_hits; return true; });
+        }
+        f64 ray_us = t.getElapsedMs()*1000/queries;
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << " SpatialGrid n=" << n << ": build " << build_ms << " ms, move+pairs " << frame_ms << " ms/frame (" << pairs/Frames_ << " pairs)"
+                  << ", circle query " << region_us << " us (" << region_hits/queries << " hits)"
+                  << ", ray query " << ray_us << " us (" << ray_hits/queries << " hits)" << std::endl;
+
+        if (n <= BruteMax_) {
+            u32 brute_pairs = 0;
+            for (u32 i=0; i<n; ++i) {
+                for (u32 j=i+1; j<n; ++j) {
+                    if (bounds[i].intersects(bounds[j]))
+                        ++brute_pairs;
+                }
+            }
+            u32 grid_pairs = 0;
+            grid.queryPairs([&grid_pairs](u32, u32) { ++grid_pairs; });
+            if (brute_pairs != grid_pairs) {
+                std::cout << "  ERROR: grid has " << grid_pairs << " pairs, brute force " << brute_pairs << std::endl;
+            }
+        }
+    }
+
+    // static level geometry of small convex pieces
+    void benchStaticBVH(u32 n) {
+        srand(1);
+        f32 world_size = sqrtf(f32(n))*10.0f;
+        fast_vector<Shape> level(n);
+        fast_vector<ARect> bounds(n);
+        for (u32 i=0; i<n; ++i) {
+            Vec2 c(randFloat(0, world_size), randFloat(0, world_size));
+            if (i%4 == 0) {
+                level[i].create<ARect>(ARect(c, Vec2(randFloat(2.0f, 12.0f), randFloat(1.0f, 3.0f))));
+            }
+            else {
+                // convex pgon with points on circle
+                u32 pts_cnt = 3 + rand()%4;
+                f32 r = randFloat(1.0f, 5.0f);
+                Vec2 pts[6];
+                for (u32 j=0; j<pts_cnt; ++j) {
+                    f32 a = (j + randFloat(0.0f, 0.5f))*2*f32(M_PI)/pts_cnt;
+                    pts[j] = c + Vec2(cosf(a), sinf(a))*r;
+                }
+                level[i].create<Pgon>(pts, pts_cnt);
+            }
+            bounds[i] = level[i].calcARectBound();
+        }
+
+        StaticBVH bvh;
+        BenchTimer t;
+        bvh.build(bounds.begin(), n);
+        f64 build_ms = t.getElapsedMs();
+
+        u32 rays_cnt = 10000;
+        fast_vector<Ray> rays(rays_cnt);
+        for (u32 i=0; i<rays_cnt; ++i) {
+            Vec2 s(randFloat(0, world_size), randFloat(0, world_size));
+            rays[i] = Ray(s, s + Vec2(randFloat(-100, 100), randFloat(-100, 100)));
+        }
+
+        u32 bvh_hits = 0;
+        t.reset();
+        for (u32 i=0; i<rays_cnt; ++i) {
+            bvh.queryRay(rays[i], [&bvh_hits](u32) { ++bvh_hits; return true; });
+        }
+        f64 bvh_ray_us = t.getElapsedMs()*1000/rays_cnt;
+
+        // brute force slab tests (on part of rays)
+        u32 brute_rays = std::min(rays_cnt, 1000u);
+        u32 brute_hits = 0, bvh_brute_hits = 0;
+        t.reset();
+        for (u32 i=0; i<brute_rays; ++i) {
+            brute_hits += countRayHitsBrute_(rays[i], bounds);
+        }
+        f64 brute_ray_us = t.getElapsedMs()*1000/brute_rays;
+        for (u32 i=0; i<brute_rays; ++i) {
+            bvh.queryRay(rays[i], [&bvh_brute_hits](u32) { ++bvh_brute_hits; return true; });
+        }
+
+        u32 shape_hits = 0;
+        t.reset();
+        for (u32 i=0; i<rays_cnt; ++i) {
+            Shape s;
+            s.create<Circle>(rays[i].getStart(), 5.0f);
+            bvh.queryShape(s, [&level](u32 prim_id) -> const Shape& { return level[prim_id]; },
+                           [&shape_hits](u32) { ++shape_hits; return true; });
+        }
+        f64 shape_us = t.getElapsedMs()*1000/rays_cnt;
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << " StaticBVH n=" << n << ": build " << build_ms << " ms (" << bvh.getNodesCount() << " nodes, depth " << bvh.calcDepth() << ")"
+                  << ", ray " << bvh_ray_us << " us (brute " << brute_ray_us << " us, " << f32(bvh_hits)/rays_cnt << " hits)"
+                  << ", circle shape query " << shape_us << " us (" << f32(shape_hits)/rays_cnt << " hits)" << std::endl;
+        if (brute_hits != bvh_brute_hits) {
+            std::cout << "  ERROR: bvh ray hits " << bvh_brute_hits << ", brute force " << brute_hits << std::endl;
+        }
+    }
+
+private:
+    static constexpr u32 BruteMax_ = 10000;
+    static constexpr u32 Frames_ = 10;
+
+    u32 countRayHitsBrute_(const Ray& ray, const fast_vector<ARect>& bounds) {
+        Vec2 s = ray.getStart();
+        Vec2 v = ray.getToEndVec();
+        u32 hits = 0;
+        for (u32 i=0; i<bounds.size(); ++i) {
+            f32 t_min = 0.0f, t_max = 1.0f;
+            for (u32 a=0; a<2 && t_min<=t_max; ++a) {
+                f32 lo = bounds[i].getLeftTop().val(a);
+                f32 hi = bounds[i].getRightBot().val(a);
+                if (v.val(a) == 0.0f) {
+                    if (s.val(a) < lo || s.val(a) > hi)
+                        t_min = 2.0f;
+                    continue;
+                }
+                f32 t1 = (lo - s.val(a))/v.val(a);
+                f32 t2 = (hi - s.val(a))/v.val(a);
+                t_min = std::max(t_min, std::min(t1, t2));
+                t_max = std::min(t_max, std::max(t1, t2));
+            }
+            hits += (t_min <= t_max);
+        }
+        return hits;
+    }
+
+    // similar-sized shapes with constant density
+    void genScene_(u32 n, fast_vector<Shape>& shapes_out, fast_vector<Transform>& transforms_out, fast_vector<ARect>& bounds_out) {
+        srand(1);
+        f32 world_size = sqrtf(f32(n))*8.0f;
+        shapes_out.resize(n);
+        transforms_out.resize(n);
+        bounds_out.resize(n);
+        for (u32 i=0; i<n; ++i) {
+            if (i%2) {
+                shapes_out[i].create<Circle>(Vec2(0, 0), randFloat(0.5f, 2.0f));
+            }
+            else {
+                shapes_out[i].create<ARect>(ARect::createCentered(Vec2(randFloat(1.0f, 4.0f), randFloat(1.0f, 4.0f))));
+            }
+            transforms_out[i].setPosition(Vec2(randFloat(0, world_size), randFloat(0, world_size)));
+            bounds_out[i] = shapes_out[i].calcARectBound();
+            bounds_out[i].transformWithoutRotation(transforms_out[i]);
+        }
+    }
+};
+
+#endif //BENCH_BROADPHASE_H
@@ -0,0 +1,26 @@
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <chrono>
+#include <iomanip>
+
+class BenchTimer {
+public:
+    BenchTimer() { reset(); }
+
+    void reset() { start_ = Clock::now(); }
+    f64 getElapsedMs()const { return std::chrono::duration<f64, std::milli>(Clock::now() - start_).count(); }
+private:
+    typedef std::chrono::high_resolution_clock Clock;
+    Clock::time_point start_;
+};
+
+// prevents compiler from optimizing out benchmarked results
+static volatile u8 g_bench_sink;
+
+template <typename T>
+inline void benchKeep(const T& val) {
+    g_bench_sink = *(const volatile u8*)&val;
+}
+
+#endif //BENCH_COMMON_H
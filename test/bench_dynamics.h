@@ -0,0 +1,258 @@
+#ifndef BENCH_DYNAMICS_H
+#define BENCH_DYNAMICS_H
+
+#include "maths.h"
+#include "bench_common.h"
+
+class DynamicsBench {
+public:
+    void run() {
+        std::cout << "== Dynamics ==" << std::endl;
+        benchContactCache(50000, 60);
+        benchPyramid(20, 600, true);
+        benchPyramid(20, 600, false);
+        benchSleeping(2000, 5, true);
+        benchSleeping(2000, 5, false);
+    }
+
+    // pyramid of boxes resting on static ground, reports solver time per step and drift of top box
+    void benchPyramid(u32 base, u32 steps, bool warm_starting) {
+        static constexpr f32 BoxSize = 10.0f;
+        Shape box, ground;
+        box.create<Rect>(Vec2(0, 0), Vec2(BoxSize, BoxSize), Vec2(-BoxSize/2, -BoxSize/2));
+        ground.create<Rect>(Vec2(0, 0), Vec2(1000, 20), Vec2(-500, -10));
+
+        ContactSolver solver;
+        solver.accSettings().gravity = Vec2(0, 100);      // y goes down
+        solver.accSettings().warm_starting = warm_starting;
+        solver.accSettings().sleeping = false;
+        fast_vector<const Shape*> shapes;
+        solver.addBody(Transform(Vec2(0, 10), 0), 0.0f, 0.0f);
+        shapes.push_back(&ground);
+        f32 box_mass = box.calcArea();
+        for (u32 row=0; row<base; ++row) {
+            for (u32 i=0; i<base-row; ++i) {
+                Vec2 pos((i - (base-row-1)*0.5f)*BoxSize*1.05f, -BoxSize*(row+0.5f));
+                solver.addBody(Transform(pos, 0), box_mass, box_mass*box.calcInertia());
+                shapes.push_back(&box);
+            }
+        }
+        u32 top = solver.getBodiesCount()-1;
+        Vec2 top_start = solver.getPosition(top);
+
+        OverlapHelper oh;
+        f64 collide_ms = 0, solve_ms = 0;
+        u64 contacts_cnt = 0;
+        f32 dt = 1.0f/60;
+        for (u32 s=0; s<steps; ++s) {
+            BenchTimer t;
+            u32 n = solver.getBodiesCount();
+            for (u32 i=0; i<n; ++i) {
+                Transform tr_i = solver.calcTransform(i);
+                for (u32 j=i+1; j<n; ++j) {
+                    // ground is body 0
+                    if (i && (solver.getPosition(i) - solver.getPosition(j)).getSqrLen() > 2*BoxSize*BoxSize*1.1f)
+                        continue;
+                    if (!i && solver.getPosition(j).getY() < -BoxSize)
+                        continue;
+                    oh.set(*shapes[i], *shapes[j], tr_i, solver.calcTransform(j));
+                    if (!oh.overlaps())
+                        continue;
+                    oh.calcContactG();
+                    solver.addContact(i, j, oh.getContactManifoldG());
+                }
+            }
+            contacts_cnt += solver.getContactsCount();
+            collide_ms += t.getElapsedMs();
+
+            t.reset();
+            solver.step(dt);
+            solve_ms += t.getElapsedMs();
+        }
+
+        f32 max_speed = 0.0f;
+        for (u32 i=1; i<solver.getBodiesCount(); ++i) {
+            max_speed = std::max(max_speed, solver.getLinearVelocity(i).getLen());
+        }
+        Vec2 drift = solver.getPosition(top) - top_start;
+        std::cout << std::fixed << std::setprecision(3)
+                  << " Pyramid " << solver.getBodiesCount()-1 << " boxes, " << steps << " steps" << (warm_starting?" (warm-started)":" (cold)")
+                  << ": solver " << solve_ms/steps << " ms per step, collisions " << collide_ms/steps << " ms per step, "
+                  << std::setprecision(1) << f64(contacts_cnt)/steps << " contact points; top box drift " << drift.getLen()
+                  << ", max speed " << max_speed << std::endl;
+        // without warm-starting tall stacks need much more iterations
+        if (warm_starting && drift.getLen() > BoxSize) {
+            std::cout << "  ERROR: pyramid collapsed" << std::endl;
+        }
+    }
+
+    // columns of boxes on static ground are let to settle, then steps of settled pile are measured
+    // (with sleeping broadphase, narrowphase and solver skip sleeping bodies), finally one box is pushed to check wake-on-touch
+    void benchSleeping(u32 columns, u32 rows, bool sleeping) {
+        static constexpr f32 BoxSize = 10.0f;
+        static constexpr u32 SettleSteps = 120;
+        static constexpr u32 MeasuredSteps = 60;
+        Shape box, ground;
+        box.create<Rect>(Vec2(0, 0), Vec2(BoxSize, BoxSize), Vec2(-BoxSize/2, -BoxSize/2));
+        f32 width = (columns+1)*BoxSize*1.5f;
+        ground.create<Rect>(Vec2(0, 0), Vec2(width, 20), Vec2(-width/2, -10));
+
+        ContactSolver solver;
+        solver.accSettings().gravity = Vec2(0, 100);      // y goes down
+        solver.accSettings().sleeping = sleeping;
+        solver.addBody(Transform(Vec2(0, 10), 0), 0.0f, 0.0f);
+        f32 box_mass = box.calcArea();
+        for (u32 c=0; c<columns; ++c) {
+            for (u32 r=0; r<rows; ++r) {
+                Vec2 pos((c - (columns-1)*0.5f)*BoxSize*1.5f, -BoxSize*(r+0.5f));
+                solver.addBody(Transform(pos, 0), box_mass, box_mass*box.calcInertia());
+            }
+        }
+
+        // bound of box in any rotation
+        f32 r = BoxSize*0.75f;
+        SpatialGrid grid(2*r, columns*rows);
+        fast_vector<u32> proxies(solver.getBodiesCount());
+        for (u32 i=1; i<solver.getBodiesCount(); ++i) {
+            proxies[i] = grid.addProxy(ARect(solver.getPosition(i) - Vec2(r, r), Vec2(2*r, 2*r)), i);
+        }
+
+        OverlapHelper oh;
+        f32 dt = 1.0f/60;
+        f64 collide_ms = 0, solve_ms = 0;
+        u32 awake_cnt = 0;
+        auto step = [&]() {
+            BenchTimer t;
+            for (u32 i=1; i<solver.getBodiesCount(); ++i) {
+                if (!solver.isAwake(i))
+                    continue;
+                grid.moveProxy(proxies[i], ARect(solver.getPosition(i) - Vec2(r, r), Vec2(2*r, 2*r)));
+                // ground is body 0
+                if (solver.getPosition(i).getY() > -BoxSize) {
+                    oh.set(ground, box, solver.calcTransform(0), solver.calcTransform(i));
+                    if (oh.overlaps()) {
+                        oh.calcContactG();
+                        solver.addContact(0, i, oh.getContactManifoldG());
+                    }
+                }
+            }
+            grid.queryPairs([&](u32 a, u32 b) {
+                if (!solver.isAwake(a) && !solver.isAwake(b))
+                    return;
+                oh.set(box, box, solver.calcTransform(a), solver.calcTransform(b));
+                if (!oh.overlaps())
+                    return;
+                oh.calcContactG();
+                solver.addContact(a, b, oh.getContactManifoldG());
+            });
+            collide_ms += t.getElapsedMs();
+
+            t.reset();
+            solver.step(dt);
+            solve_ms += t.getElapsedMs();
+        };
+        auto countAwake = [&]() {
+            u32 cnt = 0;
+            for (u32 i=1; i<solver.getBodiesCount(); ++i) {
+                cnt += solver.isAwake(i);
+            }
+            return cnt;
+        };
+
+        for (u32 s=0; s<SettleSteps; ++s) {
+            step();
+        }
+        Vec2 top_start = solver.getPosition(rows);
+        collide_ms = solve_ms = 0;
+        for (u32 s=0; s<MeasuredSteps; ++s) {
+            step();
+            awake_cnt += countAwake();
+        }
+        f32 drift = (solver.getPosition(rows) - top_start).getLen();
+
+        // push top box of first column to its neighbour
+        solver.setLinearVelocity(rows, Vec2(100, 0));
+        for (u32 s=0; s<10; ++s) {
+            step();
+        }
+        bool woken = solver.isAwake(rows+1) && solver.isAwake(2*rows);
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << " Settled pile " << columns*rows << " boxes" << (sleeping?" (sleeping)":" (no sleeping)")
+                  << ": solver " << solve_ms/MeasuredSteps << " ms per step, collisions " << collide_ms/MeasuredSteps << " ms per step, "
+                  << std::setprecision(1) << f64(awake_cnt)/MeasuredSteps << " awake bodies, " << solver.getIslands().getIslandsCount()
+                  << " islands; top box drift " << std::setprecision(3) << drift << std::endl;
+        if (sleeping && (awake_cnt > columns*rows*MeasuredSteps/10 || !woken)) {
+            std::cout << "  ERROR: pile did not fall asleep or was not woken by touch" << std::endl;
+        }
+    }
+
+    // persistent pairs updated each frame, few pairs replaced and few contact features changed per frame
+    void benchContactCache(u32 pairs_cnt, u32 frames) {
+        srand(10);
+        struct Pair {
+            u32 id_a, id_b;
+            ContactManifold cm;
+        };
+        fast_vector<Pair> pairs(pairs_cnt);
+        u32 next_id = 0;
+        for (u32 i=0; i<pairs_cnt; ++i) {
+            genPair_(pairs[i], next_id);
+        }
+
+        ContactCache cache;
+        f64 ms = 0;
+        u64 contacts_cnt = 0, matched_cnt = 0;
+        u32 wrong_impulses = 0;
+        for (u32 f=0; f<frames; ++f) {
+            // 2% of pairs separate & new ones start touching, 10% of contacts change feature
+            for (u32 i=0; i<pairs_cnt; ++i) {
+                if (rand()%50 == 0) {
+                    genPair_(pairs[i], next_id);
+                }
+                else if (rand()%10 == 0) {
+                    pairs[i].cm.points[0].feature_id = u32(rand());
+                }
+            }
+
+            u32 frame_matched = 0;
+            BenchTimer t;
+            for (u32 i=0; i<pairs_cnt; ++i) {
+                Pair& p = pairs[i];
+                CachedManifold& m = cache.update(p.id_a, p.id_b, p.cm);
+                // solver would write accumulated impulses here
+                for (u32 j=0; j<m.size; ++j) {
+                    wrong_impulses += (m.contacts[j].normal_impulse != 0.0f && m.contacts[j].normal_impulse != f32(m.contacts[j].feature_id%1000));
+                    m.contacts[j].normal_impulse = f32(m.contacts[j].feature_id%1000);
+                }
+                contacts_cnt += m.size;
+            }
+            frame_matched = cache.getMatchedCount();
+            cache.endFrame();
+            ms += t.getElapsedMs();
+            if (f)
+                matched_cnt += frame_matched;
+        }
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << " Contact cache " << pairs_cnt << " pairs, " << frames << " frames: " << ms/frames << " ms per frame, "
+                  << 100.0*matched_cnt/contacts_cnt << "% contacts warm-started (" << cache.getSize() << " pairs, capacity "
+                  << cache.getCapacity() << ")" << std::endl;
+        if (wrong_impulses || cache.getSize() != pairs_cnt) {
+            std::cout << "  ERROR: " << wrong_impulses << " wrong impulses carried over, " << cache.getSize() << " cached pairs" << std::endl;
+        }
+    }
+
+private:
+    template <typename PairT>
+    void genPair_(PairT& p_out, u32& next_id_io) {
+        p_out.id_a = next_id_io++;
+        p_out.id_b = next_id_io++;
+        p_out.cm.size = 1 + rand()%2;
+        for (u32 j=0; j<p_out.cm.size; ++j) {
+            p_out.cm.points[j].feature_id = u32(rand());
+        }
+    }
+};
+
+#endif //BENCH_DYNAMICS_H
@@ -0,0 +1,492 @@
+#ifndef BENCH_MATH_H
+#define BENCH_MATH_H
+
+#include "maths.h"
+#include "bench_common.h"
+
+class MathBench {
+public:
+    void run() {
+        std::cout << "== Math ==" << std::endl;
+        benchVec2Packets(4096, 500);
+        benchAffine(4096, 500);
+        benchTrig(4096, 200);
+        benchTransformCompose(4096, 200);
+        benchTransformHierarchy(2000, 8, 100);
+        benchSupportTails(2000);
+    }
+
+    // rotate + normalize + dot/cross kernel: scalar Vec2 vs Vec2x4 vs Vec2x8
+    void benchVec2Packets(u32 n, u32 reps) {
+        ASSERT(n%8 == 0);
+        srand(4);
+        fast_vector<Vec2> vecs(n);
+        for (u32 i=0; i<n; ++i) {
+            vecs[i] = Vec2(randFloat(-100, 100), randFloat(-100, 100));
+        }
+        Dir2 rot = Angle(0.7f).getDir();
+        Vec2 axis = normalize(Vec2(1, 2));
+
+        fast_vector<f32> scalar_out(n), x4_out(n), x8_out(n);
+        f64 scalar_ms = 1e10, x4_ms = 1e10, x8_ms = 1e10;
+        for (u32 r=0; r<Runs_; ++r) {
+            BenchTimer t;
+            for (u32 k=0; k<reps; ++k) {
+                for (u32 i=0; i<n; ++i) {
+                    Vec2 v = normalize(vecs[i].rotate(rot));
+                    scalar_out[i] = dot(v, axis) + cross(v, vecs[i].perpL());
+                }
+                benchKeep(scalar_out[k%n]);
+            }
+            scalar_ms = std::min(scalar_ms, t.getElapsedMs());
+
+            t.reset();
+            kernel_<F32x4>(vecs.begin(), n, reps, rot, axis, x4_out.begin());
+            x4_ms = std::min(x4_ms, t.getElapsedMs());
+
+            t.reset();
+            kernel_<F32x8>(vecs.begin(), n, reps, rot, axis, x8_out.begin());
+            x8_ms = std::min(x8_ms, t.getElapsedMs());
+        }
+
+        f32 max_err = 0.0f;
+        for (u32 i=0; i<n; ++i) {
+            max_err = std::max(max_err, fabsf(scalar_out[i] - x4_out[i]));
+            max_err = std::max(max_err, fabsf(scalar_out[i] - x8_out[i]));
+        }
+
+        u64 total = u64(n)*reps;
+        std::cout << std::fixed << std::setprecision(2)
+                  << " Vec2 packets (" << (MATHS_SIMD_AVX?"AVX":(MATHS_SIMD_SSE?"SSE":"scalar")) << ") "
+                  << total << " vecs: scalar " << scalar_ms << " ms, x4 " << x4_ms << " ms, x8 " << x8_ms << " ms"
+                  << std::setprecision(6) << " (max error " << max_err << ")" << std::endl;
+        if (max_err > 1e-3f) {
+            std::cout << "  ERROR: packet results differ from scalar Vec2" << std::endl;
+        }
+    }
+
+    // point transform, composition and inverse: Mat3 vs Affine2
+    void benchAffine(u32 n, u32 reps) {
+        srand(5);
+        fast_vector<Vec2> pts(n);
+        fast_vector<Transform> trs(n);
+        fast_vector<Mat3> mats(n);
+        fast_vector<Affine2> affs(n);
+        for (u32 i=0; i<n; ++i) {
+            pts[i] = Vec2(randFloat(-100, 100), randFloat(-100, 100));
+            trs[i] = Transform(Vec2(randFloat(-100, 100), randFloat(-100, 100)), Angle(randFloat(0, 2*f32(M_PI))),
+                               Vec2(randFloat(0.5f, 2.0f), randFloat(0.5f, 2.0f)));
+            mats[i] = trs[i].calcMatrix();
+            affs[i] = trs[i].calcAffine();
+        }
+
+        fast_vector<Vec2> mat_pts(n), aff_pts(n);
+        fast_vector<Mat3> mat_rslts(n);
+        fast_vector<Affine2> aff_rslts(n);
+        f64 mat_tr_ms = 1e10, aff_tr_ms = 1e10, mat_comp_ms = 1e10, aff_comp_ms = 1e10, mat_inv_ms = 1e10, aff_inv_ms = 1e10;
+        for (u32 r=0; r<Runs_; ++r) {
+            BenchTimer t;
+            for (u32 k=0; k<reps; ++k) {
+                const Mat3& m = mats[k%n];
+                for (u32 i=0; i<n; ++i) {
+                    mat_pts[i] = m*pts[i];
+                }
+                benchKeep(mat_pts[k%n]);
+            }
+            mat_tr_ms = std::min(mat_tr_ms, t.getElapsedMs());
+
+            t.reset();
+            for (u32 k=0; k<reps; ++k) {
+                affs[k%n].transformPoints(pts.begin(), n, aff_pts.begin());
+                benchKeep(aff_pts[k%n]);
+            }
+            aff_tr_ms = std::min(aff_tr_ms, t.getElapsedMs());
+
+            t.reset();
+            for (u32 k=0; k<reps; ++k) {
+                for (u32 i=0; i<n; ++i) {
+                    mat_rslts[i] = mats[i]*mats[(i+k)%n];
+                }
+                benchKeep(mat_rslts[k%n]);
+            }
+            mat_comp_ms = std::min(mat_comp_ms, t.getElapsedMs());
+
+            t.reset();
+            for (u32 k=0; k<reps; ++k) {
+                for (u32 i=0; i<n; ++i) {
+                    aff_rslts[i] = affs[i]*affs[(i+k)%n];
+                }
+                benchKeep(aff_rslts[k%n]);
+            }
+            aff_comp_ms = std::min(aff_comp_ms, t.getElapsedMs());
+
+            t.reset();
+            for (u32 k=0; k<reps; ++k) {
+                for (u32 i=0; i<n; ++i) {
+                    mat_rslts[i] = Mat3::invert(mats[i]);
+                }
+                benchKeep(mat_rslts[k%n]);
+            }
+            mat_inv_ms = std::min(mat_inv_ms, t.getElapsedMs());
+
+            t.reset();
+            for (u32 k=0; k<reps; ++k) {
+                for (u32 i=0; i<n; ++i) {
+                    aff_rslts[i] = Affine2::invertRotScale(affs[i]);
+                }
+                benchKeep(aff_rslts[k%n]);
+            }
+            aff_inv_ms = std::min(aff_inv_ms, t.getElapsedMs());
+        }
+
+        f32 max_err = 0.0f;
+        for (u32 i=0; i<n; ++i) {
+            max_err = std::max(max_err, (mat_pts[i] - aff_pts[i]).getLen());
+            Affine2 inv = Affine2(mat_rslts[i]);
+            for (u32 c=0; c<3; ++c) {
+                max_err = std::max(max_err, (inv.getCol(c) - aff_rslts[i].getCol(c)).getLen());
+            }
+            Affine2 gen_inv = Affine2::invert(affs[i]);
+            for (u32 c=0; c<3; ++c) {
+                max_err = std::max(max_err, (gen_inv.getCol(c) - aff_rslts[i].getCol(c)).getLen());
+            }
+        }
+
+        u64 total = u64(n)*reps;
+        std::cout << std::fixed << std::setprecision(2)
+                  << " Affine2 vs Mat3 (sizeof " << sizeof(Affine2) << " vs " << sizeof(Mat3) << ") " << total << " ops:"
+                  << " point transform " << mat_tr_ms << " -> " << aff_tr_ms << " ms,"
+                  << " compose " << mat_comp_ms << " -> " << aff_comp_ms << " ms,"
+                  << " invert " << mat_inv_ms << " -> " << aff_inv_ms << " ms"
+                  << std::setprecision(6) << " (max error " << max_err << ")" << std::endl;
+        if (max_err > 1e-3f) {
+            std::cout << "  ERROR: Affine2 results differ from Mat3" << std::endl;
+        }
+    }
+
+    // sin/cos & atan2 accuracy tiers vs libm (errors against double precision libm)
+    void benchTrig(u32 n, u32 reps) {
+        srand(6);
+        fast_vector<f32> xs(n), ys(n), angles(n);
+        for (u32 i=0; i<n; ++i) {
+            angles[i] = randFloat(-4*Angle::Pi, 4*Angle::Pi);
+            xs[i] = randFloat(-100, 100);
+            ys[i] = randFloat(-100, 100);
+        }
+
+        std::cout << " Trig (" << (MATHS_SIMD_AVX?"AVX":(MATHS_SIMD_SSE?"SSE":"scalar")) << ", MATHS_TRIG_ACCURACY "
+                  << MATHS_TRIG_ACCURACY << ") " << u64(n)*reps << " ops:" << std::endl;
+        std::cout << "  tier        sincos ms  atan2 ms  sincos err  atan2 err" << std::endl;
+        trigRow_<0, false>("libm      ", angles.begin(), ys.begin(), xs.begin(), n, reps);
+        trigRow_<1, false>("1 scalar  ", angles.begin(), ys.begin(), xs.begin(), n, reps);
+        trigRow_<1, true>("1 batch   ", angles.begin(), ys.begin(), xs.begin(), n, reps);
+        trigRow_<2, false>("2 scalar  ", angles.begin(), ys.begin(), xs.begin(), n, reps);
+        trigRow_<2, true>("2 batch   ", angles.begin(), ys.begin(), xs.begin(), n, reps);
+    }
+
+    // Transform composition & incremental rotation, unit length drift of composed rotations
+    void benchTransformCompose(u32 n, u32 reps) {
+        srand(7);
+        fast_vector<Transform> trs(n), rslts(n);
+        fast_vector<Dir2> steps(n);
+        for (u32 i=0; i<n; ++i) {
+            trs[i] = Transform(Vec2(randFloat(-100, 100), randFloat(-100, 100)), Angle(randFloat(-Angle::Pi, Angle::Pi)),
+                               Vec2(randFloat(0.5f, 2.0f), randFloat(0.5f, 2.0f)));
+            steps[i] = Angle(randFloat(-0.1f, 0.1f)).getDir();
+        }
+
+        f64 comp_ms = 1e10, rot_ms = 1e10, rot_angle_ms = 1e10;
+        for (u32 r=0; r<Runs_; ++r) {
+            BenchTimer t;
+            for (u32 k=0; k<reps; ++k) {
+                for (u32 i=0; i<n; ++i) {
+                    rslts[i] = trs[i]*trs[(i+k)%n];
+                }
+                benchKeep(rslts[k%n]);
+            }
+            comp_ms = std::min(comp_ms, t.getElapsedMs());
+
+            t.reset();
+            for (u32 k=0; k<reps; ++k) {
+                for (u32 i=0; i<n; ++i) {
+                    rslts[i].rotate(steps[(i+k)%n]);
+                }
+                benchKeep(rslts[k%n]);
+            }
+            rot_ms = std::min(rot_ms, t.getElapsedMs());
+
+            t.reset();
+            for (u32 k=0; k<reps; ++k) {
+                for (u32 i=0; i<n; ++i) {
+                    rslts[i].rotate(Angle(0.01f));
+                }
+                benchKeep(rslts[k%n]);
+            }
+            rot_angle_ms = std::min(rot_angle_ms, t.getElapsedMs());
+        }
+
+        // long chain of small rotations must stay unit
+        Transform chain;
+        for (u32 i=0; i<1000000; ++i) {
+            chain.rotate(steps[i%n]);
+        }
+        f32 drift = fabsf(chain.getRotDir().getLen() - 1.0f);
+
+        u64 total = u64(n)*reps;
+        std::cout << std::fixed << std::setprecision(2)
+                  << " Transform (sizeof " << sizeof(Transform) << ") " << total << " ops: compose " << comp_ms << " ms,"
+                  << " rotate(Dir2) " << rot_ms << " ms, rotate(Angle) " << rot_angle_ms << " ms"
+                  << std::scientific << std::setprecision(2) << " (unit drift after 1M rotations " << drift << ")"
+                  << std::fixed << std::endl;
+        if (drift > 1e-5f) {
+            std::cout << "  ERROR: composed rotation is not unit" << std::endl;
+        }
+    }
+
+    // bodies with attached colliders (+ sub-collider per collider): scalar Transform composition vs TransformHierarchy,
+    // relative transforms of collider pairs
+    void benchTransformHierarchy(u32 bodies_cnt, u32 colliders_per_body, u32 frames) {
+        srand(8);
+        auto rand_tr = [](f32 pos_range) {
+            return Transform(Vec2(randFloat(-pos_range, pos_range), randFloat(-pos_range, pos_range)),
+                             Angle(randFloat(-Angle::Pi, Angle::Pi)), Vec2(randFloat(0.5f, 2.0f), randFloat(0.5f, 2.0f)));
+        };
+
+        TransformHierarchy th;
+        fast_vector<u32> bodies, colliders, parents;        // parents by node id
+        fast_vector<Transform> locals;                      // by node id
+        for (u32 i=0; i<bodies_cnt; ++i) {
+            locals.push_back(rand_tr(100.0f));
+            parents.push_back(InvalidId());
+            bodies.push_back(th.addNode(locals.back()));
+        }
+        for (u32 i=0; i<bodies_cnt; ++i) {
+            for (u32 j=0; j<colliders_per_body; ++j) {
+                locals.push_back(rand_tr(2.0f));
+                parents.push_back(bodies[i]);
+                u32 c = th.addNode(locals.back(), bodies[i]);
+                colliders.push_back(c);
+                locals.push_back(rand_tr(0.5f));
+                parents.push_back(c);
+                th.addNode(locals.back(), c);
+            }
+        }
+        u32 nodes_cnt = locals.size();
+        fast_vector<Transform> worlds(nodes_cnt);
+
+        fast_vector<u32> refs, targets;
+        for (u32 i=0; i<colliders.size()*2; ++i) {
+            refs.push_back(colliders[rand()%colliders.size()]);
+            targets.push_back(colliders[rand()%colliders.size()]);
+        }
+        fast_vector<Transform> rel_scalar(refs.size()), rel_batch(refs.size());
+
+        // bodies move every frame, each frame also moves 1/10 of bodies only
+        fast_vector<Transform> moves(bodies_cnt);
+        for (u32 i=0; i<bodies_cnt; ++i) {
+            moves[i] = Transform(Vec2(randFloat(-0.1f, 0.1f), randFloat(-0.1f, 0.1f)), Angle(randFloat(-0.01f, 0.01f)));
+        }
+
+        th.update();
+        f64 scalar_ms = 1e10, th_ms = 1e10, th_partial_ms = 1e10, rel_scalar_ms = 1e10, rel_batch_ms = 1e10;
+        for (u32 r=0; r<Runs_; ++r) {
+            BenchTimer t;
+            for (u32 f=0; f<frames; ++f) {
+                for (u32 i=0; i<bodies_cnt; ++i) {
+                    locals[bodies[i]] = moves[i]*locals[bodies[i]];
+                }
+                // nodes were added parents first
+                for (u32 n=0; n<nodes_cnt; ++n) {
+                    worlds[n] = (parents[n] == u32(InvalidId()))?locals[n]:worlds[parents[n]]*locals[n];
+                }
+                benchKeep(worlds[f%nodes_cnt]);
+            }
+            scalar_ms = std::min(scalar_ms, t.getElapsedMs());
+
+            t.reset();
+            for (u32 f=0; f<frames; ++f) {
+                for (u32 i=0; i<bodies_cnt; ++i) {
+                    th.setLocal(bodies[i], moves[i]*th.getLocal(bodies[i]));
+                }
+                th.update();
+                benchKeep(th.getWorld(f%nodes_cnt));
+            }
+            th_ms = std::min(th_ms, t.getElapsedMs());
+
+            t.reset();
+            for (u32 f=0; f<frames; ++f) {
+                for (u32 i=f%10; i<bodies_cnt; i+=10) {
+                    th.setLocal(bodies[i], moves[i]*th.getLocal(bodies[i]));
+                }
+                th.update();
+                benchKeep(th.getWorld(f%nodes_cnt));
+            }
+            th_partial_ms = std::min(th_partial_ms, t.getElapsedMs());
+
+            t.reset();
+            for (u32 f=0; f<frames; ++f) {
+                for (u32 i=0; i<refs.size(); ++i) {
+                    rel_scalar[i] = (-th.getWorld(refs[i]))*th.getWorld(targets[i]);
+                }
+                benchKeep(rel_scalar[f%refs.size()]);
+            }
+            rel_scalar_ms = std::min(rel_scalar_ms, t.getElapsedMs());
+
+            t.reset();
+            for (u32 f=0; f<frames; ++f) {
+                th.calcRelativeTransforms(refs.begin(), targets.begin(), refs.size(), rel_batch.begin());
+                benchKeep(rel_batch[f%refs.size()]);
+            }
+            rel_batch_ms = std::min(rel_batch_ms, t.getElapsedMs());
+        }
+
+        // compare with scalar composition of the same locals
+        for (u32 n=0; n<nodes_cnt; ++n) {
+            locals[n] = th.getLocal(n);
+            worlds[n] = (parents[n] == u32(InvalidId()))?locals[n]:worlds[parents[n]]*locals[n];
+        }
+        f32 max_err = 0.0f;
+        auto tr_err = [](const Transform& t1, const Transform& t2) {
+            f32 pos_scale = std::max(1.0f, t1.getPosition().getLen());
+            return std::max((t1.getPosition() - t2.getPosition()).getLen()/pos_scale,
+                            std::max((t1.getRotDir() - t2.getRotDir()).getLen(), (t1.getScale() - t2.getScale()).getLen()));
+        };
+        for (u32 n=0; n<nodes_cnt; ++n) {
+            max_err = std::max(max_err, tr_err(worlds[n], th.getWorld(n)));
+        }
+        for (u32 i=0; i<refs.size(); ++i) {
+            max_err = std::max(max_err, tr_err(rel_scalar[i], rel_batch[i]));
+        }
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << " Transform hierarchy (" << (MATHS_SIMD_AVX?"AVX":(MATHS_SIMD_SSE?"SSE":"scalar")) << ") " << nodes_cnt << " nodes, "
+                  << frames << " frames: scalar " << scalar_ms << " ms, update() " << th_ms << " ms (1/10 moving " << th_partial_ms << " ms),"
+                  << " relative " << refs.size() << " pairs: scalar " << rel_scalar_ms << " ms, batch " << rel_batch_ms << " ms"
+                  << std::setprecision(6) << " (max error " << max_err << ")" << std::endl;
+        if (max_err > 1e-4f) {
+            std::cout << "  ERROR: hierarchy results differ from Transform composition" << std::endl;
+        }
+    }
+
+    // SIMD support search for point counts with short last block (points_cnt%64 < packet width),
+    // exactly sized arrays (run with ASan to catch reads past the end), integer coords to get ties
+    void benchSupportTails(u32 dirs_cnt) {
+        srand(9);
+        fast_vector<Dir2> dirs(dirs_cnt);
+        for (u32 i=0; i<dirs_cnt; ++i) {
+            dirs[i] = Angle(randFloat(-Angle::Pi, Angle::Pi)).getDir();
+        }
+        // axis directions hit ties of equal coords
+        dirs[0] = Dir2(1, 0);
+        dirs[1] = Dir2(0, -1);
+
+        u32 queries = 0, mismatches = 0;
+        f64 scalar_ms = 0.0, simd_ms = 0.0;
+        for (u32 blocks=0; blocks<3; ++blocks) {
+            for (u32 tail=0; tail<=8; ++tail) {
+                u32 pts_cnt = blocks*64 + tail;
+                if (pts_cnt < 8)
+                    continue;
+                fast_vector<Vec2> pts(pts_cnt);
+                for (u32 i=0; i<pts_cnt; ++i) {
+                    pts[i].set(f32(rand()%16), f32(rand()%16));
+                }
+                fast_vector<u32> scalar_ids(dirs_cnt*2), simd_ids(dirs_cnt*2);
+
+                BenchTimer t;
+                for (u32 i=0; i<dirs_cnt; ++i) {
+                    scalar_ids[i] = maths::calcSupportScalar(pts.begin(), pts_cnt, dirs[i]);
+                    maths::calcSupportBestWorstScalar(pts.begin(), pts_cnt, dirs[i], scalar_ids[i], scalar_ids[dirs_cnt+i]);
+                }
+                scalar_ms += t.getElapsedMs();
+                t.reset();
+                for (u32 i=0; i<dirs_cnt; ++i) {
+                    simd_ids[i] = maths::calcSupport(pts.begin(), pts_cnt, dirs[i]);
+                    maths::calcSupportBestWorst(pts.begin(), pts_cnt, dirs[i], simd_ids[i], simd_ids[dirs_cnt+i]);
+                }
+                simd_ms += t.getElapsedMs();
+
+                for (u32 i=0; i<dirs_cnt; ++i) {
+                    u32 single_id = maths::calcSupport(pts.begin(), pts_cnt, dirs[i]);
+                    if (single_id != scalar_ids[i] || simd_ids[i] != scalar_ids[i] || simd_ids[dirs_cnt+i] != scalar_ids[dirs_cnt+i])
+                        ++mismatches;
+                }
+                queries += dirs_cnt;
+            }
+        }
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << " Support tails (" << (MATHS_SIMD_SSE?"simd":"scalar") << "): " << queries << " queries scalar "
+                  << scalar_ms << " ms, simd " << simd_ms << " ms" << std::endl;
+        if (mismatches) {
+            std::cout << "  ERROR: " << mismatches << " support ids differ from scalar search" << std::endl;
+        }
+    }
+
+private:
+    static constexpr u32 Runs_ = 5;
+
+    template <typename F>
+    void kernel_(const Vec2* vecs, u32 n, u32 reps, const Dir2& rot, const Vec2& axis, f32* out) {
+        Vec2xN<F> axis_p(axis);
+        for (u32 k=0; k<reps; ++k) {
+            for (u32 i=0; i<n; i+=F::Width) {
+                Vec2xN<F> p = Vec2xN<F>::load(vecs+i);
+                Vec2xN<F> v = normalize(p.rotate(rot));
+                (dot(v, axis_p) + cross(v, p.perpL())).store(out+i);
+            }
+            benchKeep(out[k%n]);
+        }
+    }
+
+    template <u32 Tier, bool Batch>
+    void trigRow_(const char* name, const f32* angles, const f32* ys, const f32* xs, u32 n, u32 reps) {
+        fast_vector<f32> sins(n), coss(n), atans(n);
+        f64 sc_ms = 1e10, at_ms = 1e10;
+        for (u32 r=0; r<Runs_; ++r) {
+            BenchTimer t;
+            for (u32 k=0; k<reps; ++k) {
+                if (Batch) {
+                    maths::calcSinCos<Tier>(angles, n, sins.begin(), coss.begin());
+                }
+                else {
+                    for (u32 i=0; i<n; ++i) {
+                        maths::calcSinCos<Tier>(angles[i], sins[i], coss[i]);
+                    }
+                }
+                benchKeep(sins[k%n]);
+            }
+            sc_ms = std::min(sc_ms, t.getElapsedMs());
+
+            t.reset();
+            for (u32 k=0; k<reps; ++k) {
+                if (Batch) {
+                    maths::calcAtan2<Tier>(ys, xs, n, atans.begin());
+                }
+                else {
+                    for (u32 i=0; i<n; ++i) {
+                        atans[i] = maths::calcAtan2<Tier>(ys[i], xs[i]);
+                    }
+                }
+                benchKeep(atans[k%n]);
+            }
+            at_ms = std::min(at_ms, t.getElapsedMs());
+        }
+
+        f64 sc_err = 0.0, at_err = 0.0;
+        for (u32 i=0; i<n; ++i) {
+            sc_err = std::max(sc_err, fabs(sins[i] - sin(f64(angles[i]))));
+            sc_err = std::max(sc_err, fabs(coss[i] - cos(f64(angles[i]))));
+            at_err = std::max(at_err, fabs(atans[i] - atan2(f64(ys[i]), f64(xs[i]))));
+        }
+        std::cout << "  " << name << std::fixed << std::setprecision(2) << std::setw(9) << sc_ms << " " << std::setw(9) << at_ms
+                  << std::scientific << std::setprecision(2) << "  " << std::setw(10) << sc_err << " " << std::setw(10) << at_err
+                  << std::fixed << std::endl;
+        f64 bound = (Tier == 1)?2e-5:1e-6;
+        if (Tier != 0 && (sc_err > bound || at_err > bound)) {
+            std::cout << "  ERROR: tier " << Tier << " error above " << bound << std::endl;
+        }
+    }
+};
+
+#endif //BENCH_MATH_H
@@ -0,0 +1,899 @@
+#ifndef BENCH_NARROWPHASE_H
+#define BENCH_NARROWPHASE_H
+
+#include "maths.h"
+#include "bench_common.h"
+
+class NarrowphaseBench {
+public:
+    void run() {
+        std::cout << "== Narrowphase ==" << std::endl;
+        u32 sizes[] = {1000, 20000, 100000};
+        for (u32 i=0; i<ARRAY_SIZE(sizes); ++i) {
+            benchBatch(sizes[i]);
+        }
+        benchParallel(100000);
+        benchPairScratch(100000);
+        benchDispatch(4096, 200);
+        benchPgonLayout(20000);
+        benchTransformBound(20000, 8);
+        benchTransformBound(5000, 32);
+        u32 pgon_sizes[] = {8, 16, 32};
+        for (u32 i=0; i<ARRAY_SIZE(pgon_sizes); ++i) {
+            benchSupport(pgon_sizes[i], 5000);
+        }
+        benchHillClimbing(32, 5000);
+        benchGJKWarmStart(50, 20, 60);
+        benchEPA(32, 5000);
+        benchScaledOverlap(20000);
+        benchDistance(20000);
+        benchTOI(2000);
+    }
+
+    // fast small bullets crossing thin walls in one step (discrete overlaps() at start and end miss them)
+    // misses are verified by sampling the motion
+    void benchTOI(u32 n) {
+        srand(9);
+        const char* names[] = {"Circle", "Rect", "Pgon"};
+        Shape bullets[3], walls[3];
+        bullets[0].create<Circle>(Vec2(0, 0), 1.0f);
+        bullets[1].create<Rect>(Vec2(0, 0), Vec2(2, 2), Vec2(-1, -1));
+        Vec2 bullet_pts[6], wall_pts[] = {{-100, -1}, {100, -1.5f}, {100, 1.5f}, {-100, 1}};
+        for (u32 i=0; i<6; ++i) {
+            bullet_pts[i] = Angle(i*f32(M_PI)/3).getDir();
+        }
+        bullets[2].create<Pgon>(Pgon(bullet_pts, 6));
+        walls[0].create<Circle>(Vec2(0, 0), 20.0f);
+        walls[1].create<Rect>(Vec2(0, 0), Vec2(200, 2), Vec2(-100, -1));
+        walls[2].create<Pgon>(Pgon(wall_pts, 4));
+
+        fast_vector<Transform> starts(n), ends(n);
+        for (u32 i=0; i<n; ++i) {
+            starts[i] = Transform(Vec2(randFloat(-120, 120), randFloat(-60, -30)), Angle(randFloat(0, 2*f32(M_PI))));
+            ends[i] = Transform(Vec2(randFloat(-120, 120), randFloat(30, 60)), Angle(randFloat(0, 2*f32(M_PI))));
+        }
+        // also scaled walls (distance early-out bound is global)
+        Transform wall_trs[] = {Transform(Vec2(0, 0), Angle(0.1f)), Transform(Vec2(0, 0), Angle(0.1f), Vec2(0.5f, 0.5f))};
+
+        TOIHelper th;
+        TOIInfo toi;
+        for (u32 ws=0; ws<2; ++ws) {
+            const Transform& wall_tr = wall_trs[ws];
+            for (u32 b=0; b<3; ++b) {
+                for (u32 w=0; w<3; ++w) {
+                    f64 ms = 1e10;
+                    u32 hits = 0, iters = 0;
+                    for (u32 r=0; r<Runs_; ++r) {
+                        hits = iters = 0;
+                        BenchTimer t;
+                        for (u32 i=0; i<n; ++i) {
+                            hits += th.calcTOI(bullets[b], starts[i], ends[i], walls[w], wall_tr, wall_tr, toi);
+                            iters += toi.iterations;
+                        }
+                        ms = std::min(ms, t.getElapsedMs());
+                    }
+
+                    // hits: shapes touch at toi.t, misses: no overlap along motion
+                    u32 errors = 0, tunneled = 0;
+                    OverlapHelper oh;
+                    DistanceInfo di;
+                    for (u32 i=0; i<n; ++i) {
+                        bool hit = th.calcTOI(bullets[b], starts[i], ends[i], walls[w], wall_tr, wall_tr, toi);
+                        if (hit) {
+                            oh.set(bullets[b], walls[w], TOIHelper::interpolate(starts[i], ends[i], toi.t), wall_tr);
+                            oh.calcDistance(di);
+                            errors += (di.distance > MATHS_TOI_TOLERANCE);
+                            oh.set(bullets[b], walls[w], ends[i], wall_tr);
+                            tunneled += !oh.overlaps();
+                        }
+                        else {
+                            for (u32 s=0; s<=64; ++s) {
+                                oh.set(bullets[b], walls[w], TOIHelper::interpolate(starts[i], ends[i], s/64.0f), wall_tr);
+                                if (oh.overlaps()) {
+                                    ++errors;
+                                    break;
+                                }
+                            }
+                        }
+                    }
+
+                    std::cout << std::fixed << std::setprecision(2)
+                              << " TOI " << names[b] << " vs " << names[w] << (ws?" scaled":"") << " wall: " << n/ms << "k queries/s, avg iterations "
+                              << f32(iters)/n << " (" << hits << " hits, " << tunneled << " would tunnel)" << std::endl;
+                    if (errors) {
+                        std::cout << "  ERROR: " << errors << " wrong times of impact" << std::endl;
+                    }
+                }
+            }
+        }
+    }
+
+    // GJK distance of mixed shape types through OverlapHelper, unlimited and with max_dist early-out
+    // closest points are checked to be supports of both shapes along the normal (separating axis)
+    void benchDistance(u32 n) {
+        fast_vector<Shape> shapes;
+        fast_vector<Transform> transforms;
+        genScene_(n*2, shapes, transforms);
+        // pairs moved to origin (checks of closest points need float precision)
+        for (u32 i=0; i<n; ++i) {
+            transforms[i*2+1].accPosition() -= transforms[i*2].getPosition();
+            transforms[i*2].setPosition(Vec2(0, 0));
+            // uniformly scaled pairs (max_dist is global, ref. shape's frame is scaled)
+            if (i%2) {
+                f32 sa = randFloat(0.5f, 1.5f), sb = randFloat(0.5f, 1.5f);
+                transforms[i*2].setScale(Vec2(sa, sa));
+                transforms[i*2+1].setScale(Vec2(sb, sb));
+            }
+        }
+
+        OverlapHelper oh;
+        fast_vector<DistanceInfo> dists(n);
+        fast_vector<u8> in_range(n);
+        static constexpr f32 MaxDist = 5.0f;
+        f64 full_ms = 1e10, limited_ms = 1e10;
+        u32 limited_cnt = 0;
+        for (u32 r=0; r<Runs_; ++r) {
+            BenchTimer t;
+            for (u32 i=0; i<n; ++i) {
+                oh.set(shapes[i*2], shapes[i*2+1], transforms[i*2], transforms[i*2+1]);
+                oh.calcDistance(dists[i]);
+            }
+            full_ms = std::min(full_ms, t.getElapsedMs());
+
+            DistanceInfo di;
+            limited_cnt = 0;
+            t.reset();
+            for (u32 i=0; i<n; ++i) {
+                oh.set(shapes[i*2], shapes[i*2+1], transforms[i*2], transforms[i*2+1]);
+                in_range[i] = oh.calcDistance(di, MaxDist);
+                limited_cnt += in_range[i];
+            }
+            limited_ms = std::min(limited_ms, t.getElapsedMs());
+        }
+
+        u32 separated_cnt = 0, mismatches = 0;
+        for (u32 i=0; i<n; ++i) {
+            oh.set(shapes[i*2], shapes[i*2+1], transforms[i*2], transforms[i*2+1]);
+            bool overlap = oh.overlaps();
+            const DistanceInfo& di = dists[i];
+            if (bool(in_range[i]) != (di.distance <= MaxDist)) {
+                ++mismatches;
+                continue;
+            }
+            if (di.distance == 0.0f) {
+                // rays completely inside shapes do not overlap them
+                bool has_ray = shapes[i*2].getTypeId() == Shape::getTypeIdOf<Ray>() || shapes[i*2+1].getTypeId() == Shape::getTypeIdOf<Ray>();
+                mismatches += (!overlap && !has_ray);
+                continue;
+            }
+            ++separated_cnt;
+            if (overlap) {
+                ++mismatches;
+                continue;
+            }
+            Shape a = shapes[i*2];
+            Shape b = shapes[i*2+1];
+            a.transform(transforms[i*2]);
+            b.transform(transforms[i*2+1]);
+            f32 a_err = dot(di.point_a - a.calcSupport(-di.normal), di.normal);
+            f32 b_err = dot(b.calcSupport(di.normal) - di.point_b, di.normal);
+            f32 d_err = fabsf(dot(di.point_a - di.point_b, di.normal) - di.distance);
+            if (fabsf(a_err) > 2e-3f || fabsf(b_err) > 2e-3f || d_err > 2e-3f)
+                ++mismatches;
+        }
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << " GJK distance n=" << n << ": " << full_ms << " ms (" << separated_cnt << " separated), max_dist " << MaxDist
+                  << " " << limited_ms << " ms (" << limited_cnt << " in range)" << std::endl;
+        if (mismatches) {
+            std::cout << "  ERROR: " << mismatches << " distances are not between closest points" << std::endl;
+        }
+    }
+
+    // uniformly scaled pairs away from origin (target is transformed to scaled ref. shape's frame)
+    // compared with overlaps of globally transformed shapes
+    void benchScaledOverlap(u32 n) {
+        fast_vector<Shape> shapes;
+        fast_vector<Transform> transforms;
+        genScene_(n*2, shapes, transforms);
+        for (u32 i=0; i<n; ++i) {
+            // pairs kept near origin (global shapes need float precision), far enough for translation to matter
+            Vec2 offset(f32((i%64)*40) - 1280, f32(((i/64)%64)*40) - 1280);
+            transforms[i*2+1].accPosition() += offset - transforms[i*2].getPosition();
+            transforms[i*2].setPosition(offset);
+            f32 sa = randFloat(0.5f, 1.5f), sb = randFloat(0.5f, 1.5f);
+            transforms[i*2].setScale(Vec2(sa, sa));
+            transforms[i*2+1].setScale(Vec2(sb, sb));
+        }
+
+        OverlapHelper oh;
+        u32 overlaps_cnt = 0, mismatches = 0;
+        for (u32 i=0; i<n; ++i) {
+            Shape a = shapes[i*2];
+            Shape b = shapes[i*2+1];
+            a.transform(transforms[i*2]);
+            b.transform(transforms[i*2+1]);
+            bool overlap = a.overlaps(b);
+            overlaps_cnt += overlap;
+
+            oh.set(shapes[i*2], shapes[i*2+1], transforms[i*2], transforms[i*2+1]);
+            mismatches += (oh.overlaps() != overlap);
+        }
+
+        std::cout << " scaled overlaps n=" << n << ": " << overlaps_cnt << " overlapping" << std::endl;
+        if (mismatches) {
+            std::cout << "  ERROR: " << mismatches << " results differ from globally transformed shapes" << std::endl;
+        }
+    }
+
+    // deep penetrations of round pgons (nearly concentric pairs), EPA needs many expansions
+    // default tolerance vs tight tolerance, reports iterations and error bound of penetration depth
+    void benchEPA(u32 pts_cnt, u32 n) {
+        srand(8);
+        fast_vector<Pgon> pgons;
+        pgons.reserve(2*n);
+        for (u32 i=0; i<n; ++i) {
+            Vec2 pos(f32((i%64)*50), f32((i/64)*50));
+            pgons.push_back(genPgon_(pts_cnt));
+            pgons.back().transform(Transform(pos, Angle(randFloat(0, 2*f32(M_PI)))));
+            pgons.back().calculateNormalsIfNeeded();
+            pgons.push_back(genPgon_(pts_cnt));
+            pgons.back().transform(Transform(pos + Vec2(randFloat(-1, 1), randFloat(-1, 1)), Angle(randFloat(0, 2*f32(M_PI)))));
+            pgons.back().calculateNormalsIfNeeded();
+        }
+
+        f32 tolerances[] = {MATHS_EPA_TOLERANCE, 1e-5f};
+        for (u32 t_id=0; t_id<ARRAY_SIZE(tolerances); ++t_id) {
+            GJK2D<Pgon, Pgon> gjk;
+            f64 ms = 1e10, iters = 0, err_bound = 0;
+            f32 max_err_bound = 0;
+            u32 budget_hits = 0;
+            for (u32 r=0; r<Runs_; ++r) {
+                iters = err_bound = 0;
+                max_err_bound = 0;
+                budget_hits = 0;
+                f64 run_ms = 0;
+                for (u32 i=0; i<n; ++i) {
+                    gjk.setShapes(pgons[2*i], pgons[2*i+1]);
+                    if (!gjk.isOverlapping())
+                        continue;
+                    BenchTimer t;
+                    gjk.calcPenetrationInfo(tolerances[t_id]);
+                    run_ms += t.getElapsedMs();
+                    iters += gjk.getEPAIterations();
+                    err_bound += gjk.getEPAErrorBound();
+                    max_err_bound = std::max(max_err_bound, gjk.getEPAErrorBound());
+                    budget_hits += (gjk.getEPAIterations() == GJK2D<Pgon, Pgon>::MaxEPAIterations);
+                }
+                ms = std::min(ms, run_ms);
+            }
+            std::cout << std::fixed << std::setprecision(2)
+                      << " EPA " << pts_cnt << "-gons deep penetration " << n << " pairs, tolerance " << std::setprecision(5) << tolerances[t_id]
+                      << std::setprecision(2) << ": " << ms << " ms, avg iterations " << iters/n
+                      << std::setprecision(6) << ", error bound avg " << err_bound/n << " max " << max_err_bound
+                      << " (" << budget_hits << " hit iteration budget)" << std::endl;
+        }
+    }
+
+    // persistent pairs in box stacks (resting contacts + separated neighbouring stacks), jittering each frame
+    // cold GJK vs GJK warm-started from per pair GJKCache
+    void benchGJKWarmStart(u32 stacks, u32 height, u32 frames) {
+        srand(7);
+        Vec2 box_pts[] = {{-10, -5}, {10, -5}, {10, 5}, {-10, 5}};
+        Pgon box(box_pts, 4);
+        u32 n = stacks*height;
+        fast_vector<Transform> base_trs(n);
+        for (u32 i=0; i<n; ++i) {
+            u32 stack = i/height, level = i%height;
+            // boxes overlap by 0.5 vertically, stacks are 2 apart
+            base_trs[i] = Transform(Vec2(f32(stack)*22.0f, -f32(level)*9.5f), Angle(0));
+        }
+        fast_vector<std::pair<u32, u32> > pairs;
+        for (u32 i=0; i<n; ++i) {
+            if (i%height != height-1)
+                pairs.push_back(std::make_pair(i, i+1));
+            if (i+height < n)
+                pairs.push_back(std::make_pair(i, i+height));
+        }
+
+        fast_vector<Pgon> world(n);
+        fast_vector<GJKCache> caches(pairs.size());
+        GJK2D<Pgon, Pgon> gjk;
+        u64 cold_iters = 0, warm_iters = 0;
+        u32 overlaps_cnt = 0, mismatches = 0;
+        f64 cold_ms = 0, warm_ms = 0;
+        for (u32 f=0; f<frames; ++f) {
+            for (u32 i=0; i<n; ++i) {
+                Transform tr = base_trs[i];
+                tr.setPosition(tr.getPosition() + Vec2(randFloat(-0.05f, 0.05f), randFloat(-0.05f, 0.05f)));
+                tr.setRotation(Angle(randFloat(-0.005f, 0.005f)));
+                world[i].setTransformed(box, tr);
+            }
+
+            BenchTimer t;
+            for (u32 i=0; i<pairs.size(); ++i) {
+                gjk.setShapes(world[pairs[i].first], world[pairs[i].second]);
+                overlaps_cnt += gjk.isOverlapping();
+                cold_iters += gjk.getLastIterations();
+            }
+            cold_ms += t.getElapsedMs();
+
+            u32 warm_overlaps = 0;
+            t.reset();
+            for (u32 i=0; i<pairs.size(); ++i) {
+                gjk.setShapes(world[pairs[i].first], world[pairs[i].second]);
+                warm_overlaps += gjk.isOverlapping(caches[i]);
+                warm_iters += gjk.getLastIterations();
+            }
+            warm_ms += t.getElapsedMs();
+            // first frame fills caches, later results must match cold ones (also penetration from restored simplex)
+            if (f == frames-1) {
+                for (u32 i=0; i<pairs.size(); ++i) {
+                    world[pairs[i].first].calculateNormalsIfNeeded();
+                    world[pairs[i].second].calculateNormalsIfNeeded();
+                    gjk.setShapes(world[pairs[i].first], world[pairs[i].second]);
+                    bool overlap = gjk.isOverlapping();
+                    if (overlap != caches[i].overlapping) {
+                        ++mismatches;
+                        continue;
+                    }
+                    if (!overlap)
+                        continue;
+                    gjk.calcPenetrationInfo();
+                    ContactManifold cm = gjk.getContactManifold();
+                    gjk.isOverlapping(caches[i]);
+                    gjk.calcPenetrationInfo();
+                    if (cm.size != gjk.getContactManifold().size || (cm.normal - gjk.getContactManifold().normal).getSqrLen() > 1e-4f)
+                        ++mismatches;
+                }
+            }
+        }
+
+        f64 tests = f64(pairs.size())*frames;
+        std::cout << std::fixed << std::setprecision(2)
+                  << " GJK warm start " << stacks << "x" << height << " stacks, " << pairs.size() << " pairs, " << frames << " frames: "
+                  << "avg iterations cold " << cold_iters/tests << ", warm " << warm_iters/tests
+                  << "; cold " << cold_ms << " ms, warm " << warm_ms << " ms (" << overlaps_cnt/frames << " overlaps per frame)" << std::endl;
+        if (mismatches) {
+            std::cout << "  ERROR: " << mismatches << " warm-started results differ from cold GJK" << std::endl;
+        }
+    }
+
+    // support search from previous support vertex (slowly rotating direction as in GJK/EPA iterations)
+    // GJK overlap + penetration uses it when MATHS_GJK_HILL_CLIMBING (compare with -DMATHS_GJK_HILL_CLIMBING=1 build)
+    void benchHillClimbing(u32 pts_cnt, u32 n) {
+        srand(6);
+        fast_vector<Pgon> pgons;
+        pgons.reserve(n);
+        for (u32 i=0; i<n; ++i) {
+            pgons.push_back(genPgon_(pts_cnt));
+            // compact grid (far from origin rounding errors break convexity of projections)
+            u32 cell = i/2;
+            Vec2 pos(f32((cell%64)*50), f32((cell/64)*50));
+            if (i%2)
+                pos += Vec2(randFloat(-15, 15), randFloat(-15, 15));
+            pgons.back().transform(Transform(pos, Angle(randFloat(0, 2*f32(M_PI)))));
+            pgons.back().calculateNormalsIfNeeded();
+        }
+
+        static constexpr u32 Steps = 16;
+        f64 full_ms = 1e10, climb_ms = 1e10, gjk_ms = 1e10;
+        u32 overlaps_cnt = 0;
+        fast_vector<u32> full_ids(n*Steps), climb_ids(n*Steps);
+        for (u32 r=0; r<Runs_; ++r) {
+            BenchTimer t;
+            for (u32 i=0; i<n; ++i) {
+                for (u32 s=0; s<Steps; ++s) {
+                    pgons[i].calcSupport(Angle(s*0.2f + i).getDir(), full_ids[i*Steps+s]);
+                }
+            }
+            full_ms = std::min(full_ms, t.getElapsedMs());
+
+            t.reset();
+            for (u32 i=0; i<n; ++i) {
+                u32 id = 0;
+                for (u32 s=0; s<Steps; ++s) {
+                    pgons[i].calcSupportFrom(Angle(s*0.2f + i).getDir(), id);
+                    climb_ids[i*Steps+s] = id;
+                }
+            }
+            climb_ms = std::min(climb_ms, t.getElapsedMs());
+
+            GJK2D<Pgon, Pgon> gjk;
+            overlaps_cnt = 0;
+            t.reset();
+            for (u32 i=0; i+1<n; i+=2) {
+                gjk.setShapes(pgons[i], pgons[i+1]);
+                if (gjk.isOverlapping()) {
+                    gjk.calcPenetrationInfo();
+                    ++overlaps_cnt;
+                }
+            }
+            gjk_ms = std::min(gjk_ms, t.getElapsedMs());
+        }
+
+        // ids can differ when two points are equally good
+        u32 mismatches = 0;
+        for (u32 i=0; i<n; ++i) {
+            for (u32 s=0; s<Steps; ++s) {
+                Dir2 d = Angle(s*0.2f + i).getDir();
+                if (dot(pgons[i].getPoint(full_ids[i*Steps+s]) - pgons[i].getPoint(climb_ids[i*Steps+s]), d) > 1e-3f)
+                    ++mismatches;
+            }
+        }
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << " Hill climbing " << pts_cnt << "-gons: " << n*Steps << " rotating queries full search " << full_ms
+                  << " ms, from previous " << climb_ms << " ms; GJK+EPA " << (MATHS_GJK_HILL_CLIMBING?"(climbing) ":"(full search) ")
+                  << n/2 << " pairs " << gjk_ms << " ms (" << overlaps_cnt << " overlaps)" << std::endl;
+        if (mismatches) {
+            std::cout << "  ERROR: hill climbing found worse support points in " << mismatches << " queries" << std::endl;
+        }
+    }
+
+    // scalar vs SIMD support search, GJK overlap test uses maths::calcSupport (compare with -DMATHS_NO_SIMD build)
+    void benchSupport(u32 pts_cnt, u32 n) {
+        srand(5);
+        fast_vector<Pgon> pgons;
+        pgons.reserve(n);
+        for (u32 i=0; i<n; ++i) {
+            pgons.push_back(genPgon_(pts_cnt));
+            Vec2 pos(f32((i/2)*100), 0);
+            if (i%2)
+                pos += Vec2(randFloat(-20, 20), randFloat(-20, 20));
+            pgons.back().transform(Transform(pos, Angle(randFloat(0, 2*f32(M_PI)))));
+        }
+        fast_vector<Dir2> dirs(n);
+        for (u32 i=0; i<n; ++i) {
+            dirs[i] = Angle(randFloat(0, 2*f32(M_PI))).getDir();
+        }
+
+        f64 scalar_ms = 1e10, simd_ms = 1e10, gjk_ms = 1e10;
+        u32 mismatches = 0, overlaps_cnt = 0;
+        fast_vector<u32> scalar_ids(n), simd_ids(n);
+        for (u32 r=0; r<Runs_; ++r) {
+            BenchTimer t;
+            for (u32 k=0; k<SupportReps_; ++k) {
+                for (u32 i=0; i<n; ++i) {
+                    const Pgon& p = pgons[(i+k)%n];
+                    scalar_ids[i] = maths::calcSupportScalar(p.getPointsData(), pts_cnt, dirs[i]);
+                }
+            }
+            scalar_ms = std::min(scalar_ms, t.getElapsedMs());
+            benchKeep(scalar_ids[n/2]);
+
+            t.reset();
+            for (u32 k=0; k<SupportReps_; ++k) {
+                for (u32 i=0; i<n; ++i) {
+                    const Pgon& p = pgons[(i+k)%n];
+                    simd_ids[i] = maths::calcSupport(p.getPointsData(), pts_cnt, dirs[i]);
+                }
+            }
+            simd_ms = std::min(simd_ms, t.getElapsedMs());
+            benchKeep(simd_ids[n/2]);
+
+            GJK2D<Pgon, Pgon> gjk;
+            overlaps_cnt = 0;
+            t.reset();
+            for (u32 i=0; i+1<n; i+=2) {
+                gjk.setShapes(pgons[i], pgons[i+1]);
+                overlaps_cnt += gjk.isOverlapping();
+            }
+            gjk_ms = std::min(gjk_ms, t.getElapsedMs());
+        }
+        for (u32 i=0; i<n; ++i) {
+            const Pgon& p = pgons[(i+SupportReps_-1)%n];
+            u32 best, worst, best_s, worst_s;
+            maths::calcSupportBestWorst(p.getPointsData(), pts_cnt, dirs[i], best, worst);
+            maths::calcSupportBestWorstScalar(p.getPointsData(), pts_cnt, dirs[i], best_s, worst_s);
+            if (scalar_ids[i] != simd_ids[i] || best != best_s || worst != worst_s)
+                ++mismatches;
+        }
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << " Support " << pts_cnt << "-gons (" << (MATHS_SIMD_SSE?"simd":"scalar") << "): "
+                  << n*SupportReps_ << " queries scalar " << scalar_ms << " ms, calcSupport " << simd_ms << " ms"
+                  << ", GJK isOverlapping " << n/2 << " pairs " << gjk_ms << " ms (" << overlaps_cnt << " overlaps)" << std::endl;
+        if (mismatches) {
+            std::cout << "  ERROR: " << mismatches << " support ids differ from scalar search" << std::endl;
+        }
+    }
+
+    // throughput of current Pgon storage (compare builds with MATHS_PGON_INLINE_STORAGE 0/1)
+    void benchPgonLayout(u32 n) {
+        srand(3);
+        fast_vector<Pgon> pgons;
+        fast_vector<Transform> transforms(n);
+        pgons.reserve(n);
+        for (u32 i=0; i<n; ++i) {
+            pgons.push_back(genPgon_());
+            transforms[i] = Transform(Vec2(f32((i/2)*100) + randFloat(-20, 20), randFloat(-20, 20)), Angle(randFloat(0, 2*f32(M_PI))));
+        }
+
+        f64 copy_ms = 1e10, transform_ms = 1e10, overlap_ms = 1e10;
+        u32 overlaps_cnt = 0;
+        for (u32 r=0; r<Runs_; ++r) {
+            BenchTimer t;
+            fast_vector<Pgon> copies(pgons);
+            benchKeep(copies[n/2].getPoint(0));
+            copy_ms = std::min(copy_ms, t.getElapsedMs());
+
+            t.reset();
+            for (u32 i=0; i<n; ++i) {
+                copies[i].transform(transforms[i]);
+            }
+            transform_ms = std::min(transform_ms, t.getElapsedMs());
+            benchKeep(copies[n/2].getPoint(0));
+
+            OverlapTmp otmp;
+            overlaps_cnt = 0;
+            t.reset();
+            for (u32 i=0; i+1<n; i+=2) {
+                overlaps_cnt += copies[i].overlaps(copies[i+1], otmp);
+            }
+            overlap_ms = std::min(overlap_ms, t.getElapsedMs());
+        }
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << " Pgon layout " << (MATHS_PGON_INLINE_STORAGE?"inline":"fast_vector")
+                  << " (sizeof " << sizeof(Pgon) << ", trivially copyable " << std::is_trivially_copyable<Pgon>::value << ") n=" << n
+                  << ": copy " << copy_ms << " ms, transform " << transform_ms << " ms, overlap " << overlap_ms << " ms"
+                  << " (" << overlaps_cnt << " overlaps)" << std::endl;
+    }
+
+    // per-frame world pgons & bounds refresh: point by point (scalar transform, then bound),
+    // SIMD setTransformed() + calcARectBound(), fused setTransformed() with bound
+    void benchTransformBound(u32 n, u32 max_pts) {
+        srand(6);
+        fast_vector<Pgon> local, world;
+        fast_vector<Affine2> trs(n);
+        local.reserve(n);
+        world.reserve(n);
+        for (u32 i=0; i<n; ++i) {
+            local.push_back(genPgon_(max_pts/2 + rand()%(max_pts/2 + 1)));
+            trs[i] = Transform(Vec2(randFloat(-100, 100), randFloat(-100, 100)), Angle(randFloat(0, 2*f32(M_PI))),
+                               Vec2(randFloat(0.5f, 2.0f), randFloat(0.5f, 2.0f))).calcAffine();
+            world.push_back(local[i]);
+        }
+
+        fast_vector<ARect> scalar_bounds(n), bounds(n), fused_bounds(n);
+        f64 scalar_ms = 1e10, separate_ms = 1e10, fused_ms = 1e10;
+        for (u32 r=0; r<Runs_; ++r) {
+            BenchTimer t;
+            for (u32 i=0; i<n; ++i) {
+                Vec2* pts = world[i].accPointsData();
+                u32 cnt = local[i].getSize();
+                Vec2* b = scalar_bounds[i].accBounds();
+                b[0] = b[1] = pts[0] = trs[i]*local[i].getPoint(0);
+                for (u32 j=1; j<cnt; ++j) {
+                    pts[j] = trs[i]*local[i].getPoint(j);
+                    b[0].set(std::min(b[0].getX(), pts[j].getX()), std::min(b[0].getY(), pts[j].getY()));
+                    b[1].set(std::max(b[1].getX(), pts[j].getX()), std::max(b[1].getY(), pts[j].getY()));
+                }
+            }
+            scalar_ms = std::min(scalar_ms, t.getElapsedMs());
+            benchKeep(scalar_bounds[n/2]);
+
+            t.reset();
+            for (u32 i=0; i<n; ++i) {
+                world[i].setTransformed(local[i], trs[i]);
+                bounds[i] = world[i].calcARectBound();
+            }
+            separate_ms = std::min(separate_ms, t.getElapsedMs());
+            benchKeep(bounds[n/2]);
+
+            t.reset();
+            for (u32 i=0; i<n; ++i) {
+                world[i].setTransformed(local[i], trs[i], fused_bounds[i]);
+            }
+            fused_ms = std::min(fused_ms, t.getElapsedMs());
+            benchKeep(fused_bounds[n/2]);
+        }
+
+        u32 mismatches = 0;
+        for (u32 i=0; i<n; ++i) {
+            if (!(bounds[i] == fused_bounds[i]) || !(bounds[i] == scalar_bounds[i]))
+                ++mismatches;
+        }
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << " Transform+bound " << max_pts/2 << "-" << max_pts << " pts pgons (" << (MATHS_SIMD_AVX?"AVX":(MATHS_SIMD_SSE?"SSE":"scalar"))
+                  << ") n=" << n << ": point by point " << scalar_ms << " ms, separate " << separate_ms << " ms, fused " << fused_ms << " ms" << std::endl;
+        if (mismatches) {
+            std::cout << "  ERROR: " << mismatches << " bounds differ" << std::endl;
+        }
+    }
+
+    // per-pair OverlapHelper vs overlapsBatch() on mixed shape types
+    void benchBatch(u32 n) {
+        fast_vector<Shape> shapes;
+        fast_vector<Transform> transforms;
+        genScene_(n*2, shapes, transforms);
+
+        fast_vector<OverlapPair> pairs(n);
+        for (u32 i=0; i<n; ++i) {
+            pairs[i].shapes[0] = &shapes[i*2];
+            pairs[i].shapes[1] = &shapes[i*2+1];
+            pairs[i].transforms[0] = &transforms[i*2];
+            pairs[i].transforms[1] = &transforms[i*2+1];
+        }
+
+        OverlapHelper oh;
+        fast_vector<u8> single_overlaps(n);
+        fast_vector<ContactManifold> single_cms(n);
+        bool* batch_overlaps = new bool[n];
+        fast_vector<ContactManifold> batch_cms(n);
+        f64 single_ms = 1e10, batch_ms = 1e10;
+        // best of few runs
+        for (u32 r=0; r<Runs_; ++r) {
+            BenchTimer t;
+            for (u32 i=0; i<n; ++i) {
+                oh.set(shapes[i*2], shapes[i*2+1], transforms[i*2], transforms[i*2+1]);
+                single_overlaps[i] = oh.overlaps();
+                if (single_overlaps[i]) {
+                    oh.calcContactG();
+                    single_cms[i] = oh.getContactManifoldG();
+                }
+            }
+            single_ms = std::min(single_ms, t.getElapsedMs());
+
+            t.reset();
+            oh.overlapsBatch(pairs.begin(), n, batch_overlaps, batch_cms.begin());
+            batch_ms = std::min(batch_ms, t.getElapsedMs());
+        }
+
+        u32 overlaps_cnt = 0, mismatches = 0;
+        for (u32 i=0; i<n; ++i) {
+            overlaps_cnt += batch_overlaps[i];
+            if (bool(single_overlaps[i]) != batch_overlaps[i]) {
+                ++mismatches;
+            }
+            else if (batch_overlaps[i]) {
+                const ContactManifold& cm1 = single_cms[i];
+                const ContactManifold& cm2 = batch_cms[i];
+                if (cm1.size != cm2.size || (cm1.normal - cm2.normal).getSqrLen() > 1e-6f)
+                    ++mismatches;
+            }
+        }
+        delete [] batch_overlaps;
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << " Batch n=" << n << ": per pair " << single_ms << " ms, batched " << batch_ms << " ms"
+                  << " (" << overlaps_cnt << " overlaps)" << std::endl;
+        if (mismatches) {
+            std::cout << "  ERROR: " << mismatches << " results differ from per pair OverlapHelper" << std::endl;
+        }
+    }
+
+    // two pass narrowphase over pre-transformed shapes: overlaps() keeps OverlapTmp per pair,
+    // calcContact() for overlapping pairs in second pass
+    void benchPairScratch(u32 n) {
+        fast_vector<Shape> shapes;
+        fast_vector<Transform> transforms;
+        genScene_(n*2, shapes, transforms);
+        for (u32 i=0; i<n; ++i) {
+            // pair near origin (scene is spread along x)
+            Vec2 offset = transforms[i*2].getPosition();
+            for (u32 j=0; j<2; ++j) {
+                transforms[i*2+j].setPosition(transforms[i*2+j].getPosition() - offset);
+                shapes[i*2+j].transform(transforms[i*2+j]);
+            }
+        }
+
+        fast_vector<OverlapTmp> otmps(n);
+        fast_vector<u8> overlaps(n);
+        fast_vector<ContactManifold> cms(n);
+        f64 ms = 1e10;
+        u32 overlaps_cnt = 0;
+        for (u32 r=0; r<Runs_; ++r) {
+            BenchTimer t;
+            for (u32 i=0; i<n; ++i) {
+                overlaps[i] = shapes[i*2].overlaps(shapes[i*2+1], otmps[i]);
+            }
+            overlaps_cnt = 0;
+            for (u32 i=0; i<n; ++i) {
+                if (overlaps[i]) {
+                    shapes[i*2].calcContact(shapes[i*2+1], otmps[i], cms[i]);
+                    ++overlaps_cnt;
+                }
+            }
+            ms = std::min(ms, t.getElapsedMs());
+        }
+        benchKeep(cms[n/2].normal.getX());
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << " Pair scratch (sizeof OverlapTmp " << sizeof(OverlapTmp) << ") n=" << n << ": " << ms << " ms, "
+                  << (f64(n)/ms/1000.0) << "M pairs/s (" << overlaps_cnt << " overlaps)" << std::endl;
+    }
+
+    // cost of pair type dispatch: trivial circle/arect tests called directly vs through Shape and OverlapHelper
+    void benchDispatch(u32 n, u32 reps) {
+        srand(12);
+        fast_vector<Shape> shapes(n*2);
+        fast_vector<Circle> circles(n*2);
+        for (u32 i=0; i<n*2; ++i) {
+            circles[i] = Circle(Vec2(randFloat(-10, 10), randFloat(-10, 10)), randFloat(1, 5));
+        }
+
+        f64 direct_ms = 1e10, shape_ms = 1e10, oh_ms = 1e10, mixed_ms = 1e10;
+        u32 hits[4] = {};
+        Transform identity;
+        OverlapHelper oh;
+        for (u32 r=0; r<Runs_; ++r) {
+            for (u32 i=0; i<n*2; ++i) {
+                shapes[i].set(circles[i]);
+            }
+            BenchTimer t;
+            for (u32 k=0; k<reps; ++k) {
+                for (u32 i=0; i<n; ++i) {
+                    hits[0] += circles[i*2].overlaps(circles[i*2+1]);
+                }
+            }
+            direct_ms = std::min(direct_ms, t.getElapsedMs());
+
+            t.reset();
+            for (u32 k=0; k<reps; ++k) {
+                for (u32 i=0; i<n; ++i) {
+                    hits[1] += shapes[i*2].overlaps(shapes[i*2+1]);
+                }
+            }
+            shape_ms = std::min(shape_ms, t.getElapsedMs());
+
+            t.reset();
+            for (u32 k=0; k<reps; ++k) {
+                for (u32 i=0; i<n; ++i) {
+                    oh.set(shapes[i*2], shapes[i*2+1], identity, identity);
+                    hits[2] += oh.overlaps();
+                }
+            }
+            oh_ms = std::min(oh_ms, t.getElapsedMs());
+
+            // random mix of circles and arects (unpredictable type pairs)
+            for (u32 i=0; i<n*2; ++i) {
+                if (rand()%2)
+                    shapes[i].create<ARect>(circles[i].getCenter() - Vec2(circles[i].getRadius(), circles[i].getRadius()), Vec2(circles[i].getRadius()*2, circles[i].getRadius()*2));
+            }
+            t.reset();
+            for (u32 k=0; k<reps; ++k) {
+                for (u32 i=0; i<n; ++i) {
+                    hits[3] += shapes[i*2].overlaps(shapes[i*2+1]);
+                }
+            }
+            mixed_ms = std::min(mixed_ms, t.getElapsedMs());
+        }
+
+        f64 to_ns = 1e6/(f64(n)*reps);
+        std::cout << std::fixed << std::setprecision(2)
+                  << " Dispatch " << n*reps << " trivial pairs: direct Circle " << direct_ms*to_ns << " ns, Shape " << shape_ms*to_ns
+                  << " ns, OverlapHelper " << oh_ms*to_ns << " ns, Shape mixed types " << mixed_ms*to_ns << " ns per pair" << std::endl;
+        if (hits[0] != hits[1] || hits[0] != hits[2]) {
+            std::cout << "  ERROR: dispatched results differ from direct calls" << std::endl;
+        }
+    }
+
+    // ParallelNarrowphase with 1 to hardware threads, results must be identical to single threaded batch
+    void benchParallel(u32 n) {
+        fast_vector<Shape> shapes;
+        fast_vector<Transform> transforms;
+        genScene_(n*2, shapes, transforms);
+
+        fast_vector<OverlapPair> pairs(n);
+        for (u32 i=0; i<n; ++i) {
+            pairs[i].shapes[0] = &shapes[i*2];
+            pairs[i].shapes[1] = &shapes[i*2+1];
+            pairs[i].transforms[0] = &transforms[i*2];
+            pairs[i].transforms[1] = &transforms[i*2+1];
+        }
+
+        OverlapHelper oh;
+        bool* ref_overlaps = new bool[n];
+        fast_vector<ContactManifold> ref_cms(n);
+        oh.overlapsBatch(pairs.begin(), n, ref_overlaps, ref_cms.begin());
+
+        u32 max_threads = std::max(std::thread::hardware_concurrency(), 4u);
+        bool* overlaps = new bool[n];
+        fast_vector<ContactManifold> cms(n);
+        f64 single_ms = 0;
+        std::cout << " Parallel narrowphase n=" << n << ":";
+        // powers of 2 and max
+        for (u32 threads=1; threads<=max_threads; threads=(threads == max_threads)?threads+1:std::min(threads*2, max_threads)) {
+            ParallelNarrowphase pn(threads);
+            f64 ms = 1e10;
+            for (u32 r=0; r<Runs_; ++r) {
+                BenchTimer t;
+                pn.overlapsBatch(pairs.begin(), n, overlaps, cms.begin());
+                ms = std::min(ms, t.getElapsedMs());
+            }
+            if (threads == 1)
+                single_ms = ms;
+
+            u32 mismatches = 0;
+            for (u32 i=0; i<n; ++i) {
+                if (overlaps[i] != ref_overlaps[i]) {
+                    ++mismatches;
+                }
+                else if (overlaps[i] && !isSameManifold_(cms[i], ref_cms[i])) {
+                    ++mismatches;
+                }
+            }
+            std::cout << std::fixed << std::setprecision(2) << " " << threads << "t " << ms << " ms (x" << single_ms/ms << ")";
+            if (mismatches) {
+                std::cout << std::endl << "  ERROR: " << mismatches << " results differ from single threaded batch with " << threads << " threads" << std::endl;
+            }
+        }
+        std::cout << " (" << std::thread::hardware_concurrency() << " hw threads)" << std::endl;
+        delete [] ref_overlaps;
+        delete [] overlaps;
+    }
+
+private:
+    static constexpr u32 Runs_ = 5;
+    static constexpr u32 SupportReps_ = 20;
+
+    static bool isSameManifold_(const ContactManifold& cm1, const ContactManifold& cm2) {
+        if (cm1.size != cm2.size || cm1.normal.getX() != cm2.normal.getX() || cm1.normal.getY() != cm2.normal.getY())
+            return false;
+        for (u32 i=0; i<cm1.size; ++i) {
+            const ContactPoint& p1 = cm1.points[i];
+            const ContactPoint& p2 = cm2.points[i];
+            if (p1.position.getX() != p2.position.getX() || p1.position.getY() != p2.position.getY()
+                || p1.penetration != p2.penetration || p1.feature_id != p2.feature_id)
+                return false;
+        }
+        return true;
+    }
+
+    // all shape types, neighbouring shapes (2*i, 2*i+1) are placed close to each other
+    void genScene_(u32 n, fast_vector<Shape>& shapes_out, fast_vector<Transform>& transforms_out) {
+        srand(2);
+        shapes_out.resize(n);
+        transforms_out.resize(n);
+        for (u32 i=0; i<n; ++i) {
+            genShape_(shapes_out[i]);
+            Vec2 pos(f32((i/2)*100), 0);
+            if (i%2)
+                pos += Vec2(randFloat(-20, 20), randFloat(-20, 20));
+            transforms_out[i] = Transform(pos, Angle(randFloat(0, 2*f32(M_PI))));
+        }
+    }
+
+    void genShape_(Shape& s_out) {
+        switch (rand()%5) {
+            case 0: {
+                Vec2 size(randFloat(5, 20), randFloat(5, 20));
+                s_out.create<ARect>(-size/2, size);
+            }break;
+            case 1: {
+                Vec2 size(randFloat(5, 20), randFloat(5, 20));
+                s_out.create<Rect>(Vec2(0, 0), size, -size/2);
+            }break;
+            case 2:
+                s_out.create<Circle>(Vec2(0, 0), randFloat(3, 10));
+                break;
+            case 3:
+                s_out.create<Ray>(Vec2(0, 0), Angle(randFloat(0, 2*f32(M_PI))).getDir(), randFloat(5, 25), Ray::CalcDirInfo());
+                break;
+            case 4:
+                s_out.create<Pgon>(genPgon_());
+                break;
+        }
+    }
+
+    // convex, 3-8 points
+    Pgon genPgon_() {
+        return genPgon_(3 + rand()%6);
+    }
+
+    Pgon genPgon_(u32 pts_cnt) {
+        ASSERT(pts_cnt <= MATHS_MAX_PGON_SIZE);
+        f32 r = randFloat(3, 12);
+        Vec2 pts[MATHS_MAX_PGON_SIZE];
+        for (u32 j=0; j<pts_cnt; ++j) {
+            f32 a = (j + randFloat(0.0f, 0.5f))*2*f32(M_PI)/pts_cnt;
+            pts[j] = Vec2(cosf(a), sinf(a))*r;
+        }
+        return Pgon(pts, pts_cnt);
+    }
+};
+
+#endif //BENCH_NARROWPHASE_H
@@ -2,10 +2,30 @@
 using namespace grynca;
 #include "test_polygons.h"
 #include "test_overlaps.h"
+#include "bench_broadphase.h"
+#include "bench_narrowphase.h"
+#include "bench_math.h"
+#include "bench_dynamics.h"
+#include "test_allocations.h"
 
 int main(int argc, char* argv[]) {
     srand(time(NULL));
 
+    if (argc > 1 && std::string(argv[1]) == "bench") {
+        // headless benchmarks
+        BroadphaseBench().run();
+        NarrowphaseBench().run();
+        MathBench().run();
+        DynamicsBench().run();
+        return 0;
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "test") {
+        // headless tests
+        bool ok = TestAllocations().run();
+        return ok?0:1;
+    }
+
     SDLTestBenchSton::create(1024, 768, true);
     SDLTestBench& testbench = SDLTestBenchSton::get();
 
@@ -0,0 +1,138 @@
+#ifndef TEST_ALLOCATIONS_H
+#define TEST_ALLOCATIONS_H
+
+#include "maths.h"
+#include <new>
+#include <cstdlib>
+#include <atomic>
+
+// counting global allocator (this header must be included only once - from main.cpp)
+// (noinline: gcc reports mismatched new/delete when inlined malloc/free meet std allocators)
+static std::atomic<u64> g_allocs_count(0);     // (ParallelNarrowphase threads allocate too)
+
+#ifdef _MSC_VER
+#   define TEST_NOINLINE __declspec(noinline)
+#else
+#   define TEST_NOINLINE __attribute__((noinline))
+#endif
+
+TEST_NOINLINE void* operator new(size_t size) {
+    ++g_allocs_count;
+    void* p = malloc(size?size:1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+TEST_NOINLINE void operator delete(void* p) noexcept {
+    free(p);
+}
+
+// sized versions (C++14) would otherwise go to default deallocation
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete[](void* p) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+// headless checks, returns false on failure
+class TestAllocations {
+public:
+    bool run() {
+        std::cout << "== Allocations ==" << std::endl;
+        bool ok = true;
+        ok &= testPgonPgon();
+        ok &= testContactCache();
+        return ok;
+    }
+
+    // no heap allocations per Pgon-Pgon overlap (+contact) after warm-up
+    bool testPgonPgon() {
+        Vec2 pts1[] = {{-20, -10}, {20, -15}, {25, 10}, {-15, 20}};
+        Vec2 pts2[] = {{0, -12}, {12, 0}, {0, 12}, {-12, 0}, {-8, -8}};
+        Shape s1, s2, c;
+        s1.create<Pgon>(pts1, 4);
+        s2.create<Pgon>(pts2, 5);
+        c.create<Circle>(Vec2(0, 0), 10.0f);
+        Transform tr1(Vec2(100, 100), Angle(0.3f));
+
+        OverlapHelper oh;
+        u32 overlaps_cnt = 0;
+        auto test = [&](u32 i) {
+            Transform tr2(Vec2(100 + f32(i%120) - 60, 100 + f32(i%17)), Angle(i*0.1f));
+            // mixed with other target types so that scratch is not dropped
+            oh.set(s1, (i%3)?s2:c, tr1, tr2);
+            if (oh.overlaps()) {
+                oh.calcContactG();
+                ++overlaps_cnt;
+            }
+        };
+
+        // warm-up (scratch memory, normals of source pgons)
+        u32 tests = 1000;
+        for (u32 i=0; i<tests; ++i) {
+            test(i);
+        }
+        overlaps_cnt = 0;
+
+        u64 allocs_before = g_allocs_count;
+        for (u32 i=0; i<tests; ++i) {
+            test(i);
+        }
+        u64 allocs = g_allocs_count - allocs_before;
+
+        std::cout << " Pgon-Pgon overlaps: " << allocs << " allocations in " << tests << " tests (" << overlaps_cnt << " overlaps)" << std::endl;
+        if (allocs) {
+            std::cout << "  ERROR: expected no allocations after warm-up" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // no heap allocations per frame of contact cache with steady number of pairs (pairs are replaced)
+    bool testContactCache() {
+        ContactCache cache;
+        ContactManifold cm;
+        cm.size = 2;
+        cm.points[0].feature_id = 1;
+        cm.points[1].feature_id = 2;
+        u32 pairs_cnt = 5000;
+        auto frame = [&](u32 f) {
+            for (u32 i=0; i<pairs_cnt; ++i) {
+                // every 10th pair is new each frame
+                u32 id_a = (i%10)?i:(f*pairs_cnt + i);
+                cache.update(id_a, id_a+1, cm);
+            }
+            cache.endFrame();
+        };
+
+        u32 frames = 10;
+        for (u32 f=0; f<frames; ++f) {
+            frame(f);
+        }
+        u64 allocs_before = g_allocs_count;
+        for (u32 f=frames; f<2*frames; ++f) {
+            frame(f);
+        }
+        u64 allocs = g_allocs_count - allocs_before;
+
+        std::cout << " Contact cache: " << allocs << " allocations in " << frames << " frames (" << cache.getSize() << " pairs)" << std::endl;
+        if (allocs || cache.getSize() != pairs_cnt) {
+            std::cout << "  ERROR: expected no allocations after warm-up and " << pairs_cnt << " pairs" << std::endl;
+            return false;
+        }
+        return true;
+    }
+};
+
+#endif //TEST_ALLOCATIONS_H
@@ -176,7 +176,7 @@ public:
                     // dont rotate ARect
                     break;
                 default:
-                    shapes[selected_shape_id].tr.setRotation(shapes[selected_shape_id].tr.getRotation() + d_rot);
+                    shapes[selected_shape_id].tr.rotate(d_rot);
                     break;
             }
         }